@@ -49,6 +49,7 @@ public class PakMgr : ModuleRules
                 "Slate",
 				"SlateCore",
                 "Json", "JsonUtilities",
+                "PakFile",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
@@ -7,7 +7,7 @@
 #include "EditorStyleSet.h"
 #include "Templates/SharedPointer.h"
 #include "Models/FContentItem.h"
-#include "Browser/SContentItemRow.h"
+#include "FileTree/SFileTreeItemTableRow.h"
 
 
 #define LOCTEXT_NAMESPACE "SContentBrowser"
@@ -17,9 +17,14 @@
  *****************************************************************************/
 TSharedPtr< SContentBrowser > SContentBrowser::ContentInstance = NULL;
 
-TArray<TSharedPtr<FContentItemInfo>> SContentBrowser::GetItems()
+void SContentBrowser::GetItemFilenames(TArray<FString>& OutFilenames) const
 {
-	return ContentItems;
+	OutFilenames.Reset(ContentItems.Num());
+
+	for (const FPakMgrLogHandle& Item : ContentItems)
+	{
+		OutFilenames.Add(ItemStore->GetText(Item));
+	}
 }
 
 void SContentBrowser::SetInstance(TSharedPtr< class SContentBrowser > inst)
@@ -48,6 +53,10 @@ void SContentBrowser::Construct( const FArguments& InArgs, TSharedRef<IPFileMana
 	updatingTreeExpansion = false;
 	bCanSetDefaultSelection = true;
 
+	// content items are few and must not be dropped like old log messages
+	ItemStore = MakeShareable(new FPakMgrLogStore(MAX_int64));
+	ContentTableModel = MakeShareable(new FPakMgrLogTableModel(ItemStore.ToSharedRef()));
+
 	ChildSlot
 	[
 		SNew(SVerticalBox)
@@ -60,11 +69,12 @@ void SContentBrowser::Construct( const FArguments& InArgs, TSharedRef<IPFileMana
 			.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
 			.Padding(0.0f)
 			[
-				SAssignNew(ContentListView, SListView<TSharedPtr<FContentItemInfo>>)
+				SAssignNew(ContentListView, SListView<FPakMgrLogHandle>)
 				.ItemHeight(24.0f)
 				.ListItemsSource(&ContentItems)
 				.SelectionMode(ESelectionMode::Multi)
 				.OnGenerateRow(this, &SContentBrowser::HandleContentListGenerateRow)
+				.OnRowReleased(this, &SContentBrowser::HandleContentListRowReleased)
 				.OnItemScrolledIntoView(this, &SContentBrowser::HandleLogListItemScrolledIntoView)
 				.HeaderRow
 				(
@@ -126,11 +136,11 @@ void SContentBrowser::ReloadLog(bool FullyReload)
 	// filter log list
 	FilterBar->ResetFilter();
 
-	for (const auto& contentItemInfo : AvailableItems)
+	for (const FPakMgrLogHandle& Item : AvailableItems)
 	{
-		if (FilterBar->FilterLogMessage(contentItemInfo.ToSharedRef()))
+		if (FilterBar->FilterLogMessage(*ItemStore, Item))
 		{
-			ContentItems.Add(contentItemInfo);
+			ContentItems.Add(Item);
 		}
 	}
 
@@ -191,15 +201,17 @@ void SContentBrowser::HandleSessionTreeViewExpansionChanged(TSharedPtr<FContentI
 }
 
 
-TSharedRef<ITableRow> SContentBrowser::HandleContentListGenerateRow(TSharedPtr<FContentItemInfo> contentItem, const TSharedRef<STableViewBase>& OwnerTable)
+TSharedRef<ITableRow> SContentBrowser::HandleContentListGenerateRow(FPakMgrLogHandle Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return ContentTableModel->GenerateRow(Item, OwnerTable, TAttribute<FText>::Create(TAttribute<FText>::FGetter::CreateSP(this, &SContentBrowser::HandleContentListGetHighlightText)));
+}
+
+void SContentBrowser::HandleContentListRowReleased(const TSharedRef<ITableRow>& TableRow)
 {
-	return SNew(SContentItemRow, OwnerTable)
-		.HighlightText(this, &SContentBrowser::HandleContentListGetHighlightText)
-		.ContentItem(contentItem)
-		.ToolTipText(FText::FromString(contentItem->Text));
+	ContentTableModel->ReleaseRow(TableRow);
 }
 
-void SContentBrowser::HandleLogListItemScrolledIntoView(TSharedPtr<FContentItemInfo> Item, const TSharedPtr<ITableRow>& TableRow)
+void SContentBrowser::HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow)
 {
 	if (ContentItems.Num() > 0)
 	{
@@ -272,7 +284,7 @@ bool SContentBrowser::HandleTerminateSessionButtonIsEnabled() const
 
 void SContentBrowser::HandlAddModule(const FString& moduleName)
 {
-	ContentItems.Add(MakeShareable(new FContentItemInfo(moduleName)));
+	ContentItems.Add(ItemStore->Add(TEXT("Content"), moduleName, ELogVerbosity::Log, NAME_None, 0.0, FDateTime::Now()));
 
 	//ReloadLog(true);
 	ContentListView->RequestListRefresh();
@@ -10,7 +10,8 @@
 #include "Widgets/Views/STableViewBase.h"
 #include "Widgets/Views/STableRow.h"
 #include "Widgets/Views/STreeView.h"
-#include "Models/ContentItemInfo.h"
+#include "Models/LogStore.h"
+#include "Models/LogTableModel.h"
 #include "Browser/SContentBrowserFilterBar.h"
 
 class FFileGroupTreeItem;
@@ -41,7 +42,14 @@ public:
 	 * @param InArgs The declaration data for this widget.
 	 */
 	void Construct( const FArguments& InArgs, TSharedRef<IPFileManager> InSessionManager);
-	TArray<TSharedPtr<FContentItemInfo>> GetItems();
+
+	/**
+	 * Gets the file names of the listed content items.
+	 *
+	 * @param OutFilenames Will hold the file names.
+	 */
+	void GetItemFilenames(TArray<FString>& OutFilenames) const;
+
 	static TSharedPtr< class SContentBrowser > Get() { return ContentInstance; }
 	static void SetInstance(TSharedPtr< class SContentBrowser > inst);
 
@@ -71,9 +79,12 @@ private:
 	void HandleSessionTreeViewExpansionChanged(TSharedPtr<FContentItem> TreeItem, bool bIsExpanded);
 
 	/** Callback for generating a row widget in the session tree view. */
-	TSharedRef<ITableRow> HandleContentListGenerateRow(TSharedPtr<FContentItemInfo> Message, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> HandleContentListGenerateRow(FPakMgrLogHandle Item, const TSharedRef<STableViewBase>& OwnerTable);
 
-	void HandleLogListItemScrolledIntoView(TSharedPtr<FContentItemInfo> Item, const TSharedPtr<ITableRow>& TableRow);
+	/** Callback for a row widget scrolling out of the content list view. */
+	void HandleContentListRowReleased(const TSharedRef<ITableRow>& TableRow);
+
+	void HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow);
 
 	FText HandleContentListGetHighlightText() const;
 	/** Callback for getting the children of a node in the session tree view. */
@@ -95,8 +106,11 @@ private:
 private:
 	static TSharedPtr< class SContentBrowser > ContentInstance;
 
-	/** Holds an unfiltered list of available log messages. */
-	TArray<TSharedPtr<FContentItemInfo>> AvailableItems;
+	/** Holds the content items, listed or not. */
+	TSharedPtr<FPakMgrLogStore> ItemStore;
+
+	/** Holds an unfiltered list of available content items. */
+	TArray<FPakMgrLogHandle> AvailableItems;
 
 	/** Holds the session manager. */
 	TSharedPtr<IPFileManager> SessionManager;
@@ -113,9 +127,13 @@ private:
 	/** Whether to ignore events from the session tree view. */
 	bool updatingTreeExpansion;
 
-	TSharedPtr<SListView<TSharedPtr<FContentItemInfo>>> ContentListView;
+	TSharedPtr<SListView<FPakMgrLogHandle>> ContentListView;
+
+	/** Holds the table model of the content list view. */
+	TSharedPtr<FPakMgrLogTableModel> ContentTableModel;
+
 	/** Holds the filtered list of content item. */
-	TArray<TSharedPtr<FContentItemInfo>> ContentItems;
+	TArray<FPakMgrLogHandle> ContentItems;
 
 	/** Holds a flag indicating whether the log list should auto-scroll to the last item. */
 	bool ShouldScrollToLast;
@@ -107,24 +107,27 @@ void SContentBrowserFilterBar::Construct(const FArguments& InArgs)
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 
-bool SContentBrowserFilterBar::FilterLogMessage(const TSharedRef<FContentItemInfo>& LogMessage)
+bool SContentBrowserFilterBar::FilterLogMessage(const FPakMgrLogStore& Store, FPakMgrLogHandle Handle)
 {
+	const FName Category = Store.GetCategory(Handle);
+	const ELogVerbosity::Type Verbosity = Store.GetVerbosity(Handle);
+
 	// create or update category counter
-	int32& CategoryCounter = CategoryCounters.FindOrAdd(LogMessage->Category);
+	int32& CategoryCounter = CategoryCounters.FindOrAdd(Category);
 
 	if (CategoryCounter == 0)
 	{
-		AddCategoryFilter(LogMessage->Category);
+		AddCategoryFilter(Category);
 	}
 
 	++CategoryCounter;
 
 	// update the verbosity counter
-	++VerbosityCounters.FindOrAdd(LogMessage->Verbosity);
+	++VerbosityCounters.FindOrAdd(Verbosity);
 
 	// filter the log message
-	if (DisabledCategories.Contains(LogMessage->Category) ||
-		DisabledVerbosities.Contains(LogMessage->Verbosity))
+	if (DisabledCategories.Contains(Category) ||
+		DisabledVerbosities.Contains(Verbosity))
 	{
 		return false;
 	}
@@ -134,7 +137,7 @@ bool SContentBrowserFilterBar::FilterLogMessage(const TSharedRef<FContentItemInf
 		return true;
 	}
 
-	return (LogMessage->Text.Contains(FilterStringTextBox->GetText().ToString()));
+	return (FCString::Stristr(Store.GetText(Handle), *FilterStringTextBox->GetText().ToString()) != nullptr);
 }
 
 
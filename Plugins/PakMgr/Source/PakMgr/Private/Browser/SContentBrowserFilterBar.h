@@ -7,7 +7,7 @@
 #include "Widgets/SCompoundWidget.h"
 #include "Widgets/Views/STableViewBase.h"
 #include "Widgets/Views/STableRow.h"
-#include "Models/ContentItemInfo.h"
+#include "Models/LogStore.h"
 #include "Models/ContentConsoleCategoryFilter.h"
 #include "Models/ContentConsoleVerbosityFilter.h"
 
@@ -38,12 +38,13 @@ public:
 	void Construct(const FArguments& InArgs);
 
 	/**
-	 * Filters the specified log message based on the current filter settings.
+	 * Filters the specified content item based on the current filter settings.
 	 *
-	 * @param LogMessage The log message to filter.
-	 * @return true if the log message passed the filter, false otherwise.
+	 * @param Store The store holding the item.
+	 * @param Handle The item to filter.
+	 * @return true if the item passed the filter, false otherwise.
 	 */
-	bool FilterLogMessage(const TSharedRef<FContentItemInfo>& LogMessage);
+	bool FilterLogMessage(const FPakMgrLogStore& Store, FPakMgrLogHandle Handle);
 
 	/**
 	 * Gets the current filter string.
@@ -0,0 +1,636 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Commandlets/PakMgrBenchmarkCommandlet.h"
+#include "AssetRegistryState.h"
+#include "DependsNode.h"
+#include "HAL/PlatformMemory.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Models/DependencyClosure.h"
+#include "Models/PakModuleInfo.h"
+#include "Models/RefGraph.h"
+#include "Models/RefGraphLayout.h"
+#include "PakManager/PakPartitioner.h"
+#include "PakManager/PakSharedAnalysis.h"
+#include "UObject/ObjectRedirector.h"
+#include "UObject/Package.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+namespace PakMgrBenchmark
+{
+	/** Settings of the synthetic registries and the timed stages. */
+	struct FSettings
+	{
+		TArray<int32> Scales;
+		int32 Seed;
+		float MeanFanOut;
+		float Exponent;
+		float RedirectorRatio;
+		float CycleRatio;
+		float SoftRatio;
+		int32 NumModules;
+		int32 SharingThreshold;
+		int64 MaxPakSize;
+		int32 NumFilterSamples;
+		int32 NumGraphRoots;
+		int32 LayoutDepth;
+		int32 LayoutBreadth;
+
+		FSettings()
+			: Seed(0)
+			, MeanFanOut(6.0f)
+			, Exponent(2.5f)
+			, RedirectorRatio(0.02f)
+			, CycleRatio(0.01f)
+			, SoftRatio(0.2f)
+			, NumModules(32)
+			, SharingThreshold(2)
+			, MaxPakSize(256ll << 20)
+			, NumFilterSamples(100000)
+			, NumGraphRoots(100)
+			, LayoutDepth(3)
+			, LayoutBreadth(15)
+		{ }
+	};
+
+	/** The result of one stage at one scale. */
+	struct FStageResult
+	{
+		int32 NumPackages;
+		FString Stage;
+		double Seconds;
+		int64 NumItems;
+		FString ItemName;
+		double UsedMegabytes;
+		double PeakMegabytes;
+	};
+
+	/** Number of packages per generated content folder. */
+	const int32 PackagesPerFolder = 1000;
+
+	/** Highest number of dependencies of a generated package. */
+	const int32 MaxFanOut = 4096;
+
+	/** Bias of dependencies towards nearby and towards widely shared packages, above 1. */
+	const float TargetSkew = 3.0f;
+
+	/** Baseline times below this many seconds are too noisy to compare against. */
+	const double MinBaselineSeconds = 0.05;
+
+	/** Parses the command line, returns false if it is invalid. */
+	bool ParseSettings(const FString& Params, FSettings& OutSettings)
+	{
+		FString ScalesString = TEXT("10000+100000");
+		FParse::Value(*Params, TEXT("Packages="), ScalesString);
+
+		TArray<FString> Scales;
+		ScalesString.ParseIntoArray(Scales, TEXT("+"));
+
+		for (const FString& Scale : Scales)
+		{
+			const int32 NumPackages = FCString::Atoi(*Scale);
+
+			if (NumPackages < 1)
+			{
+				UE_LOG(LogPakMgr, Error, TEXT("Invalid number of packages '%s'"), *Scale);
+
+				return false;
+			}
+
+			OutSettings.Scales.Add(NumPackages);
+		}
+
+		// the peak memory of a scale is only meaningful if no larger scale ran before
+		OutSettings.Scales.Sort();
+
+		int32 MaxSizeMegabytes = 0;
+
+		FParse::Value(*Params, TEXT("Seed="), OutSettings.Seed);
+		FParse::Value(*Params, TEXT("FanOut="), OutSettings.MeanFanOut);
+		FParse::Value(*Params, TEXT("Exponent="), OutSettings.Exponent);
+		FParse::Value(*Params, TEXT("Redirectors="), OutSettings.RedirectorRatio);
+		FParse::Value(*Params, TEXT("Cycles="), OutSettings.CycleRatio);
+		FParse::Value(*Params, TEXT("Soft="), OutSettings.SoftRatio);
+		FParse::Value(*Params, TEXT("Modules="), OutSettings.NumModules);
+		FParse::Value(*Params, TEXT("SharingThreshold="), OutSettings.SharingThreshold);
+		FParse::Value(*Params, TEXT("FilterSamples="), OutSettings.NumFilterSamples);
+		FParse::Value(*Params, TEXT("GraphRoots="), OutSettings.NumGraphRoots);
+		FParse::Value(*Params, TEXT("LayoutDepth="), OutSettings.LayoutDepth);
+		FParse::Value(*Params, TEXT("LayoutBreadth="), OutSettings.LayoutBreadth);
+
+		if (FParse::Value(*Params, TEXT("MaxSize="), MaxSizeMegabytes))
+		{
+			OutSettings.MaxPakSize = (int64)FMath::Max(MaxSizeMegabytes, 1) << 20;
+		}
+
+		// the mean of the dependency count distribution is only finite above 2
+		if (OutSettings.Exponent <= 2.0f)
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("The exponent must be above 2, got %.2f"), OutSettings.Exponent);
+
+			return false;
+		}
+
+		OutSettings.MeanFanOut = FMath::Max(OutSettings.MeanFanOut, 0.0f);
+		OutSettings.RedirectorRatio = FMath::Clamp(OutSettings.RedirectorRatio, 0.0f, 1.0f);
+		OutSettings.CycleRatio = FMath::Clamp(OutSettings.CycleRatio, 0.0f, 1.0f);
+		OutSettings.SoftRatio = FMath::Clamp(OutSettings.SoftRatio, 0.0f, 1.0f);
+		OutSettings.NumModules = FMath::Max(OutSettings.NumModules, 1);
+		OutSettings.SharingThreshold = FMath::Max(OutSettings.SharingThreshold, 2);
+		OutSettings.NumFilterSamples = FMath::Max(OutSettings.NumFilterSamples, 0);
+		OutSettings.NumGraphRoots = FMath::Max(OutSettings.NumGraphRoots, 0);
+
+		return true;
+	}
+
+	/** Adds a dependency in both directions. */
+	void AddDependency(FDependsNode* Referencer, FDependsNode* Dependency, EAssetRegistryDependencyType::Type DependencyType)
+	{
+		Referencer->AddDependency(Dependency, DependencyType);
+		Dependency->AddReferencer(Referencer);
+	}
+
+	/**
+	 * Generates a synthetic registry state.
+	 *
+	 * Dependencies mostly point to later packages: half of them to nearby ones, like the assets of a
+	 * level, and half of them to the last ones, which end up shared by many packages, like common
+	 * materials. The rest points back and closes cycles. The first packages are the module maps.
+	 *
+	 * @param Settings The generator settings.
+	 * @param NumPackages The number of packages to generate.
+	 * @param OutPackageNames Will hold the package names, the module maps first.
+	 * @return The new state.
+	 */
+	FAssetRegistryState* GenerateRegistryState(const FSettings& Settings, int32 NumPackages, TArray<FName>& OutPackageNames)
+	{
+		PAKMGR_TRACE_SCOPE(GenerateBenchmarkRegistry);
+
+		// every scale has its own stream, so a scale does not depend on the scales run before
+		FRandomStream Random((int32)HashCombine(GetTypeHash(Settings.Seed), GetTypeHash(NumPackages)));
+
+		const FName RedirectorClassName = UObjectRedirector::StaticClass()->GetFName();
+		const FName MapClassName(TEXT("World"));
+		const FName AssetClassName(TEXT("StaticMesh"));
+
+		TMap<FName, FAssetData*> AssetDataMap;
+		TMap<FAssetIdentifier, FDependsNode*> DependsNodeMap;
+		TMap<FName, FAssetPackageData*> PackageDataMap;
+		TArray<FDependsNode*> DependsNodes;
+		TBitArray<> Redirectors;
+
+		AssetDataMap.Reserve(NumPackages);
+		DependsNodeMap.Reserve(NumPackages);
+		PackageDataMap.Reserve(NumPackages);
+		DependsNodes.Reserve(NumPackages);
+		OutPackageNames.Reset(NumPackages);
+
+		for (int32 Index = 0; Index < NumPackages; ++Index)
+		{
+			const FString PackagePath = FString::Printf(TEXT("/Game/Benchmark/Folder%04d"), Index / PackagesPerFolder);
+			const FString AssetName = FString::Printf(TEXT("Package%07d"), Index);
+			const FName PackageName(*(PackagePath / AssetName));
+			const bool bIsMap = (Index < Settings.NumModules);
+			const bool bIsRedirector = !bIsMap && (Random.GetFraction() < Settings.RedirectorRatio);
+
+			FAssetData* AssetData = new FAssetData(PackageName, FName(*PackagePath), FName(*AssetName), bIsRedirector ? RedirectorClassName : (bIsMap ? MapClassName : AssetClassName));
+			AssetDataMap.Add(AssetData->ObjectPath, AssetData);
+
+			// redirectors are not cooked, so they are missing from the registry source, package sizes follow a power law as well
+			FAssetPackageData* PackageData = new FAssetPackageData();
+			PackageData->DiskSize = bIsRedirector ? -1 : FMath::Min<int64>((int64)(16384.0f * FMath::Pow(1.0f - Random.GetFraction(), -1.0f / 1.5f)), 512ll << 20);
+			PackageData->PackageGuid = FGuid((uint32)Settings.Seed, (uint32)NumPackages, (uint32)Index, 1);
+			PackageDataMap.Add(PackageName, PackageData);
+
+			FDependsNode* DependsNode = new FDependsNode(FAssetIdentifier(PackageName));
+			DependsNodeMap.Add(DependsNode->GetIdentifier(), DependsNode);
+			DependsNodes.Add(DependsNode);
+
+			Redirectors.Add(bIsRedirector);
+			OutPackageNames.Add(PackageName);
+		}
+
+		// Pareto distributed dependency counts, the minimum is chosen to give the requested mean
+		const float MinFanOut = Settings.MeanFanOut * (Settings.Exponent - 2.0f) / (Settings.Exponent - 1.0f);
+		int64 NumDependencies = 0;
+
+		auto PickLaterPackage = [&Random, NumPackages](int32 Index, bool bNearby)
+		{
+			const int32 NumLater = NumPackages - 1 - Index;
+			const int32 Offset = FMath::Min(FMath::FloorToInt(NumLater * FMath::Pow(Random.GetFraction(), TargetSkew)), NumLater - 1);
+
+			return bNearby ? Index + 1 + Offset : NumPackages - 1 - Offset;
+		};
+
+		for (int32 Index = 0; Index < NumPackages; ++Index)
+		{
+			const bool bIsLastPackage = (Index == NumPackages - 1);
+
+			if (Redirectors[Index])
+			{
+				// a redirector only references what it was renamed to
+				if (!bIsLastPackage)
+				{
+					AddDependency(DependsNodes[Index], DependsNodes[PickLaterPackage(Index, true)], EAssetRegistryDependencyType::Hard);
+					++NumDependencies;
+				}
+
+				continue;
+			}
+
+			const int32 FanOut = FMath::Min(FMath::FloorToInt(MinFanOut * FMath::Pow(1.0f - Random.GetFraction(), -1.0f / (Settings.Exponent - 1.0f))), MaxFanOut);
+
+			for (int32 DependencyIndex = 0; DependencyIndex < FanOut; ++DependencyIndex)
+			{
+				const bool bPointsBack = (Random.GetFraction() < Settings.CycleRatio);
+
+				if (bPointsBack ? (Index == 0) : bIsLastPackage)
+				{
+					continue;
+				}
+
+				const int32 Target = bPointsBack ? Random.RandHelper(Index) : PickLaterPackage(Index, Random.GetFraction() < 0.5f);
+				const EAssetRegistryDependencyType::Type DependencyType = (Random.GetFraction() < Settings.SoftRatio) ? EAssetRegistryDependencyType::Soft : EAssetRegistryDependencyType::Hard;
+
+				AddDependency(DependsNodes[Index], DependsNodes[Target], DependencyType);
+				++NumDependencies;
+			}
+		}
+
+		FAssetRegistrySerializationOptions Options;
+		Options.bSerializeAssetRegistry = true;
+		Options.bSerializeDependencies = true;
+		Options.bSerializePackageData = true;
+
+		FAssetRegistryState* State = new FAssetRegistryState();
+		State->InitializeFromExisting(AssetDataMap, DependsNodeMap, PackageDataMap, Options);
+
+		// the state holds copies
+		for (const TPair<FName, FAssetData*>& Pair : AssetDataMap)
+		{
+			delete Pair.Value;
+		}
+
+		for (const TPair<FName, FAssetPackageData*>& Pair : PackageDataMap)
+		{
+			delete Pair.Value;
+		}
+
+		for (FDependsNode* DependsNode : DependsNodes)
+		{
+			delete DependsNode;
+		}
+
+		UE_LOG(LogPakMgr, Display, TEXT("Generated %d packages with %lld dependencies and %d redirectors, registry state %.1f MB"),
+			NumPackages, NumDependencies, Redirectors.CountSetBits(), State->GetAllocatedSize() / 1048576.0);
+
+		return State;
+	}
+
+	/** Times a stage, which returns the number of items it processed, and adds its result. */
+	void RunStage(int32 NumPackages, const TCHAR* Stage, const TCHAR* ItemName, TArray<FStageResult>& Results, TFunctionRef<int64()> StageFunction)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		const int64 NumItems = StageFunction();
+
+		const FPlatformMemoryStats MemoryStats = FPlatformMemory::GetStats();
+
+		FStageResult Result;
+		Result.NumPackages = NumPackages;
+		Result.Stage = Stage;
+		Result.Seconds = FPlatformTime::Seconds() - StartTime;
+		Result.NumItems = NumItems;
+		Result.ItemName = ItemName;
+		Result.UsedMegabytes = MemoryStats.UsedPhysical / 1048576.0;
+		Result.PeakMegabytes = MemoryStats.PeakUsedPhysical / 1048576.0;
+
+		UE_LOG(LogPakMgr, Display, TEXT("%9d packages  %-17s %9.3f s  %11lld %-11s %13.0f /s  used %8.1f MB  peak %8.1f MB"),
+			NumPackages, Stage, Result.Seconds, NumItems, ItemName, NumItems / FMath::Max(Result.Seconds, 1e-6), Result.UsedMegabytes, Result.PeakMegabytes);
+
+		Results.Add(Result);
+	}
+
+	/** Runs all stages at one scale. */
+	void RunScale(const FSettings& Settings, int32 NumPackages, TArray<FStageResult>& Results)
+	{
+		IPakMgrModule& PakMgrModule = IPakMgrModule::Get();
+		TArray<FName> PackageNames;
+		FAssetRegistryState* State = nullptr;
+
+		RunStage(NumPackages, TEXT("GenerateRegistry"), TEXT("packages"), Results, [&]() -> int64
+		{
+			State = GenerateRegistryState(Settings, NumPackages, PackageNames);
+
+			return NumPackages;
+		});
+
+		// the module owns the state from here on and filters for it like for any other custom source
+		PakMgrModule.SetCustomRegistrySource(State, FString::Printf(TEXT("Benchmark%d"), NumPackages));
+
+		FPakMgrDependencyGraphPtr Graph;
+
+		RunStage(NumPackages, TEXT("DependencyGraph"), TEXT("edges"), Results, [&]() -> int64
+		{
+			Graph = PakMgrModule.GetDependencyGraph();
+
+			return Graph->NumEdges();
+		});
+
+		TArray<int32> Roots;
+
+		for (int32 Index = 0; Index < FMath::Min(Settings.NumModules, NumPackages); ++Index)
+		{
+			Roots.Add(Graph->FindNode(PackageNames[Index]));
+		}
+
+		TArray<FPakMgrDependencyClosure> Closures;
+		int64 NumClosureNodes = 0;
+
+		RunStage(NumPackages, TEXT("Closures"), TEXT("packages"), Results, [&]() -> int64
+		{
+			FPakMgrDependencyClosure::ComputeParallel(*Graph, Roots, true, Closures);
+
+			for (const FPakMgrDependencyClosure& Closure : Closures)
+			{
+				NumClosureNodes += Closure.Nodes.Num();
+			}
+
+			return NumClosureNodes;
+		});
+
+		TArray<FPakModuleInfo> Modules;
+		Modules.SetNum(Closures.Num());
+
+		for (int32 ModuleIndex = 0; ModuleIndex < Modules.Num(); ++ModuleIndex)
+		{
+			FPakModuleInfo& Module = Modules[ModuleIndex];
+			Module.Name = FPackageName::GetLongPackageAssetName(PackageNames[ModuleIndex].ToString());
+			Module.RootPackage = PackageNames[ModuleIndex];
+			Module.Graph = Graph;
+			Module.Closure = MoveTemp(Closures[ModuleIndex]);
+		}
+
+		FPakSharedAnalysis Analysis;
+
+		RunStage(NumPackages, TEXT("SharedAnalysis"), TEXT("packages"), Results, [&]() -> int64
+		{
+			FPakSharedAnalysis::Analyze(Modules, Settings.SharingThreshold, Analysis);
+
+			return NumClosureNodes;
+		});
+
+		RunStage(NumPackages, TEXT("Partition"), TEXT("packages"), Results, [&]() -> int64
+		{
+			TArray<TArray<int32>> Parts;
+			int64 NumPartitionedNodes = Analysis.SharedNodes.Num();
+
+			FPakPartitioner::Partition(*Graph, Analysis.SharedNodes, Settings.MaxPakSize, Parts);
+
+			for (const TArray<int32>& ModuleNodes : Analysis.ModuleNodes)
+			{
+				FPakPartitioner::Partition(*Graph, ModuleNodes, Settings.MaxPakSize, Parts);
+				NumPartitionedNodes += ModuleNodes.Num();
+			}
+
+			return NumPartitionedNodes;
+		});
+
+		// unfiltered dependencies, as the reference viewer gets them, spread over all packages
+		const EAssetRegistryDependencyType::Type SearchFlags = (EAssetRegistryDependencyType::Type)(EAssetRegistryDependencyType::Hard | EAssetRegistryDependencyType::Soft);
+		const int32 NumFilterSamples = FMath::Min(Settings.NumFilterSamples, NumPackages);
+		TArray<TArray<FAssetIdentifier>> FilterBatches;
+		FilterBatches.SetNum(NumFilterSamples);
+
+		for (int32 SampleIndex = 0; SampleIndex < NumFilterSamples; ++SampleIndex)
+		{
+			Graph->AppendNeighbours(PackageNames[(int32)((int64)SampleIndex * NumPackages / NumFilterSamples)], SearchFlags, false, FilterBatches[SampleIndex]);
+		}
+
+		RunStage(NumPackages, TEXT("FilterIdentifiers"), TEXT("identifiers"), Results, [&]() -> int64
+		{
+			int64 NumIdentifiers = 0;
+
+			for (TArray<FAssetIdentifier>& FilterBatch : FilterBatches)
+			{
+				NumIdentifiers += FilterBatch.Num();
+				PakMgrModule.FilterAssetIdentifiersForCurrentRegistrySource(FilterBatch, SearchFlags, true);
+			}
+
+			return NumIdentifiers;
+		});
+
+		FilterBatches.Empty();
+
+		const int32 NumGraphRoots = FMath::Min(Settings.NumGraphRoots, NumPackages);
+		TArray<TArray<FAssetIdentifier>> GraphRoots;
+
+		for (int32 RootIndex = 0; RootIndex < NumGraphRoots; ++RootIndex)
+		{
+			GraphRoots.AddDefaulted();
+			GraphRoots.Last().Add(FAssetIdentifier(PackageNames[(int32)((int64)RootIndex * NumPackages / NumGraphRoots)]));
+		}
+
+		RunStage(NumPackages, TEXT("RefGraphLayout"), TEXT("nodes"), Results, [&]() -> int64
+		{
+			FRefGraphLayoutSettings LayoutSettings;
+			LayoutSettings.SearchFlags = SearchFlags;
+			LayoutSettings.HardSearchFlags = EAssetRegistryDependencyType::Hard;
+			LayoutSettings.MaxSearchDepth = Settings.LayoutDepth;
+			LayoutSettings.MaxSearchBreadth = Settings.LayoutBreadth;
+			LayoutSettings.bLimitSearchDepth = (Settings.LayoutDepth > 0);
+			LayoutSettings.bLimitSearchBreadth = (Settings.LayoutBreadth > 0);
+			LayoutSettings.bFilterByCollection = false;
+			LayoutSettings.bShowNativePackages = false;
+			LayoutSettings.SnapshotGraph = Graph;
+
+			// like background builds, which keep the references gathered by earlier builds
+			FRefClosureCache Cache;
+
+			FRefGraphLayoutBuilder Builder(LayoutSettings, Cache);
+			int64 NumLayoutNodes = 0;
+
+			for (const TArray<FAssetIdentifier>& GraphRoot : GraphRoots)
+			{
+				FRefGraphLayout Layout;
+				Builder.Build(GraphRoot, FIntPoint(ForceInitToZero), Layout);
+				NumLayoutNodes += Layout.Nodes.Num();
+			}
+
+			return NumLayoutNodes;
+		});
+
+		RunStage(NumPackages, TEXT("RefGraph"), TEXT("nodes"), Results, [&]() -> int64
+		{
+			// the reference viewer's default settings, filtered for the registry source on this thread
+			URefGraph* RefGraph = NewObject<URefGraph>(GetTransientPackage());
+			int64 NumGraphNodes = 0;
+
+			for (const TArray<FAssetIdentifier>& GraphRoot : GraphRoots)
+			{
+				RefGraph->SetGraphRoot(GraphRoot);
+				RefGraph->RebuildGraph();
+				NumGraphNodes += RefGraph->Nodes.Num();
+			}
+
+			return NumGraphNodes;
+		});
+
+		Modules.Empty();
+		Graph.Reset();
+
+		PakMgrModule.ResetRegistrySource();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+	}
+
+	/** Writes the results as CSV. */
+	bool SaveReport(const TArray<FStageResult>& Results, const FString& Filename)
+	{
+		FString Csv = TEXT("Packages,Stage,Seconds,Items,Unit,ItemsPerSecond,UsedMB,PeakMB\n");
+
+		for (const FStageResult& Result : Results)
+		{
+			Csv += FString::Printf(TEXT("%d,%s,%.6f,%lld,%s,%.1f,%.1f,%.1f\n"), Result.NumPackages, *Result.Stage, Result.Seconds, Result.NumItems, *Result.ItemName,
+				Result.NumItems / FMath::Max(Result.Seconds, 1e-6), Result.UsedMegabytes, Result.PeakMegabytes);
+		}
+
+		if (!FFileHelper::SaveStringToFile(Csv, *Filename))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to write the benchmark report %s"), *Filename);
+
+			return false;
+		}
+
+		UE_LOG(LogPakMgr, Display, TEXT("Wrote the benchmark report to %s"), *Filename);
+
+		return true;
+	}
+
+	/** Compares the results with an earlier report, returns false if a stage got too slow. */
+	bool CheckBaseline(const TArray<FStageResult>& Results, const FString& Filename, float MaxSlowdownPercent)
+	{
+		TArray<FString> Lines;
+
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to read the benchmark baseline %s"), *Filename);
+
+			return false;
+		}
+
+		// keyed by scale and stage, the first line is the header
+		TMap<FString, double> BaselineSeconds;
+
+		for (int32 LineIndex = 1; LineIndex < Lines.Num(); ++LineIndex)
+		{
+			TArray<FString> Columns;
+
+			if (Lines[LineIndex].ParseIntoArray(Columns, TEXT(","), false) >= 3)
+			{
+				BaselineSeconds.Add(Columns[0] + TEXT("/") + Columns[1], FCString::Atod(*Columns[2]));
+			}
+		}
+
+		bool bPassed = true;
+
+		for (const FStageResult& Result : Results)
+		{
+			const double* FoundSeconds = BaselineSeconds.Find(FString::Printf(TEXT("%d/%s"), Result.NumPackages, *Result.Stage));
+
+			if ((FoundSeconds == nullptr) || (*FoundSeconds < MinBaselineSeconds))
+			{
+				continue;
+			}
+
+			const double SlowdownPercent = (Result.Seconds / *FoundSeconds - 1.0) * 100.0;
+
+			if (SlowdownPercent > MaxSlowdownPercent)
+			{
+				UE_LOG(LogPakMgr, Error, TEXT("%s took %.3f seconds for %d packages, %.0f%% slower than the baseline's %.3f seconds"),
+					*Result.Stage, Result.Seconds, Result.NumPackages, SlowdownPercent, *FoundSeconds);
+
+				bPassed = false;
+			}
+		}
+
+		return bPassed;
+	}
+}
+
+
+/* UPakMgrBenchmarkCommandlet structors
+ *****************************************************************************/
+
+UPakMgrBenchmarkCommandlet::UPakMgrBenchmarkCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 UPakMgrBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace PakMgrBenchmark;
+
+	FSettings Settings;
+
+	if (!ParseSettings(Params, Settings))
+	{
+		return 1;
+	}
+
+	FString TraceFilename;
+
+	if (FParse::Value(*Params, TEXT("Trace="), TraceFilename) || FParse::Param(*Params, TEXT("Trace")))
+	{
+		if (TraceFilename.IsEmpty())
+		{
+			TraceFilename = FPakMgrTrace::GetDefaultFilename();
+		}
+
+		FPakMgrTrace::Start();
+	}
+
+	TArray<FStageResult> Results;
+
+	for (int32 NumPackages : Settings.Scales)
+	{
+		RunScale(Settings, NumPackages, Results);
+	}
+
+	if (FPakMgrTrace::IsRecording())
+	{
+		FPakMgrTrace::Stop(TraceFilename).Wait();
+	}
+
+	int32 Result = 0;
+	FString ReportFilename;
+	FString BaselineFilename;
+
+	if (FParse::Value(*Params, TEXT("Report="), ReportFilename) && !SaveReport(Results, ReportFilename))
+	{
+		Result = 1;
+	}
+
+	if (FParse::Value(*Params, TEXT("Baseline="), BaselineFilename))
+	{
+		float MaxSlowdownPercent = 25.0f;
+		FParse::Value(*Params, TEXT("MaxSlowdown="), MaxSlowdownPercent);
+
+		if (!CheckBaseline(Results, BaselineFilename, MaxSlowdownPercent))
+		{
+			Result = 1;
+		}
+	}
+
+	return Result;
+}
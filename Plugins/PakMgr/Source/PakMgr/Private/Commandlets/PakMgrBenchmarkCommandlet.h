@@ -0,0 +1,63 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PakMgrBenchmarkCommandlet.generated.h"
+
+/**
+ * Times the PakMgr graph algorithms on synthetic asset registries, without a project's content.
+ *
+ * For every scale a registry state is generated with the given number of packages. Dependency
+ * counts follow a power law, a few packages are shared by many, some packages are redirectors
+ * missing from the registry source, and back edges form reference cycles. The state becomes the
+ * current registry source, and each stage is timed on it:
+ *
+ *   GenerateRegistry  builds the registry state
+ *   DependencyGraph   snapshots it into the dependency graph
+ *   Closures          computes the module closures
+ *   SharedAnalysis    splits the closures into shared and module-only packages
+ *   Partition         splits the packages of every pak below the size limit
+ *   FilterIdentifiers filters package dependencies for the registry source, resolving redirectors
+ *   RefGraphLayout    lays out reference graphs on the snapshot, as the background build does
+ *   RefGraph          rebuilds reference viewer graphs with the viewer's defaults, nodes included
+ *
+ * Every stage reports its time, throughput and the process memory in use after it, and the peak
+ * of the process so far. Scales run from small to large, so the peak after a scale is the peak of
+ * that scale. Use -Trace for memory sampled within the stages.
+ *
+ * Usage:
+ *   UE4Editor-Cmd <Project>.uproject -run=PakMgrBenchmark -nullrhi [options]
+ *
+ * Options:
+ *   -Packages=<A+B+...>    Scales to run, in packages. Defaults to 10000+100000.
+ *   -Seed=<N>              Seed of the generator, the same seed gives the same registries.
+ *   -FanOut=<N>            Mean number of dependencies of a package, defaults to 6.
+ *   -Exponent=<X>          Exponent of the dependency count distribution, above 2. Defaults to 2.5.
+ *   -Redirectors=<Ratio>   Share of packages that are redirectors, defaults to 0.02.
+ *   -Cycles=<Ratio>        Share of dependencies pointing back to an earlier package, defaults to 0.01.
+ *   -Soft=<Ratio>          Share of soft dependencies, defaults to 0.2.
+ *   -Modules=<N>           Number of module maps, defaults to 32.
+ *   -SharingThreshold=<N>  Number of modules from which on a package is shared, defaults to 2.
+ *   -MaxSize=<MB>          Size limit of a pak, defaults to 256.
+ *   -FilterSamples=<N>     Number of packages whose dependencies are filtered, defaults to 100000.
+ *   -GraphRoots=<N>        Number of packages reference graphs are built around, defaults to 100.
+ *   -LayoutDepth=<N>       Search depth of the reference graph layouts, defaults to 3.
+ *   -LayoutBreadth=<N>     Search breadth of the reference graph layouts, defaults to 15.
+ *   -Report=<File>         Writes the results as CSV.
+ *   -Baseline=<File>       Fails if a stage got slower than in this earlier report.
+ *   -MaxSlowdown=<Percent> Slowdown against the baseline tolerated before failing, defaults to 25.
+ *   -Trace[=<File>]        Records a Chrome trace of the run, by default to Saved/Profiling/PakMgr.
+ */
+UCLASS()
+class UPakMgrBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+};
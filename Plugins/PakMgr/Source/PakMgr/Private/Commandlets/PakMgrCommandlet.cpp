@@ -0,0 +1,279 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Commandlets/PakMgrCommandlet.h"
+#include "AssetRegistryModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Models/PakModuleInfo.h"
+#include "PakManager/PakBuildPipeline.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+/* UPakMgrCommandlet structors
+ *****************************************************************************/
+
+UPakMgrCommandlet::UPakMgrCommandlet(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+	ShowErrorCount = true;
+}
+
+
+/* UCommandlet interface
+ *****************************************************************************/
+
+int32 UPakMgrCommandlet::Main(const FString& Params)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	FString TraceFilename;
+
+	if (FParse::Value(*Params, TEXT("Trace="), TraceFilename) || FParse::Param(*Params, TEXT("Trace")))
+	{
+		if (TraceFilename.IsEmpty())
+		{
+			TraceFilename = FPakMgrTrace::GetDefaultFilename();
+		}
+
+		FPakMgrTrace::Start();
+	}
+
+	const int32 Result = Run(Params);
+
+	if (FPakMgrTrace::IsRecording())
+	{
+		FPakMgrTrace::Stop(TraceFilename).Wait();
+	}
+
+	if (Result != 0)
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("PakMgr failed after %.2f seconds"), FPlatformTime::Seconds() - StartTime);
+	}
+
+	return Result;
+}
+
+
+/* UPakMgrCommandlet implementation
+ *****************************************************************************/
+
+int32 UPakMgrCommandlet::Run(const FString& Params)
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// SelCon
+	FString ContentDirectory = FPaths::ProjectContentDir();
+	FParse::Value(*Params, TEXT("Content="), ContentDirectory);
+	ContentDirectory = FPaths::ConvertRelativePathToFull(ContentDirectory);
+
+	// AddM
+	TArray<FString> MapFilenames;
+
+	if (!GatherModuleMaps(Params, ContentDirectory, MapFilenames))
+	{
+		return 1;
+	}
+
+	if (MapFilenames.Num() == 0)
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("No module maps found in %s"), *ContentDirectory);
+
+		return 1;
+	}
+
+	// GenRef, the registry only scans in the background in the editor
+	IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry.SearchAllAssets(true);
+
+	IPakMgrModule& PakMgrModule = IPakMgrModule::Get();
+	FString RegistryFilename;
+
+	if (FParse::Value(*Params, TEXT("Registry="), RegistryFilename))
+	{
+		// the cooked registry describes what actually ships, the editor registry is only used for redirectors
+		if (!PakMgrModule.LoadCookedRegistrySource(RegistryFilename))
+		{
+			return 1;
+		}
+	}
+
+	PakMgrModule.InvalidateDependencyGraph();
+
+	TArray<FPakModuleInfo> Modules;
+	FPakModuleInfo::CreateModules(PakMgrModule.GetDependencyGraph(), MapFilenames, Modules);
+
+	if (Modules.Num() == 0)
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("None of the %d module maps could be resolved"), MapFilenames.Num());
+
+		return 1;
+	}
+
+	// GenPaks and GenMani
+	FPakBuildSettings Settings;
+	Settings.Load();
+	ApplySettingsOverrides(Params, Settings);
+
+	const bool bManifestOnly = FParse::Param(*Params, TEXT("ManifestOnly"));
+	FPakBuildPipeline Pipeline(Settings, bManifestOnly);
+
+	TArray<FPakBuildJob> Jobs;
+
+	if (!Pipeline.CreateModuleJobs(Modules, Jobs))
+	{
+		return 1;
+	}
+
+	bool bSucceeded = true;
+
+	if (bManifestOnly)
+	{
+		bSucceeded = Pipeline.SaveManifest(Jobs);
+	}
+	else
+	{
+		UE_LOG(LogPakMgr, Display, TEXT("Building %d paks for %d modules into %s"), Jobs.Num(), Modules.Num(), *Settings.OutputDirectory);
+
+		bSucceeded = Pipeline.BuildPaks(Jobs);
+
+		FPakBuildResult Result;
+
+		while (Pipeline.DequeueResult(Result))
+		{
+			if (Result.bSucceeded)
+			{
+				UE_LOG(LogPakMgr, Display, TEXT("%s: %d files (%d from cache), %lld bytes -> %lld bytes in %.2f seconds"), *Result.PakFilename, Result.NumFiles, Result.NumCachedFiles, Result.UncompressedSize, Result.PakSize, Result.Seconds);
+			}
+			else
+			{
+				UE_LOG(LogPakMgr, Error, TEXT("%s: failed"), *Result.PakFilename);
+			}
+		}
+	}
+
+	if (!bSucceeded)
+	{
+		return 1;
+	}
+
+	UE_LOG(LogPakMgr, Display, TEXT("PakMgr wrote %s in %.2f seconds"), *Pipeline.GetManifestFilename(), FPlatformTime::Seconds() - StartTime);
+
+	return 0;
+}
+
+
+bool UPakMgrCommandlet::GatherModuleMaps(const FString& Params, const FString& ContentDirectory, TArray<FString>& OutMapFilenames) const
+{
+	TArray<FString> ModuleNames;
+	FString ModulesString;
+	FString ModuleListFilename;
+
+	if (FParse::Value(*Params, TEXT("Modules="), ModulesString))
+	{
+		ModulesString.ParseIntoArray(ModuleNames, TEXT("+"));
+	}
+
+	if (FParse::Value(*Params, TEXT("ModuleList="), ModuleListFilename))
+	{
+		TArray<FString> Lines;
+
+		if (!FFileHelper::LoadFileToStringArray(Lines, *ModuleListFilename))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to read the module list %s"), *ModuleListFilename);
+
+			return false;
+		}
+
+		for (const FString& Line : Lines)
+		{
+			const FString ModuleName = Line.TrimStartAndEnd();
+
+			if (!ModuleName.IsEmpty() && !ModuleName.StartsWith(TEXT("#")))
+			{
+				ModuleNames.Add(ModuleName);
+			}
+		}
+	}
+
+	// without an explicit list every map of the content directory is a module
+	if (ModuleNames.Num() == 0)
+	{
+		IFileManager::Get().FindFilesRecursive(OutMapFilenames, *ContentDirectory, TEXT("*.umap"), true, false);
+		OutMapFilenames.Sort();
+
+		return true;
+	}
+
+	bool bSucceeded = true;
+
+	for (const FString& ModuleName : ModuleNames)
+	{
+		FString MapFilename = FPaths::IsRelative(ModuleName) ? ContentDirectory / ModuleName : ModuleName;
+
+		if (FPaths::GetExtension(MapFilename).IsEmpty())
+		{
+			MapFilename += TEXT(".umap");
+		}
+
+		if (!FPaths::FileExists(MapFilename))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Module map %s does not exist"), *MapFilename);
+			bSucceeded = false;
+
+			continue;
+		}
+
+		OutMapFilenames.AddUnique(FPaths::ConvertRelativePathToFull(MapFilename));
+	}
+
+	return bSucceeded;
+}
+
+
+void UPakMgrCommandlet::ApplySettingsOverrides(const FString& Params, FPakBuildSettings& Settings) const
+{
+	FString Platform;
+
+	if (FParse::Value(*Params, TEXT("Platform="), Platform))
+	{
+		// runs for several platforms at once must not share outputs or cache indices
+		Settings.CookedDirectory = FPaths::ProjectSavedDir() / TEXT("Cooked") / Platform;
+		Settings.OutputDirectory = Settings.OutputDirectory / Platform;
+		Settings.CacheDirectory = Settings.CacheDirectory / Platform;
+	}
+
+	FParse::Value(*Params, TEXT("Cooked="), Settings.CookedDirectory);
+	FParse::Value(*Params, TEXT("Output="), Settings.OutputDirectory);
+
+	int32 MaxSizeMegabytes = 0;
+
+	if (FParse::Value(*Params, TEXT("MaxSize="), MaxSizeMegabytes))
+	{
+		Settings.bLimitPakSize = (MaxSizeMegabytes > 0);
+		Settings.MaxPakSize = (int64)FMath::Max(MaxSizeMegabytes, 1) << 20;
+	}
+
+	int32 SharingThreshold = 0;
+
+	if (FParse::Value(*Params, TEXT("SharingThreshold="), SharingThreshold))
+	{
+		Settings.bExtractSharedPackages = (SharingThreshold >= 2);
+		Settings.SharingThreshold = FMath::Max(SharingThreshold, 2);
+	}
+
+	if (FParse::Value(*Params, TEXT("OpenOrder="), Settings.OpenOrderFilename))
+	{
+		Settings.bUseOpenOrder = true;
+	}
+
+	if (FParse::Param(*Params, TEXT("NoBuildCache")))
+	{
+		Settings.bUseBuildCache = false;
+	}
+}
@@ -0,0 +1,56 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PakMgrCommandlet.generated.h"
+
+struct FPakBuildSettings;
+
+/**
+ * Runs the PakMgr stages without any UI: SelCon, AddM, GenRef, GenPaks and GenMani.
+ *
+ * Usage:
+ *   UE4Editor-Cmd <Project>.uproject -run=PakMgr -nullrhi [options]
+ *
+ * Options:
+ *   -Content=<Dir>        Content directory searched for module maps (SelCon), defaults to the project content.
+ *   -Modules=<A+B+...>    Module maps to pak (AddM), relative to the content directory. Defaults to all maps found.
+ *   -ModuleList=<File>    Text file listing one module map per line, in addition to -Modules.
+ *   -Platform=<Name>      Cooked platform, selects Saved/Cooked/<Name> and gives the output and cache their own directories.
+ *   -Cooked=<Dir>         Cooked directory, overrides -Platform.
+ *   -Registry=<File>      Resolves references from this cooked AssetRegistry.bin instead of the editor registry.
+ *   -Output=<Dir>         Output directory of the paks and manifests.
+ *   -MaxSize=<MB>         Splits modules into paks of at most this size.
+ *   -SharingThreshold=<N> Number of modules from which on a package goes into a common pak, below 2 nothing is shared.
+ *   -OpenOrder=<File>     Places files in the open order recorded in this log.
+ *   -NoBuildCache         Compresses every file again.
+ *   -ManifestOnly         Skips GenPaks and only writes the manifests.
+ *   -Trace[=<File>]       Records a Chrome trace of the run, by default to Saved/Profiling/PakMgr.
+ *
+ * Settings not given on the command line are taken from the [PakMgr] section of the editor ini,
+ * which is never written. Runs for different platforms may execute in parallel.
+ */
+UCLASS()
+class UPakMgrCommandlet : public UCommandlet
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	//~ UCommandlet interface
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+
+	/** Runs the stages, returns the exit code. */
+	int32 Run(const FString& Params);
+
+	/** Finds the module maps selected on the command line. */
+	bool GatherModuleMaps(const FString& Params, const FString& ContentDirectory, TArray<FString>& OutMapFilenames) const;
+
+	/** Applies the command line overrides to the build settings. */
+	void ApplySettingsOverrides(const FString& Params, FPakBuildSettings& Settings) const;
+};
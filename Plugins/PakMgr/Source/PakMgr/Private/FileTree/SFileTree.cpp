@@ -5,8 +5,10 @@
 #include "Misc/MessageDialog.h"
 #include "EditorDirectories.h"
 #include "AssetRegistryModule.h"
+#include "Misc/PackageName.h"
+#include "Models/DependencyClosure.h"
+#include "Models/PackageRoots.h"
 #include "Browser/SContentBrowser.h"
-#include "Models/ContentItemInfo.h"
 #include "Interfaces/IMainFrameModule.h"
 #include "HAL/FileManager.h"
 #include "PakMgrModule.h"
@@ -25,16 +27,54 @@
 #include "FileTree/SFileTreeShortcutWindow.h"
 #include "FileTree/SFileTreeToolbar.h"
 #include "Widgets/Layout/SExpandableArea.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "Models/PathSearchIndex.h"
+#include "PakMgrTrace.h"
 
 
 #define LOCTEXT_NAMESPACE "SFileTreePanel"
 
 
+/** Maximum number of received messages added to the log per tick, the rest waits for the next one. */
+static const int32 MaxIngestedLogsPerTick = 65536;
+
+
+/** Search results shared between the worker and the panel. */
+struct FFileTreeSearchTask
+{
+	/** Maximum number of paths a search lists. */
+	static const int32 MaxResults = 10000;
+
+	/** Set by the panel to stop the worker. */
+	FThreadSafeBool bCancelRequested;
+
+	/** Set by the worker once all results are queued. */
+	FThreadSafeBool bFinished;
+
+	/** Whether the index was still being built when the search started, so the results are incomplete. */
+	bool bIndexWasBuilding;
+
+	/** Batches of results, queued by the worker and taken by the panel's tick. */
+	TQueue<TArray<FName>, EQueueMode::Spsc> Results;
+
+	FFileTreeSearchTask()
+		: bIndexWasBuilding(false)
+	{ }
+};
+
+
 /* SFileTreePanel structors
  *****************************************************************************/
 
 SFileTree::~SFileTree()
 {
+	FTicker::GetCoreTicker().RemoveTicker(IngestTickerHandle);
+
+	CancelSearch();
+
 	if (SessionManager.IsValid())
 	{
 		SessionManager->OnInstanceSelectionChanged().RemoveAll(this);
@@ -52,6 +92,18 @@ void SFileTree::Construct(const FArguments& InArgs, TSharedRef<IPFileManager> In
 {
 	SessionManager = InSessionManager;
 	ShouldScrollToLast = true;
+	bSearchMode = false;
+	bSortEnabled = false;
+	SortKey = EPakMgrFileSortKey::Path;
+	LogStore = MakeShareable(new FPakMgrLogStore());
+	SearchResults = MakeShareable(new FPakMgrLogStore());
+	LogTableModel = MakeShareable(new FPakMgrLogTableModel(LogStore.ToSharedRef()));
+	IngestQueue = MakeShareable(new FPakMgrLogIngestQueue(TEXT("File Tree")));
+	LogSaver = MakeShareable(new FPakMgrLogSaver());
+	NextCountedLog = LogStore->GetFirst();
+
+	// Slate does not tick hidden tabs, the queue would grow without bound while the panel is in the background
+	IngestTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &SFileTree::HandleIngestTicker));
 
 	// create and bind the commands
 	UICommandList = MakeShareable(new FUICommandList);
@@ -104,11 +156,12 @@ void SFileTree::Construct(const FArguments& InArgs, TSharedRef<IPFileManager> In
 									//.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
 									.Padding(0.0f)
 									[
-										SAssignNew(LogListView, SListView<TSharedPtr<FFileItemInfo>>)
+										SAssignNew(LogListView, SListView<FPakMgrLogHandle>)
 											.ItemHeight(24.0f)
 											.ListItemsSource(&LogMessages)
 											.SelectionMode(ESelectionMode::Multi)
 											.OnGenerateRow(this, &SFileTree::HandleLogListGenerateRow)
+											.OnRowReleased(this, &SFileTree::HandleLogListRowReleased)
 											.OnItemScrolledIntoView(this, &SFileTree::HandleLogListItemScrolledIntoView)
 											.HeaderRow
 											(
@@ -209,17 +262,22 @@ void SFileTree::BindCommands()
 	UICommandList->MapAction(
 		Commands.SortRef,
 		FExecuteAction::CreateSP(this, &SFileTree::HandleSortActionExecute),
-		FCanExecuteAction::CreateSP(this, &SFileTree::HandleSortActionCanExecute));
+		FCanExecuteAction::CreateSP(this, &SFileTree::HandleSortActionCanExecute),
+		FIsActionChecked::CreateSP(this, &SFileTree::HandleSortActionIsChecked));
 
 	UICommandList->MapAction(
 		Commands.SearchFiles,
 		FExecuteAction::CreateSP(this, &SFileTree::HandleSearchActionExecute),
-		FCanExecuteAction::CreateSP(this, &SFileTree::HandleSearchActionCanExecute));
+		FCanExecuteAction::CreateSP(this, &SFileTree::HandleSearchActionCanExecute),
+		FIsActionChecked::CreateSP(this, &SFileTree::HandleSearchActionIsChecked));
 }
 
 
 void SFileTree::ClearLog()
 {
+	// messages received before clearing are cleared as well
+	IngestLogs();
+
 	LogMessages.Reset();
 	LogListView->RequestListRefresh();
 }
@@ -227,19 +285,23 @@ void SFileTree::ClearLog()
 
 void SFileTree::CopyLog()
 {
-	TArray<TSharedPtr<FFileItemInfo>> SelectedItems = LogListView->GetSelectedItems();
+	TArray<FPakMgrLogHandle> SelectedItems = LogListView->GetSelectedItems();
 
 	if (SelectedItems.Num() == 0)
 	{
 		return;
 	}
 
+	const FPakMgrLogStore& Store = *GetListedStore();
 	FString SelectedText;
 
-	for (const auto& Item : SelectedItems)
+	for (const FPakMgrLogHandle& Item : SelectedItems)
 	{
-		SelectedText += FString::Printf(TEXT("%s [%s] %09.3f: %s"), *Item->Time.ToString(), *Item->InstanceName, Item->TimeSeconds, *Item->Text);
-		SelectedText += LINE_TERMINATOR;
+		if (Store.Contains(Item))
+		{
+			SelectedText += FString::Printf(TEXT("%s [%s] %09.3f: %s"), *Store.GetTime(Item).ToString(), *Store.GetInstanceName(Item), Store.GetTimeSeconds(Item), Store.GetText(Item));
+			SelectedText += LINE_TERMINATOR;
+		}
 	}
 
 	FPlatformApplicationMisc::ClipboardCopy(*SelectedText);
@@ -251,35 +313,27 @@ void SFileTree::ReloadLog(bool FullyReload)
 	// reload log list
 	if (FullyReload)
 	{
-		AvailableLogs.Reset();
+		ReloadLogStore();
 
-		const auto& SelectedInstances = SessionManager->GetSelectedInstances();
+		CommandBar->SetNumSelectedInstances(SessionManager->GetSelectedInstances().Num());
+	}
 
-		for (const auto& Instance : SelectedInstances)
-		{
-			const TArray<TSharedPtr<FFileItemInfo>>& InstanceLog = Instance->GetLog();
+	CountNewLogs();
 
-			for (const auto& LogMessage : InstanceLog)
-			{
-				AvailableLogs.HeapPush(LogMessage, FFileItemInfo::TimeComparer());
-			}
-		}
+	// the list shows search results instead
+	if (bSearchMode)
+	{
+		StartSearch();
 
-		CommandBar->SetNumSelectedInstances(SelectedInstances.Num());
+		return;
 	}
 
-	LogMessages.Reset();
-
 	// filter log list
-	FilterBar->ResetFilter();
+	ActiveFilter = FilterBar->GetFilter();
+	LogStore->GetHandles(LogMessages);
+	FilterLogMessages(LogMessages, LogMessages);
 
-	for (const auto& LogMessage : AvailableLogs)
-	{
-		if (FilterBar->FilterLogMessage(LogMessage.ToSharedRef()))
-		{
-			LogMessages.Add(LogMessage);
-		}
-	}
+	SortLog();
 
 	// refresh list view
 	LogListView->RequestListRefresh();
@@ -291,74 +345,207 @@ void SFileTree::ReloadLog(bool FullyReload)
 }
 
 
+void SFileTree::ReloadLogStore()
+{
+	TArray<TSharedPtr<FFileItemInfo>> InstanceLogs;
+
+	for (const auto& Instance : SessionManager->GetSelectedInstances())
+	{
+		InstanceLogs.Append(Instance->GetLog());
+	}
+
+	InstanceLogs.StableSort(FFileItemInfo::TimeComparer());
+
+	// messages still queued are kept, they are added after the reloaded ones
+	LogStore->Reset();
+
+	for (const auto& LogMessage : InstanceLogs)
+	{
+		LogStore->Add(*LogMessage);
+	}
+
+	FilterBar->ResetFilter();
+	NextCountedLog = LogStore->GetFirst();
+}
+
+
 void SFileTree::SaveLog()
 {
-	//IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+	LogSaver->SaveLog(AsShared(), *GetListedStore(), LogMessages);
+}
 
-	//if (DesktopPlatform == nullptr)
-	//{
-	//	FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("SaveLogDialogUnsupportedError", "Saving is not supported on this platform!"));
 
-	//	return;
-	//}
+void SFileTree::CountNewLogs()
+{
+	// the counters do not depend on the filter, so every message is only counted once
+	for (uint64 Sequence = FMath::Max(NextCountedLog.Sequence, LogStore->GetFirst().Sequence); Sequence < LogStore->GetEnd().Sequence; ++Sequence)
+	{
+		const FPakMgrLogHandle Handle(Sequence);
+
+		FilterBar->CountLogMessage(LogStore->GetCategory(Handle), LogStore->GetVerbosity(Handle));
+	}
 
-	TArray<FString> Filenames;
+	NextCountedLog = LogStore->GetEnd();
+}
 
-	// open file dialog
-	TSharedPtr<SWindow> ParentWindow = FSlateApplication::Get().FindWidgetWindow(AsShared());
-	void* ParentWindowHandle = (ParentWindow.IsValid() && ParentWindow->GetNativeWindow().IsValid()) ? ParentWindow->GetNativeWindow()->GetOSWindowHandle() : nullptr;
 
-	//if (!DesktopPlatform->SaveFileDialog(
-	//	ParentWindowHandle,
-	//	LOCTEXT("SaveLogDialogTitle", "Save Log As...").ToString(),
-	//	LastLogFileSaveDirectory,
-	//	TEXT("Session.log"),
-	//	TEXT("Log Files (*.log)|*.log"),
-	//	EFileDialogFlags::None,
-	//	Filenames))
-	//{
-	//	return;
-	//}
+void SFileTree::IngestLogs()
+{
+	TArray<FPakMgrLogHandle> NewLogs;
+	const uint64 NumEvicted = LogStore->GetNumEvicted();
 
-	// no log file selected?
-	if (Filenames.Num() == 0)
+	if (IngestQueue->Drain(*LogStore, NewLogs, MaxIngestedLogsPerTick) == 0)
 	{
 		return;
 	}
 
-	FString Filename = Filenames[0];
+	CountNewLogs();
 
-	// keep path as default for next time
-	LastLogFileSaveDirectory = FPaths::GetPath(Filename);
+	if (bSearchMode)
+	{
+		return;
+	}
+
+	if (LogStore->GetNumEvicted() != NumEvicted)
+	{
+		RemoveEvictedLogs();
+
+		const FPakMgrLogStore& Store = *LogStore;
+		NewLogs.RemoveAll([&Store](const FPakMgrLogHandle& Handle) { return !Store.Contains(Handle); });
+	}
+
+	// filtered messages are kept in the store as well, a wider filter may show them later
+	FilterLogMessages(NewLogs, NewLogs);
+
+	if (NewLogs.Num() == 0)
+	{
+		return;
+	}
+
+	LogMessages.Append(NewLogs);
 
-	// add a file extension if none was provided
-	if (FPaths::GetExtension(Filename).IsEmpty())
+	LogListView->RequestListRefresh();
+
+	if (ShouldScrollToLast)
 	{
-		Filename += Filename + TEXT(".log");
+		LogListView->RequestScrollIntoView(LogMessages.Last());
 	}
+}
 
-	// save file
-	FArchive* LogFile = IFileManager::Get().CreateFileWriter(*Filename);
 
-	if (LogFile != nullptr)
+void SFileTree::FilterLogMessages(const TArray<FPakMgrLogHandle>& Messages, TArray<FPakMgrLogHandle>& OutMessages) const
+{
+	const int32 MessagesPerChunk = 16384;
+	const int32 NumChunks = FMath::DivideAndRoundUp(Messages.Num(), MessagesPerChunk);
+
+	// the workers only read the store, the handles are copied on this thread
+	const FPakMgrLogStore& Store = *LogStore;
+	TArray<bool> Passed;
+	Passed.SetNumUninitialized(Messages.Num());
+
+	ParallelFor(NumChunks, [this, &Store, &Messages, &Passed, MessagesPerChunk](int32 ChunkIndex)
 	{
-		for (const auto& LogMessage : LogMessages)
+		const int32 First = ChunkIndex * MessagesPerChunk;
+		const int32 Last = FMath::Min(First + MessagesPerChunk, Messages.Num());
+
+		for (int32 Index = First; Index < Last; ++Index)
 		{
-			FString LogEntry = FString::Printf(TEXT("%s [%s] %09.3f: %s"),
-				*LogMessage->Time.ToString(),
-				*LogMessage->InstanceName,
-				LogMessage->TimeSeconds,
-				*LogMessage->Text) + LINE_TERMINATOR;
+			Passed[Index] = ActiveFilter.PassesFilter(Store, Messages[Index]);
+		}
+	}, NumChunks < 2);
 
-			LogFile->Serialize(TCHAR_TO_ANSI(*LogEntry), LogEntry.Len());
+	TArray<FPakMgrLogHandle> Result;
+	Result.Reserve(Messages.Num());
+
+	for (int32 Index = 0; Index < Messages.Num(); ++Index)
+	{
+		if (Passed[Index])
+		{
+			Result.Add(Messages[Index]);
 		}
+	}
+
+	// Messages may be OutMessages
+	OutMessages = MoveTemp(Result);
+}
+
 
-		LogFile->Close();
-		delete LogFile;
+void SFileTree::SortLog()
+{
+	if (!bSortEnabled)
+	{
+		return;
 	}
-	else
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// sizes, reference counts and depths read best largest first
+	FPakMgrFileItemSorter::Sort(LogMessages, *GetListedStore(), SortKey, (SortKey != EPakMgrFileSortKey::Path) && (SortKey != EPakMgrFileSortKey::Module), ReferenceGraph.Get());
+
+	UE_LOG(LogPakMgr, Verbose, TEXT("Sorted %d items by %s in %.2f ms"), LogMessages.Num(), FPakMgrFileItemSorter::GetKeyName(SortKey), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+
+void SFileTree::RemoveEvictedLogs()
+{
+	const FPakMgrLogStore& Store = *GetListedStore();
+
+	LogMessages.RemoveAll([&Store](const FPakMgrLogHandle& Handle) { return !Store.Contains(Handle); });
+	LogListView->RequestListRefresh();
+}
+
+
+void SFileTree::StartSearch()
+{
+	CancelSearch();
+
+	LogMessages.Reset();
+	SearchResults->Reset();
+	LogListView->RequestListRefresh();
+
+	const FString Query = FilterBar->GetFilterText().ToString().TrimStartAndEnd();
+
+	if (Query.IsEmpty())
+	{
+		return;
+	}
+
+	const TSharedRef<FPakMgrPathSearchIndex, ESPMode::ThreadSafe> Index = IPakMgrModule::Get().GetPathSearchIndex();
+	const TSharedRef<FFileTreeSearchTask, ESPMode::ThreadSafe> Task = MakeShared<FFileTreeSearchTask, ESPMode::ThreadSafe>();
+	Task->bIndexWasBuilding = Index->IsBuilding();
+	SearchTask = Task;
+
+	Async<void>(EAsyncExecution::ThreadPool, [Task, Index, Query]()
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("SaveLogDialogFileError", "Failed to open the specified file for saving!"));
+		int32 NumFound = 0;
+
+		auto EnqueueResults = [&Task, &NumFound](const TArray<FName>& Paths)
+		{
+			Task->Results.Enqueue(Paths);
+			NumFound += Paths.Num();
+
+			return !Task->bCancelRequested;
+		};
+
+		Index->Search(Query, EPakMgrPathSearchMode::Substring, FFileTreeSearchTask::MaxResults, EnqueueResults);
+
+		// only guess at typos if nothing matches exactly
+		if ((NumFound == 0) && !Task->bCancelRequested)
+		{
+			Index->Search(Query, EPakMgrPathSearchMode::Fuzzy, FFileTreeSearchTask::MaxResults, EnqueueResults);
+		}
+
+		Task->bFinished = true;
+	});
+}
+
+
+void SFileTree::CancelSearch()
+{
+	if (SearchTask.IsValid())
+	{
+		SearchTask->bCancelRequested = true;
+		SearchTask.Reset();
 	}
 }
 
@@ -404,6 +591,57 @@ FReply SFileTree::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyE
 }
 
 
+void SFileTree::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	if (!SearchTask.IsValid())
+	{
+		return;
+	}
+
+	// read before draining, results queued after it would be lost otherwise
+	const bool bFinished = SearchTask->bFinished;
+
+	TArray<FName> Paths;
+	const FDateTime Now = FDateTime::Now();
+	const uint64 NumEvicted = SearchResults->GetNumEvicted();
+	bool bAddedResults = false;
+
+	while (SearchTask->Results.Dequeue(Paths))
+	{
+		for (FName Path : Paths)
+		{
+			LogMessages.Add(SearchResults->Add(TEXT("Search"), Path.ToString(), ELogVerbosity::Log, NAME_None, 0.0, Now));
+		}
+
+		bAddedResults = true;
+	}
+
+	if (SearchResults->GetNumEvicted() != NumEvicted)
+	{
+		RemoveEvictedLogs();
+	}
+	else if (bAddedResults)
+	{
+		LogListView->RequestListRefresh();
+	}
+
+	if (bFinished)
+	{
+		// a search over a partial index is repeated once the index is complete
+		if (SearchTask->bIndexWasBuilding && !IPakMgrModule::Get().GetPathSearchIndex()->IsBuilding())
+		{
+			StartSearch();
+		}
+		else
+		{
+			SearchTask.Reset();
+		}
+	}
+}
+
+
 /* SSessionConsolePanel event handlers
  *****************************************************************************/
 
@@ -482,11 +720,26 @@ void SFileTree::HandleFilterChanged()
 {
 	HighlightText = FilterBar->GetFilterText().ToString();
 
-	ReloadLog(false);
+	if (bSearchMode)
+	{
+		StartSearch();
+	}
+	else if (FilterBar->GetFilter().IsNarrowerThan(ActiveFilter))
+	{
+		// a stricter filter can only remove messages, so only the listed ones are filtered again
+		ActiveFilter = FilterBar->GetFilter();
+		FilterLogMessages(LogMessages, LogMessages);
+
+		LogListView->RequestListRefresh();
+	}
+	else
+	{
+		ReloadLog(false);
+	}
 }
 
 
-void SFileTree::HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> Item, const TSharedPtr<ITableRow>& TableRow)
+void SFileTree::HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow)
 {
 	if (LogMessages.Num() > 0)
 	{
@@ -499,12 +752,15 @@ void SFileTree::HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> Item
 }
 
 
-TSharedRef<ITableRow> SFileTree::HandleLogListGenerateRow(TSharedPtr<FFileItemInfo> Message, const TSharedRef<STableViewBase>& OwnerTable)
+TSharedRef<ITableRow> SFileTree::HandleLogListGenerateRow(FPakMgrLogHandle Message, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(SFileTreeitemTableRow, OwnerTable)
-		.HighlightText(this, &SFileTree::HandleLogListGetHighlightText)
-		.FileItemInfo(Message)
-		.ToolTipText(FText::FromString(Message->Text));
+	return LogTableModel->GenerateRow(Message, OwnerTable, TAttribute<FText>::Create(TAttribute<FText>::FGetter::CreateSP(this, &SFileTree::HandleLogListGetHighlightText)));
+}
+
+
+void SFileTree::HandleLogListRowReleased(const TSharedRef<ITableRow>& TableRow)
+{
+	LogTableModel->ReleaseRow(TableRow);
 }
 
 
@@ -514,6 +770,14 @@ FText SFileTree::HandleLogListGetHighlightText() const
 }
 
 
+bool SFileTree::HandleIngestTicker(float DeltaTime)
+{
+	IngestLogs();
+
+	return true;
+}
+
+
 bool SFileTree::HandleMainContentIsEnabled() const
 {
 	//return (SessionManager->GetSelectedInstances().Num() > 0);
@@ -523,32 +787,45 @@ bool SFileTree::HandleMainContentIsEnabled() const
 
 void SFileTree::HandleGenRefActionExecute()
 {
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	TArray<FAssetIdentifier> ReferenceNames;
+	PAKMGR_TRACE_SCOPE(GenRef);
 
-	
-	FString OutFailureReason = "";
-	FString AssetPath = "";
-	IPakMgrModule pakModule = IPakMgrModule::Get();
-	
-	TArray<TSharedPtr<FContentItemInfo>> items = SContentBrowser::Get()->GetItems();
-	for (auto& item : items)
+	if (!SContentBrowser::Get().IsValid())
+	{
+		return;
+	}
+
+	FPakMgrDependencyGraphPtr Graph = IPakMgrModule::Get().GetDependencyGraph();
+	const FDateTime Now = FDateTime::Now();
+	ReferenceGraph = Graph;
+
+	TArray<FString> MapFilenames;
+	SContentBrowser::Get()->GetItemFilenames(MapFilenames);
+
+	TArray<FPakModuleInfo> Modules;
+	FPakModuleInfo::CreateModules(Graph, MapFilenames, Modules);
+
+	// the rows of the previous run are replaced, not listed twice
+	ReloadLogStore();
+
+	for (const FPakModuleInfo& Module : Modules)
 	{
-		AssetPath = item->Text;
-		TArray<FName> HardDependencies;
-		TArray<FName> SoftDependencies;
-		//FAssetData AssetData = IPakMgrModule::Get().FindAssetDataFromAnyPath(AssetPath, OutFailureReason);
-		//if (!AssetData.IsValid())
-		//{
-		//	return;
-		//}
-		const UPackage* OuterPackage = pakModule.GetMapPackage(pakModule.ConvertPhysicalPathToUFSPath(AssetPath));
-		AssetRegistryModule.Get().GetReferencers(FAssetIdentifier(OuterPackage->GetFName()), ReferenceNames);
-		AssetRegistryModule.Get().GetDependencies(OuterPackage->GetFName(), HardDependencies, EAssetRegistryDependencyType::Hard);
-		AssetRegistryModule.Get().GetDependencies(OuterPackage->GetFName(), SoftDependencies, EAssetRegistryDependencyType::Soft);
-		if (ReferenceNames.Num() > 0 && HardDependencies.Num() > 0)
-			UE_LOG(LogPakMgr, Warning, TEXT("HandleGenRefActionExecute ReferenceNames %s dependencies %s "), *ReferenceNames[0].ToString(), *HardDependencies[0].ToString());
+		// list the module's packages, native packages never end up in a pak
+		for (int32 NodeIndex = 0; NodeIndex < Module.Closure.Nodes.Num(); ++NodeIndex)
+		{
+			const int32 Node = Module.Closure.Nodes[NodeIndex];
+			const FName PackageName = Graph->GetPackageName(Node);
+
+			if (Graph->IsInRegistrySource(Node) && !FPakMgrPackageRoots::Get().IsScriptPackage(PackageName))
+			{
+				const FPakMgrLogHandle Item = LogStore->Add(Module.Name, PackageName.ToString(), ELogVerbosity::Log, NAME_None, 0.0, Now);
+				LogStore->SetNode(Item, Node, Module.Closure.Depths[NodeIndex]);
+			}
+		}
 	}
+
+	SessionManager->SetModules(Modules);
+
+	ReloadLog(false);
 }
 
 
@@ -559,7 +836,30 @@ bool SFileTree::HandleGenRefActionCanExecute()
 
 void SFileTree::HandleSortActionExecute()
 {
-	SaveLog();
+	// cycle through the keys, then back to the unsorted list
+	if (!bSortEnabled)
+	{
+		bSortEnabled = true;
+		SortKey = EPakMgrFileSortKey::Path;
+	}
+	else if (SortKey == EPakMgrFileSortKey::Module)
+	{
+		bSortEnabled = false;
+	}
+	else
+	{
+		SortKey = (EPakMgrFileSortKey)((uint8)SortKey + 1);
+	}
+
+	if (bSortEnabled)
+	{
+		SortLog();
+		LogListView->RequestListRefresh();
+	}
+	else
+	{
+		ReloadLog(false);
+	}
 }
 
 
@@ -568,9 +868,27 @@ bool SFileTree::HandleSortActionCanExecute()
 	return true;
 }
 
+
+bool SFileTree::HandleSortActionIsChecked() const
+{
+	return bSortEnabled;
+}
+
 void SFileTree::HandleSearchActionExecute()
 {
-	SaveLog();
+	bSearchMode = !bSearchMode;
+
+	if (!bSearchMode)
+	{
+		CancelSearch();
+	}
+
+	// the list switches stores, whose handles may collide, so no row or selection is kept
+	LogTableModel->SetStore(GetListedStore().ToSharedRef());
+	LogListView->ClearSelection();
+	LogListView->RebuildList();
+
+	ReloadLog(false);
 }
 
 
@@ -580,6 +898,12 @@ bool SFileTree::HandleSearchActionCanExecute()
 }
 
 
+bool SFileTree::HandleSearchActionIsChecked() const
+{
+	return bSearchMode;
+}
+
+
 EVisibility SFileTree::HandleSelectSessionOverlayVisibility() const
 {
 	//if (SessionManager->GetSelectedInstances().Num() > 0)
@@ -599,20 +923,13 @@ void SFileTree::HandleSessionManagerInstanceSelectionChanged(const TSharedPtr<IF
 
 void SFileTree::HandleSessionManagerLogReceived(const TSharedRef<IFileInfo>& Session, const TSharedRef<IFileInstanceInfo>& Instance, const TSharedRef<FFileItemInfo>& Message)
 {
-	if (!SessionManager->IsInstanceSelected(Instance) || !FilterBar->FilterLogMessage(Message))
+	if (!SessionManager->IsInstanceSelected(Instance))
 	{
 		return;
 	}
 
-	AvailableLogs.Add(Message);
-	LogMessages.Add(Message);
-
-	LogListView->RequestListRefresh();
-
-	if (ShouldScrollToLast)
-	{
-		LogListView->RequestScrollIntoView(Message);
-	}
+	// listed by the next tick, together with everything else received until then
+	IngestQueue->Enqueue(*Message);
 }
 
 
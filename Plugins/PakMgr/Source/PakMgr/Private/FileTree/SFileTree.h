@@ -13,10 +13,18 @@
 #include "Models/IFileInfo.h"
 #include "Models/FileItemInfo.h"
 #include "Models/IPFileManager.h"
+#include "Models/DependencyGraph.h"
+#include "Models/FileItemSorter.h"
+#include "Models/FileTreeFilter.h"
+#include "Models/LogStore.h"
+#include "Models/LogTableModel.h"
+#include "Models/LogIngestQueue.h"
+#include "Models/LogSaver.h"
 //#include "Console/SFileTreeShortcutWindow.h"
 //#include "Console/SFileTreeFilterBar.h"
 
 class FUICommandList;
+struct FFileTreeSearchTask;
 class SFileTreeCommandBar;
 class SFileTreeFilterBar;
 class SFileTreeShortcutWindow;
@@ -78,12 +86,65 @@ protected:
 	void ReloadLog(bool FullyReload);
 
 	/**
-	 * Saves all log messages to a file.
+	 * Refills the log store with the messages of the selected engine instances only, and restarts the filter bar's counters.
+	 *
+	 * Rows added by an earlier GenRef are dropped.
+	 */
+	void ReloadLogStore();
+
+	/**
+	 * Saves the listed log messages to a file, on a worker thread.
 	 *
 	 * @see ClearLog, CopyLog, ReloadLog
 	 */
 	void SaveLog();
 
+	/** Updates the filter bar's counters with the messages added since the last call. */
+	void CountNewLogs();
+
+	/**
+	 * Moves received messages from the ingestion queue into the log store and lists those passing the filter.
+	 *
+	 * Called once per frame, so a burst of messages only refreshes the list once.
+	 */
+	void IngestLogs();
+
+	/**
+	 * Filters messages with the active filter, in parallel.
+	 *
+	 * @param Messages The messages to filter.
+	 * @param OutMessages Will hold the messages passing the filter, in order. May be Messages itself.
+	 */
+	void FilterLogMessages(const TArray<FPakMgrLogHandle>& Messages, TArray<FPakMgrLogHandle>& OutMessages) const;
+
+	/** Gets the store holding the listed items, i.e. the search results in search mode and the log otherwise. */
+	const TSharedPtr<FPakMgrLogStore>& GetListedStore() const
+	{
+		return bSearchMode ? SearchResults : LogStore;
+	}
+
+	/** Removes listed items the store dropped to stay within its memory limit. */
+	void RemoveEvictedLogs();
+
+	/** Sorts the listed items by the current sort key, if sorting is enabled. */
+	void SortLog();
+
+	/**
+	 * Searches all package and object paths for the filter text, replacing the list with the results.
+	 *
+	 * The search runs on a worker thread and its results are added to the list as they arrive.
+	 *
+	 * @see CancelSearch
+	 */
+	void StartSearch();
+
+	/**
+	 * Stops a running search, results found so far stay in the list.
+	 *
+	 * @see StartSearch
+	 */
+	void CancelSearch();
+
 	/**
 	 * Sends the command entered into the input field.
 	 *
@@ -96,6 +157,7 @@ protected:
 	// SCompoundWidget overrides
 
 	virtual FReply OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent) override;
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
 
 private:
 
@@ -119,9 +181,11 @@ private:
 
 	void HandleSortActionExecute();
 	bool HandleSortActionCanExecute();
+	bool HandleSortActionIsChecked() const;
 
 	void HandleSearchActionExecute();
 	bool HandleSearchActionCanExecute();
+	bool HandleSearchActionIsChecked() const;
 
 	/** Callback for promoting console command to shortcuts. */
 	void HandleCommandBarPromoteToShortcutClicked(const FString& CommandString);
@@ -133,16 +197,22 @@ private:
 	void HandleFilterChanged();
 
 	/** Callback for scrolling a log item into view. */
-	void HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> Item, const TSharedPtr<ITableRow>& TableRow);
+	void HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow);
 
 	/** Callback for generating a row widget for the log list view. */
-	TSharedRef<ITableRow> HandleLogListGenerateRow(TSharedPtr<FFileItemInfo> Message, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> HandleLogListGenerateRow(FPakMgrLogHandle Message, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Callback for a row widget scrolling out of the log list view. */
+	void HandleLogListRowReleased(const TSharedRef<ITableRow>& TableRow);
 
 	/** Callback for getting the highlight string for log messages. */
 	FText HandleLogListGetHighlightText() const;
 
 	/** Callback for selecting log messages. */
-	void HandleLogListSelectionChanged(TSharedPtr<FFileItemInfo> InItem, ESelectInfo::Type SelectInfo);
+	void HandleLogListSelectionChanged(FPakMgrLogHandle InItem, ESelectInfo::Type SelectInfo);
+
+	/** Callback for draining the ingestion queue, also while the panel is hidden. */
+	bool HandleIngestTicker(float DeltaTime);
 
 	/** Callback for getting the enabled state of the console box. */
 	bool HandleMainContentIsEnabled() const;
@@ -161,8 +231,14 @@ private:
 
 private:
 
-	/** Holds an unfiltered list of available log messages. */
-	TArray<TSharedPtr<FFileItemInfo>> AvailableLogs;
+	/** Holds all available log messages and listed packages, filtered or not. */
+	TSharedPtr<FPakMgrLogStore> LogStore;
+
+	/** Holds received messages that were not added to the log store yet. */
+	TSharedPtr<FPakMgrLogIngestQueue, ESPMode::ThreadSafe> IngestQueue;
+
+	/** Holds the handle of the ticker draining IngestQueue. */
+	FDelegateHandle IngestTickerHandle;
 
 	/** Holds the command bar. */
 	TSharedPtr<SFileTreeCommandBar> CommandBar;
@@ -170,20 +246,47 @@ private:
 	/** Holds the filter bar. */
 	TSharedPtr<SFileTreeFilterBar> FilterBar;
 
+	/** Holds the filter the listed messages passed. */
+	FFileTreeFilter ActiveFilter;
+
+	/** Holds the first available message the filter bar has not counted yet. */
+	FPakMgrLogHandle NextCountedLog;
+
 	/** Holds the find bar. */
 	TSharedPtr<SSearchBox> FindBar;
 
 	/** Holds the highlight text. */
 	FString HighlightText;
 
-	/** Holds the directory where the log file was last saved to. */
-	FString LastLogFileSaveDirectory;
+	/** Holds the helper saving the log to a file. */
+	TSharedPtr<FPakMgrLogSaver> LogSaver;
 
 	/** Holds the log list view. */
- 	TSharedPtr<SListView<TSharedPtr<FFileItemInfo>>> LogListView;
+ 	TSharedPtr<SListView<FPakMgrLogHandle>> LogListView;
+
+	/** Holds the table model of the log list view. */
+	TSharedPtr<FPakMgrLogTableModel> LogTableModel;
+
+ 	/** Holds the filtered list of log messages, in the listed store. */
+ 	TArray<FPakMgrLogHandle> LogMessages;
+
+	/** Holds the graph snapshot the listed packages were generated from. */
+	FPakMgrDependencyGraphPtr ReferenceGraph;
+
+	/** Holds the key the list is sorted by, valid if bSortEnabled is set. */
+	EPakMgrFileSortKey SortKey;
+
+	/** Holds a flag indicating whether the list is sorted. */
+	bool bSortEnabled;
+
+	/** Holds the running search, if any. */
+	TSharedPtr<FFileTreeSearchTask, ESPMode::ThreadSafe> SearchTask;
+
+	/** Holds the paths found by the last search. */
+	TSharedPtr<FPakMgrLogStore> SearchResults;
 
- 	/** Holds the filtered list of log messages. */
- 	TArray<TSharedPtr<FFileItemInfo>> LogMessages;
+	/** Holds a flag indicating whether the list shows path search results instead of log messages. */
+	bool bSearchMode;
 
 	/** Holds the session manager. */
 	TSharedPtr<IPFileManager> SessionManager;
@@ -107,34 +107,28 @@ void SFileTreeFilterBar::Construct(const FArguments& InArgs)
 END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
 
-bool SFileTreeFilterBar::FilterLogMessage(const TSharedRef<FFileItemInfo>& LogMessage)
+void SFileTreeFilterBar::CountLogMessage(FName Category, ELogVerbosity::Type Verbosity)
 {
 	// create or update category counter
-	int32& CategoryCounter = CategoryCounters.FindOrAdd(LogMessage->Category);
+	int32& CategoryCounter = CategoryCounters.FindOrAdd(Category);
 
 	if (CategoryCounter == 0)
 	{
-		AddCategoryFilter(LogMessage->Category);
+		AddCategoryFilter(Category);
 	}
 
 	++CategoryCounter;
 
 	// update the verbosity counter
-	++VerbosityCounters.FindOrAdd(LogMessage->Verbosity);
+	++VerbosityCounters.FindOrAdd(Verbosity);
+}
 
-	// filter the log message
-	if (DisabledCategories.Contains(LogMessage->Category) ||
-		DisabledVerbosities.Contains(LogMessage->Verbosity))
-	{
-		return false;
-	}
 
-	if (HighlightOnlyCheckBox->IsChecked() || FilterStringTextBox->GetText().IsEmpty())
-	{
-		return true;
-	}
+bool SFileTreeFilterBar::FilterLogMessage(const TSharedRef<FFileItemInfo>& LogMessage)
+{
+	CountLogMessage(LogMessage->Category, LogMessage->Verbosity);
 
-	return (LogMessage->Text.Contains(FilterStringTextBox->GetText().ToString()));
+	return Filter.PassesFilter(*LogMessage);
 }
 
 
@@ -174,6 +168,23 @@ void SFileTreeFilterBar::AddVerbosityFilter(ELogVerbosity::Type Verbosity, const
 }
 
 
+void SFileTreeFilterBar::UpdateFilter()
+{
+	// the widgets are only asked once per change instead of once per message
+	Filter.Text = FilterStringTextBox->GetText().ToString();
+	Filter.bHighlightOnly = HighlightOnlyCheckBox->IsChecked();
+	Filter.DisabledCategories = TSet<FName>(DisabledCategories);
+	Filter.DisabledVerbosities = 0;
+
+	for (ELogVerbosity::Type Verbosity : DisabledVerbosities)
+	{
+		Filter.DisabledVerbosities |= FFileTreeFilter::GetVerbosityBit(Verbosity);
+	}
+
+	OnFilterChanged.ExecuteIfBound();
+}
+
+
 /* SSessionConsoleFilterBar callbacks
  *****************************************************************************/
 
@@ -210,19 +221,19 @@ void SFileTreeFilterBar::HandleCategoryFilterStateChanged(const FName& Category,
 		DisabledCategories.AddUnique(Category);
 	}
 
-	OnFilterChanged.ExecuteIfBound();
+	UpdateFilter();
 }
 
 
 void SFileTreeFilterBar::HandleFilterStringTextChanged(const FText& NewText)
 {
-	OnFilterChanged.ExecuteIfBound();
+	UpdateFilter();
 }
 
 
 void SFileTreeFilterBar::HandleHighlightOnlyCheckBoxCheckStateChanged(ECheckBoxState CheckedState)
 {
-	OnFilterChanged.ExecuteIfBound();
+	UpdateFilter();
 }
 
 
@@ -277,7 +288,7 @@ void SFileTreeFilterBar::HandleVerbosityFilterStateChanged(ELogVerbosity::Type V
 		DisabledVerbosities.AddUnique(Verbosity);
 	}
 
-	OnFilterChanged.ExecuteIfBound();
+	UpdateFilter();
 }
 
 FText SFileTreeFilterBar::GetFilterText() const
@@ -10,6 +10,7 @@
 #include "Models/FileItemInfo.h"
 #include "Models/ContentConsoleCategoryFilter.h"
 #include "Models/ContentConsoleVerbosityFilter.h"
+#include "Models/FileTreeFilter.h"
 
 class SCheckBox;
 
@@ -45,6 +46,25 @@ public:
 	 */
 	bool FilterLogMessage(const TSharedRef<FFileItemInfo>& LogMessage);
 
+	/**
+	 * Updates the category and verbosity counters with a message, without filtering it.
+	 *
+	 * @param Category The message's log category.
+	 * @param Verbosity The message's verbosity.
+	 * @see ResetFilter
+	 */
+	void CountLogMessage(FName Category, ELogVerbosity::Type Verbosity);
+
+	/**
+	 * Gets the compiled filter settings, which only change before OnFilterChanged is executed.
+	 *
+	 * @return The filter.
+	 */
+	const FFileTreeFilter& GetFilter() const
+	{
+		return Filter;
+	}
+
 	/**
 	 * Gets the current filter string.
 	 *
@@ -75,6 +95,9 @@ protected:
 	 */
 	void AddVerbosityFilter(ELogVerbosity::Type Verbosity, const FString& Name, const FName& Icon);
 
+	/** Compiles the current settings into Filter and notifies the owner. */
+	void UpdateFilter();
+
 private:
 
 	/** Callback for generating a row widget for the category filter list. */
@@ -118,6 +141,9 @@ private:
 	/** Holds the list of disabled log verbosities. */
 	TArray<ELogVerbosity::Type> DisabledVerbosities;
 
+	/** Holds the compiled filter settings. */
+	FFileTreeFilter Filter;
+
 	/** Holds the filter check box. */
 	TSharedPtr<SCheckBox> HighlightOnlyCheckBox;
 
@@ -12,26 +12,90 @@
 #include "Widgets/Layout/SBorder.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Views/STableRow.h"
-#include "Models/FileItemInfo.h"
+#include "Models/LogStore.h"
+#include "Models/LogTableModel.h"
+#include "Framework/Views/TableViewTypeTraits.h"
 #include "SlateOptMacros.h"
 #include "Widgets/Text/STextBlock.h"
 #include "EditorStyleSet.h"
 #include "Widgets/Views/SListView.h"
 #include "Widgets/Images/SImage.h"
+#include "Widgets/SToolTip.h"
 
 class Error;
 
+/** Lets list views hold log store handles. */
+template <>
+struct TIsValidListItem<FPakMgrLogHandle>
+{
+	enum
+	{
+		Value = true
+	};
+};
+
+/** Treats an unset log store handle as the null item. */
+template <>
+struct TListTypeTraits<FPakMgrLogHandle>
+{
+public:
+
+	typedef FPakMgrLogHandle NullableType;
+
+	using MapKeyFuncs = TDefaultMapHashableKeyFuncs<FPakMgrLogHandle, TSharedRef<ITableRow>, false>;
+	using MapKeyFuncsSparse = TDefaultMapHashableKeyFuncs<FPakMgrLogHandle, FSparseItemInfo, false>;
+	using SetKeyFuncs = DefaultKeyFuncs<FPakMgrLogHandle>;
+
+	static void AddReferencedObjects(FReferenceCollector&, TArray<FPakMgrLogHandle>&, TSet<FPakMgrLogHandle>&) { }
+
+	template <typename U>
+	static void AddReferencedObjects(FReferenceCollector&, TArray<FPakMgrLogHandle>&, TSet<FPakMgrLogHandle>&, TMap<const U*, FPakMgrLogHandle>&) { }
+
+	static bool IsPtrValid(const FPakMgrLogHandle& Handle)
+	{
+		return Handle.IsSet();
+	}
+
+	static void ResetPtr(FPakMgrLogHandle& Handle)
+	{
+		Handle = FPakMgrLogHandle();
+	}
+
+	static FPakMgrLogHandle MakeNullPtr()
+	{
+		return FPakMgrLogHandle();
+	}
+
+	static FPakMgrLogHandle NullableItemTypeConvertToItemType(const FPakMgrLogHandle& Handle)
+	{
+		return Handle;
+	}
+
+	static FString DebugDump(FPakMgrLogHandle Handle)
+	{
+		return Handle.IsSet() ? FString::Printf(TEXT("%llu"), Handle.Sequence) : FString(TEXT("nullptr"));
+	}
+
+	class SerializerType { };
+};
+
 /**
- * Implements a row widget for the session console log.
+ * Implements a row widget for the PakMgr list views.
+ *
+ * Rows are recycled by FPakMgrLogTableModel: a row is bound to a message when it is made and
+ * again whenever it is reused for another one. The cell texts are taken from the model on
+ * binding, so the row stays intact if the store drops the message while it is on screen, and
+ * the tool tip is only made once the row is hovered.
  */
 class SFileTreeitemTableRow
-	: public SMultiColumnTableRow<TSharedPtr<FFileItemInfo>>
+	: public SMultiColumnTableRow<FPakMgrLogHandle>
 {
 public:
 
 	SLATE_BEGIN_ARGS(SFileTreeitemTableRow) { }
 		SLATE_ATTRIBUTE(FText, HighlightText)
-		SLATE_ARGUMENT(TSharedPtr<FFileItemInfo>, FileItemInfo)
+		SLATE_ARGUMENT(TSharedPtr<FPakMgrLogTableModel>, Model)
+		SLATE_ARGUMENT(FPakMgrLogHandle, Handle)
 	SLATE_END_ARGS()
 
 public:
@@ -44,9 +108,41 @@ public:
 	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTableView)
 	{
 		HighlightText = InArgs._HighlightText;
-		FileItemInfo = InArgs._FileItemInfo;
+		Model = InArgs._Model;
+		InstanceColor = FLinearColor::White;
+		Verbosity = ELogVerbosity::Log;
 
-		SMultiColumnTableRow<TSharedPtr<FFileItemInfo>>::Construct(FSuperRowType::FArguments(), InOwnerTableView);
+		SetHandle(InArgs._Handle);
+
+		SMultiColumnTableRow<FPakMgrLogHandle>::Construct(FSuperRowType::FArguments(), InOwnerTableView);
+	}
+
+	/**
+	 * Binds the row to a message.
+	 *
+	 * @param InHandle The message to show.
+	 */
+	void SetHandle(FPakMgrLogHandle InHandle)
+	{
+		TSharedPtr<FPakMgrLogTableModel> PinnedModel = Model.Pin();
+
+		Handle = InHandle;
+		bToolTipTextValid = false;
+
+		if (!PinnedModel.IsValid())
+		{
+			return;
+		}
+
+		const FPakMgrLogStore& Store = *PinnedModel->GetStore();
+
+		Verbosity = Store.Contains(Handle) ? Store.GetVerbosity(Handle) : ELogVerbosity::Log;
+		InstanceColor = PinnedModel->GetInstanceColor(Handle);
+
+		for (int32 CellIndex = 0; CellIndex < CellColumns.Num(); ++CellIndex)
+		{
+			CellTexts[CellIndex] = PinnedModel->GetCellText(Handle, CellColumns[CellIndex]);
+		}
 	}
 
 public:
@@ -71,48 +167,44 @@ public:
 						[
 							SNew(STextBlock)
 								//.Font(FEditorStyle::GetFontStyle("BoldFont"))
-								.Text(FText::FromString(FileItemInfo->InstanceName))
+								.Text(this, &SFileTreeitemTableRow::HandleGetCellText, AddCell(ColumnName))
 						]
 				];
 		}
-		else if (ColumnName == "Message")
+		else if ((ColumnName == "Message") || (ColumnName == "Name"))
 		{
 			return SNew(SBox)
 				.Padding(FMargin(4.0f, 0.0f))
 				.VAlign(VAlign_Center)
 				[
 					SNew(STextBlock)
-						.ColorAndOpacity(HandleGetTextColor())
+						.ColorAndOpacity(this, &SFileTreeitemTableRow::HandleGetTextColor)
 						.HighlightText(HighlightText)
-						.Text(FText::FromString(FileItemInfo->Text.Replace(TEXT("\n"), TEXT(" | ")).Replace(TEXT("\r"), TEXT(""))))
+						.Text(this, &SFileTreeitemTableRow::HandleGetCellText, AddCell(ColumnName))
 				];
 		}
 		else if (ColumnName == "TimeSeconds")
 		{
-			static const FNumberFormattingOptions FormatOptions = FNumberFormattingOptions()
-				.SetMinimumFractionalDigits(3)
-				.SetMaximumFractionalDigits(3);
-
 			return SNew(SBox)
 				.HAlign(HAlign_Right)
 				.VAlign(VAlign_Center)
 				.Padding(FMargin(0.0f, 0.0f, 8.0f, 0.0f))
 				[
 					SNew(STextBlock)
-						.ColorAndOpacity(HandleGetTextColor())
-						.Text(FText::AsNumber(FileItemInfo->TimeSeconds, &FormatOptions))
+						.ColorAndOpacity(this, &SFileTreeitemTableRow::HandleGetTextColor)
+						.Text(this, &SFileTreeitemTableRow::HandleGetCellText, AddCell(ColumnName))
 				];
 		}
 		else if (ColumnName == "Verbosity")
 		{
-			const FSlateBrush* Icon;
+			const FSlateBrush* Icon = nullptr;
 
-			if ((FileItemInfo->Verbosity == ELogVerbosity::Error) ||
-				(FileItemInfo->Verbosity == ELogVerbosity::Fatal))
+			if ((Verbosity == ELogVerbosity::Error) ||
+				(Verbosity == ELogVerbosity::Fatal))
 			{
 				//Icon = FEditorStyle::GetBrush("Icons.Error");
 			}
-			else if (FileItemInfo->Verbosity == ELogVerbosity::Warning)
+			else if (Verbosity == ELogVerbosity::Warning)
 			{
 				//Icon = FEditorStyle::GetBrush("Icons.Warning");
 			}
@@ -134,30 +226,70 @@ public:
 	}
 	END_SLATE_FUNCTION_BUILD_OPTIMIZATION
 
+public:
+
+	// SWidget overrides
+
+	virtual TSharedPtr<IToolTip> GetToolTip() override
+	{
+		// only rows under the cursor are asked for a tool tip
+		if (!ToolTip.IsValid())
+		{
+			ToolTip = SNew(SToolTip)
+				.Text(this, &SFileTreeitemTableRow::HandleGetToolTipText);
+		}
+
+		if (!bToolTipTextValid)
+		{
+			TSharedPtr<FPakMgrLogTableModel> PinnedModel = Model.Pin();
+
+			ToolTipText = PinnedModel.IsValid() ? PinnedModel->GetToolTipText(Handle) : FText::GetEmpty();
+			bToolTipTextValid = true;
+		}
+
+		return ToolTip;
+	}
+
 private:
 
+	/** Adds a column whose text the row caches, returns its cell index. */
+	int32 AddCell(const FName& ColumnName)
+	{
+		int32 CellIndex = CellColumns.Find(ColumnName);
+
+		if (CellIndex == INDEX_NONE)
+		{
+			TSharedPtr<FPakMgrLogTableModel> PinnedModel = Model.Pin();
+
+			CellIndex = CellColumns.Add(ColumnName);
+			CellTexts.Add(PinnedModel.IsValid() ? PinnedModel->GetCellText(Handle, ColumnName) : FText::GetEmpty());
+		}
+
+		return CellIndex;
+	}
+
 	/** Gets the border color for this row. */
 	FSlateColor HandleGetBorderColor() const
 	{
-		return FLinearColor((GetTypeHash(FileItemInfo->InstanceId) & 0xff) * 360.0f / 256.0f, 0.8f, 0.3f, 1.0f).HSVToLinearRGB();
+		return InstanceColor;
+	}
+
+	/** Gets the cached text of a cell. */
+	FText HandleGetCellText(int32 CellIndex) const
+	{
+		return CellTexts[CellIndex];
 	}
 
 	/** Gets the text color for this log entry. */
 	FSlateColor HandleGetTextColor() const
 	{
-		if ((FileItemInfo->Verbosity == ELogVerbosity::Error) ||
-			(FileItemInfo->Verbosity == ELogVerbosity::Fatal))
-		{
-			return FLinearColor::Red;
-		}
-		else if (FileItemInfo->Verbosity == ELogVerbosity::Warning)
-		{
-			return FLinearColor::Yellow;
-		}
-		else
-		{
-			return FSlateColor::UseForeground();
-		}
+		return FPakMgrLogTableModel::GetVerbosityColor(Verbosity);
+	}
+
+	/** Gets the tool tip text, made when the tool tip is first asked for. */
+	FText HandleGetToolTipText() const
+	{
+		return ToolTipText;
 	}
 
 private:
@@ -165,6 +297,30 @@ private:
 	/** Holds the highlight string for the log message. */
 	TAttribute<FText> HighlightText;
 
-	/** Holds a reference to the log message that is displayed in this row. */
-	TSharedPtr<FFileItemInfo> FileItemInfo;
+	/** Holds the model that made the row. */
+	TWeakPtr<FPakMgrLogTableModel> Model;
+
+	/** Holds the message shown in the row. */
+	FPakMgrLogHandle Handle;
+
+	/** Holds the columns whose texts are cached. */
+	TArray<FName> CellColumns;
+
+	/** Holds the cached texts, one per cached column. */
+	TArray<FText> CellTexts;
+
+	/** Holds the color of the message's instance. */
+	FLinearColor InstanceColor;
+
+	/** Holds the verbosity type. */
+	ELogVerbosity::Type Verbosity;
+
+	/** Holds the tool tip, made when the row is first hovered. */
+	TSharedPtr<SToolTip> ToolTip;
+
+	/** Holds the tool tip text of the message shown. */
+	FText ToolTipText;
+
+	/** Holds a flag indicating whether the tool tip text belongs to the message shown. */
+	bool bToolTipTextValid;
 };
@@ -0,0 +1,325 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/CookedRegistryReader.h"
+#include "AssetData.h"
+#include "HAL/FileManager.h"
+#include "PakMgrModule.h"
+#include "Serialization/ArchiveProxy.h"
+#include "UObject/ObjectRedirector.h"
+#include "PakMgrTrace.h"
+
+
+namespace CookedRegistryReader
+{
+	/** Identifies versioned registry files, see FAssetRegistryVersion. */
+	static const FGuid VersionGuid(0x717F9EE7, 0xE9B0493A, 0x88B39132, 0x1B388107);
+
+	/** Registry versions the reader distinguishes, see FAssetRegistryVersion. */
+	enum EVersion
+	{
+		RemovedMD5Hash = 4,
+		AddedHardManage = 5,
+		AddedCookedMD5Hash = 6
+	};
+
+	/** Resolves the name indices of a registry file through its name table. */
+	class FNameTableReader
+		: public FArchiveProxy
+	{
+	public:
+
+		FNameTableReader(FArchive& InInnerArchive)
+			: FArchiveProxy(InInnerArchive)
+		{ }
+
+		/** Reads the name table, which the writer appends to the end of the file. */
+		bool ReadNameTable()
+		{
+			int64 NameOffset = 0;
+			*this << NameOffset;
+
+			if (HasError() || (NameOffset <= 0) || (NameOffset > TotalSize()))
+			{
+				return false;
+			}
+
+			const int64 DataOffset = Tell();
+			Seek(NameOffset);
+
+			int32 NameCount = 0;
+			*this << NameCount;
+
+			if (HasError() || (NameCount < 0))
+			{
+				return false;
+			}
+
+			Names.Reserve(FMath::Min<int64>(NameCount, (TotalSize() - Tell()) / sizeof(int32)));
+
+			for (int32 NameIndex = 0; NameIndex < NameCount; ++NameIndex)
+			{
+				FNameEntrySerialized NameEntry(ENAME_LinkerConstructor);
+				*this << NameEntry;
+
+				if (HasError())
+				{
+					return false;
+				}
+
+				Names.Add(FName(NameEntry));
+			}
+
+			Seek(DataOffset);
+
+			return !HasError();
+		}
+
+		/** Returns true if this archive or the file it reads failed, errors of the file are not forwarded. */
+		bool HasError() const
+		{
+			return IsError() || InnerArchive.IsError();
+		}
+
+		//~ FArchive interface
+
+		virtual FArchive& operator<<(FName& Name) override
+		{
+			int32 NameIndex = 0;
+			int32 Number = 0;
+			*this << NameIndex << Number;
+
+			if (Names.IsValidIndex(NameIndex))
+			{
+				Name = FName(Names[NameIndex], Number);
+			}
+			else
+			{
+				Name = NAME_None;
+				SetError();
+			}
+
+			return *this;
+		}
+
+	private:
+
+		TArray<FName> Names;
+	};
+
+	/** Reads a count and checks it against the remaining file size. */
+	bool ReadCount(FNameTableReader& Ar, int32& OutCount, int32 MinElementSize)
+	{
+		Ar << OutCount;
+
+		return !Ar.HasError() && (OutCount >= 0) && ((int64)OutCount * MinElementSize <= Ar.TotalSize() - Ar.Tell());
+	}
+}
+
+
+/* FPakMgrCookedRegistryReader interface
+ *****************************************************************************/
+
+FPakMgrDependencyGraphPtr FPakMgrCookedRegistryReader::Load(const FString& Filename)
+{
+	PAKMGR_TRACE_SCOPE_TEXT(ReadCookedRegistry, Filename);
+
+	using namespace CookedRegistryReader;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// a buffered reader keeps the memory use independent of the file size
+	TUniquePtr<FArchive> FileReader(IFileManager::Get().CreateFileReader(*Filename, FILEREAD_Silent));
+
+	if (!FileReader.IsValid())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to open the asset registry %s"), *Filename);
+
+		return nullptr;
+	}
+
+	FGuid Guid;
+	int32 Version = 0;
+	*FileReader << Guid;
+
+	if (Guid == VersionGuid)
+	{
+		*FileReader << Version;
+	}
+
+	if ((Version < RemovedMD5Hash) || (Version > AddedCookedMD5Hash))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s has unsupported version %d"), *Filename, Version);
+
+		return nullptr;
+	}
+
+	FNameTableReader Ar(*FileReader);
+
+	if (!Ar.ReadNameTable())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s has a corrupt name table"), *Filename);
+
+		return nullptr;
+	}
+
+	// assets, only redirector packages are of interest
+	const FName RedirectorClassName = UObjectRedirector::StaticClass()->GetFName();
+	TSet<FName> RedirectorPackages;
+	int32 NumAssets = 0;
+
+	if (!ReadCount(Ar, NumAssets, 5 * 2 * sizeof(int32)))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s is corrupt"), *Filename);
+
+		return nullptr;
+	}
+
+	for (int32 AssetIndex = 0; AssetIndex < NumAssets && !Ar.HasError(); ++AssetIndex)
+	{
+		FAssetData AssetData;
+		AssetData.SerializeForCache(Ar);
+
+		if (AssetData.AssetClass == RedirectorClassName)
+		{
+			RedirectorPackages.Add(AssetData.PackageName);
+		}
+	}
+
+	// depends nodes, package edges are kept as pairs of node indices until all nodes are known
+	TArray<FName> NodePackageNames;
+	TArray<TPair<int32, int32>> Edges[2];
+	int32 NumDependsNodes = 0;
+
+	if (!ReadCount(Ar, NumDependsNodes, sizeof(uint8) + 4 * sizeof(int32)))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s is corrupt"), *Filename);
+
+		return nullptr;
+	}
+
+	NodePackageNames.Reserve(NumDependsNodes);
+
+	for (int32 NodeIndex = 0; NodeIndex < NumDependsNodes && !Ar.HasError(); ++NodeIndex)
+	{
+		FAssetIdentifier Identifier;
+		Ar << Identifier;
+
+		NodePackageNames.Add(Identifier.IsPackage() ? Identifier.PackageName : NAME_None);
+
+		int32 NumHard = 0;
+		int32 NumSoft = 0;
+		int32 NumSearchableNames = 0;
+		int32 NumSoftManage = 0;
+		int32 NumHardManage = 0;
+		int32 NumReferencers = 0;
+
+		Ar << NumHard << NumSoft << NumSearchableNames;
+
+		if (Version >= AddedHardManage)
+		{
+			Ar << NumSoftManage << NumHardManage;
+		}
+
+		Ar << NumReferencers;
+
+		// summed in 64 bit, corrupt counts must not wrap around before the size check
+		const int64 NumIndices = (int64)NumHard + NumSoft + NumSearchableNames + NumSoftManage + NumHardManage + NumReferencers;
+
+		if (Ar.HasError() || (NumHard | NumSoft | NumSearchableNames | NumSoftManage | NumHardManage | NumReferencers) < 0 || (NumIndices * (int64)sizeof(int32) > Ar.TotalSize() - Ar.Tell()))
+		{
+			// the package data would be read from the wrong offset otherwise
+			Ar.SetError();
+			break;
+		}
+
+		// hard and soft dependencies come first, referencers are the reverse of those and not needed
+		for (int64 Index = 0; Index < NumIndices; ++Index)
+		{
+			int32 Target = 0;
+			Ar << Target;
+
+			if ((Target < 0) || (Target >= NumDependsNodes))
+			{
+				Ar.SetError();
+				break;
+			}
+
+			if (Index < NumHard)
+			{
+				Edges[0].Emplace(NodeIndex, Target);
+			}
+			else if (Index < (int64)NumHard + NumSoft)
+			{
+				Edges[1].Emplace(NodeIndex, Target);
+			}
+		}
+	}
+
+	// package data, the cook's actual content
+	TMap<FName, FAssetPackageData> PackageData;
+	int32 NumPackageData = 0;
+
+	if (Ar.HasError() || !ReadCount(Ar, NumPackageData, 2 * sizeof(int32) + sizeof(int64) + sizeof(FGuid)))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s is corrupt"), *Filename);
+
+		return nullptr;
+	}
+
+	PackageData.Reserve(NumPackageData);
+
+	for (int32 PackageIndex = 0; PackageIndex < NumPackageData && !Ar.HasError(); ++PackageIndex)
+	{
+		FName PackageName;
+		Ar << PackageName;
+
+		FAssetPackageData& Data = PackageData.Add(PackageName);
+		Ar << Data.DiskSize;
+		Ar << Data.PackageGuid;
+
+		if (Version >= AddedCookedMD5Hash)
+		{
+			Ar << Data.CookedHash;
+		}
+	}
+
+	if (Ar.HasError())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Asset registry %s is corrupt"), *Filename);
+
+		return nullptr;
+	}
+
+	// same rules as FPakMgrDependencyGraph::CreateFromRegistryState: only packages with package data have edges
+	FPakMgrDependencyGraph::FBuilder Builder;
+
+	for (const TPair<FName, FAssetPackageData>& Pair : PackageData)
+	{
+		const int32 Node = Builder.FindOrAddNode(Pair.Key);
+		Builder.SetPackageData(Node, Pair.Value.DiskSize, RedirectorPackages.Contains(Pair.Key), FPakMgrDependencyGraph::ComputePackageStamp(Pair.Value));
+	}
+
+	static const EPakMgrDependencyKind Kinds[] = { EPakMgrDependencyKind::Hard, EPakMgrDependencyKind::Soft };
+
+	for (int32 KindIndex = 0; KindIndex < ARRAY_COUNT(Kinds); ++KindIndex)
+	{
+		for (const TPair<int32, int32>& Edge : Edges[KindIndex])
+		{
+			const FName FromPackage = NodePackageNames[Edge.Key];
+			const FName ToPackage = NodePackageNames[Edge.Value];
+
+			if (FromPackage.IsNone() || ToPackage.IsNone() || !PackageData.Contains(FromPackage))
+			{
+				continue;
+			}
+
+			Builder.AddEdge(Builder.FindOrAddNode(FromPackage), Builder.FindOrAddNode(ToPackage), Kinds[KindIndex]);
+		}
+	}
+
+	FPakMgrDependencyGraphPtr Graph = Builder.Build();
+
+	UE_LOG(LogPakMgr, Log, TEXT("Read asset registry %s with %d assets, %d packages and %d edges in %.2f seconds"), *Filename, NumAssets, Graph->Num(), Graph->NumEdges(), FPlatformTime::Seconds() - StartTime);
+
+	return Graph;
+}
@@ -0,0 +1,30 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+
+/**
+ * Streams a cooked AssetRegistry.bin into a dependency graph snapshot.
+ *
+ * Loading the file into an FAssetRegistryState keeps every asset with all of its tags in memory,
+ * which is well over a gigabyte for large cooks. This reader walks the file through a buffered
+ * archive instead and keeps only what the snapshot needs: package names, package edges, disk
+ * sizes, package guids and redirector flags. Assets, tags and non-package dependencies are read
+ * one at a time and dropped.
+ *
+ * Supports the registry layout written by this engine version (up to AddedCookedMD5Hash).
+ */
+class FPakMgrCookedRegistryReader
+{
+public:
+
+	/**
+	 * Reads a cooked asset registry.
+	 *
+	 * @param Filename The AssetRegistry.bin, or DevelopmentAssetRegistry.bin, of a cook.
+	 * @return The graph, or null if the file could not be read.
+	 */
+	static FPakMgrDependencyGraphPtr Load(const FString& Filename);
+};
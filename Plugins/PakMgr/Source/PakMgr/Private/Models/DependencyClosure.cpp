@@ -0,0 +1,137 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/DependencyClosure.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformAtomics.h"
+#include "Misc/ScopeLock.h"
+#include "PakMgrTrace.h"
+
+
+namespace DependencyClosure
+{
+	/** Number of frontier items a single task processes. */
+	const int32 ItemsPerChunk = 256;
+
+	/** A frontier entry: a node reached while expanding one of the roots. */
+	struct FWorkItem
+	{
+		int32 Closure;
+		int32 Node;
+
+		bool operator<(const FWorkItem& Other) const
+		{
+			return (Closure != Other.Closure) ? (Closure < Other.Closure) : (Node < Other.Node);
+		}
+	};
+
+	/** Atomically sets a bit, returns true if this call changed it. */
+	bool TestAndSetBit(int64* Words, int32 Bit)
+	{
+		volatile int64* Word = &Words[Bit >> 6];
+		const int64 Mask = (int64)1 << (Bit & 63);
+		int64 Expected = *Word;
+
+		while ((Expected & Mask) == 0)
+		{
+			const int64 Previous = FPlatformAtomics::InterlockedCompareExchange(Word, Expected | Mask, Expected);
+
+			if (Previous == Expected)
+			{
+				return true;
+			}
+
+			Expected = Previous;
+		}
+
+		return false;
+	}
+}
+
+
+/* FPakMgrDependencyClosure interface
+ *****************************************************************************/
+
+void FPakMgrDependencyClosure::ComputeParallel(const FPakMgrDependencyGraph& Graph, const TArray<int32>& Roots, bool bIncludeSoft, TArray<FPakMgrDependencyClosure>& OutClosures)
+{
+	PAKMGR_TRACE_SCOPE(ComputeClosures);
+
+	using namespace DependencyClosure;
+
+	const int32 NumWords = (Graph.Num() + 63) / 64;
+
+	// one visited bitset per root, laid out back to back
+	TArray<int64> Visited;
+	Visited.SetNumZeroed(NumWords * Roots.Num());
+
+	TArray<FWorkItem> Frontier;
+	TArray<FWorkItem> NextFrontier;
+
+	OutClosures.Reset(Roots.Num());
+
+	for (int32 ClosureIndex = 0; ClosureIndex < Roots.Num(); ++ClosureIndex)
+	{
+		const int32 Root = Roots[ClosureIndex];
+		FPakMgrDependencyClosure& Closure = OutClosures.AddDefaulted_GetRef();
+		Closure.Root = Root;
+		Closure.Nodes.Add(Root);
+		Closure.Depths.Add(0);
+
+		TestAndSetBit(Visited.GetData() + ClosureIndex * NumWords, Root);
+		Frontier.Add({ ClosureIndex, Root });
+	}
+
+	FCriticalSection NextFrontierLock;
+
+	for (int32 Depth = 1; Frontier.Num() > 0; ++Depth)
+	{
+		const int32 NumChunks = FMath::DivideAndRoundUp(Frontier.Num(), ItemsPerChunk);
+
+		ParallelFor(NumChunks, [&](int32 ChunkIndex)
+		{
+			const int32 First = ChunkIndex * ItemsPerChunk;
+			const int32 Last = FMath::Min(First + ItemsPerChunk, Frontier.Num());
+			TArray<FWorkItem> Discovered;
+
+			for (int32 ItemIndex = First; ItemIndex < Last; ++ItemIndex)
+			{
+				const FWorkItem Item = Frontier[ItemIndex];
+				int64* ClosureVisited = Visited.GetData() + Item.Closure * NumWords;
+
+				auto Expand = [&](TArrayView<const int32> Dependencies)
+				{
+					for (int32 Dependency : Dependencies)
+					{
+						if (TestAndSetBit(ClosureVisited, Dependency))
+						{
+							Discovered.Add({ Item.Closure, Dependency });
+						}
+					}
+				};
+
+				Expand(Graph.GetDependencies(Item.Node, EPakMgrDependencyKind::Hard));
+
+				if (bIncludeSoft)
+				{
+					Expand(Graph.GetDependencies(Item.Node, EPakMgrDependencyKind::Soft));
+				}
+			}
+
+			if (Discovered.Num() > 0)
+			{
+				FScopeLock ScopeLock(&NextFrontierLock);
+				NextFrontier.Append(Discovered);
+			}
+		});
+
+		NextFrontier.Sort();
+
+		for (const FWorkItem& Item : NextFrontier)
+		{
+			OutClosures[Item.Closure].Nodes.Add(Item.Node);
+			OutClosures[Item.Closure].Depths.Add(Depth);
+		}
+
+		Swap(Frontier, NextFrontier);
+		NextFrontier.Reset();
+	}
+}
@@ -0,0 +1,49 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+
+/**
+ * Transitive dependency closure of a single root package.
+ */
+struct FPakMgrDependencyClosure
+{
+	/** Holds the root node. */
+	int32 Root;
+
+	/** Holds every node reachable from the root, in breadth-first order starting with the root itself. */
+	TArray<int32> Nodes;
+
+	/** Holds the breadth-first depth of each element in Nodes. */
+	TArray<int32> Depths;
+
+public:
+
+	/** Default constructor. */
+	FPakMgrDependencyClosure()
+		: Root(INDEX_NONE)
+	{ }
+
+public:
+
+	/**
+	 * Computes the closures of several roots at once.
+	 *
+	 * All roots are expanded together, level by level. Each level is split into chunks that are
+	 * processed on the task graph, and every root owns a visited bitset that the workers update
+	 * atomically, so no node is expanded twice for the same root. Each level is sorted before it is
+	 * appended, which keeps the result independent of thread scheduling.
+	 *
+	 * Levels are synchronized rather than letting workers steal nodes of deeper levels, since Nodes
+	 * and Depths must be in breadth-first order. ParallelFor already spreads the chunks of a level
+	 * over all workers, and a level only waits for its slowest chunk of ItemsPerChunk nodes.
+	 *
+	 * @param Graph The graph to traverse.
+	 * @param Roots The root nodes.
+	 * @param bIncludeSoft Whether to follow soft references in addition to hard ones.
+	 * @param OutClosures Will hold one closure per root, in the order of Roots.
+	 */
+	static void ComputeParallel(const FPakMgrDependencyGraph& Graph, const TArray<int32>& Roots, bool bIncludeSoft, TArray<FPakMgrDependencyClosure>& OutClosures);
+};
@@ -0,0 +1,243 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/DependencyGraph.h"
+#include "AssetRegistryState.h"
+#include "Hash/CityHash.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakMgrDependencyGraph::FBuilder interface
+ *****************************************************************************/
+
+int32 FPakMgrDependencyGraph::FBuilder::FindOrAddNode(FName PackageName)
+{
+	if (const int32* ExistingNode = NodeIds.Find(PackageName))
+	{
+		return *ExistingNode;
+	}
+
+	const int32 Node = PackageNames.Add(PackageName);
+	NodeIds.Add(PackageName, Node);
+	DiskSizes.Add(-1);
+	Redirectors.Add(false);
+	Stamps.Add(0);
+
+	return Node;
+}
+
+
+void FPakMgrDependencyGraph::FBuilder::SetPackageData(int32 Node, int64 DiskSize, bool bIsRedirector, uint64 Stamp)
+{
+	DiskSizes[Node] = DiskSize;
+	Redirectors[Node] = bIsRedirector;
+	Stamps[Node] = Stamp;
+}
+
+
+void FPakMgrDependencyGraph::FBuilder::AddEdge(int32 FromNode, int32 ToNode, EPakMgrDependencyKind Kind)
+{
+	(Kind == EPakMgrDependencyKind::Hard ? HardEdges : SoftEdges).Emplace(FromNode, ToNode);
+}
+
+
+TSharedRef<const FPakMgrDependencyGraph, ESPMode::ThreadSafe> FPakMgrDependencyGraph::FBuilder::Build()
+{
+	PAKMGR_TRACE_SCOPE(BuildDependencyGraphEdges);
+
+	TSharedRef<FPakMgrDependencyGraph, ESPMode::ThreadSafe> Graph = MakeShared<FPakMgrDependencyGraph, ESPMode::ThreadSafe>();
+	const int32 NumNodes = PackageNames.Num();
+
+	Graph->HardDependencies.Initialize(NumNodes, HardEdges, false);
+	Graph->SoftDependencies.Initialize(NumNodes, SoftEdges, false);
+	Graph->HardReferencers.Initialize(NumNodes, HardEdges, true);
+	Graph->SoftReferencers.Initialize(NumNodes, SoftEdges, true);
+
+	Graph->PackageNames = MoveTemp(PackageNames);
+	Graph->NodeIds = MoveTemp(NodeIds);
+	Graph->DiskSizes = MoveTemp(DiskSizes);
+	Graph->Redirectors = MoveTemp(Redirectors);
+	Graph->Stamps = MoveTemp(Stamps);
+
+	PackageNames.Reset();
+	NodeIds.Reset();
+	DiskSizes.Reset();
+	Redirectors.Empty();
+	Stamps.Reset();
+	HardEdges.Empty();
+	SoftEdges.Empty();
+
+	return Graph;
+}
+
+
+/* FPakMgrDependencyGraph interface
+ *****************************************************************************/
+
+TSharedRef<const FPakMgrDependencyGraph, ESPMode::ThreadSafe> FPakMgrDependencyGraph::CreateFromRegistryState(const FAssetRegistryState& State, bool bIsEditor, const FPakMgrDependencyGraph* PreviousGraph)
+{
+	PAKMGR_TRACE_SCOPE(CreateDependencyGraph);
+
+	FBuilder Builder;
+	TArray<FAssetIdentifier> Dependencies;
+	int32 NumReusedPackages = 0;
+
+	for (const auto& PackageDataPair : State.GetAssetPackageDataMap())
+	{
+		const FName PackageName = PackageDataPair.Key;
+		const int32 Node = Builder.FindOrAddNode(PackageName);
+
+		bool bIsRedirector = false;
+
+		for (const FAssetData* AssetData : State.GetAssetsByPackageName(PackageName))
+		{
+			if (AssetData->IsRedirector())
+			{
+				bIsRedirector = true;
+				break;
+			}
+		}
+
+		// in editor, no packages are filtered
+		const int64 DiskSize = PackageDataPair.Value->DiskSize;
+		const uint64 Stamp = ComputePackageStamp(*PackageDataPair.Value);
+		Builder.SetPackageData(Node, bIsEditor ? FMath::Max<int64>(DiskSize, 0) : DiskSize, bIsRedirector, Stamp);
+
+		static const EAssetRegistryDependencyType::Type KindFlags[] = { EAssetRegistryDependencyType::Hard, EAssetRegistryDependencyType::Soft };
+		static const EPakMgrDependencyKind Kinds[] = { EPakMgrDependencyKind::Hard, EPakMgrDependencyKind::Soft };
+
+		// unchanged packages have unchanged dependencies
+		const int32 PreviousNode = (PreviousGraph != nullptr && Stamp != 0) ? PreviousGraph->FindNode(PackageName) : INDEX_NONE;
+
+		if (PreviousNode != INDEX_NONE && PreviousGraph->GetPackageStamp(PreviousNode) == Stamp)
+		{
+			for (EPakMgrDependencyKind Kind : Kinds)
+			{
+				for (int32 PreviousDependency : PreviousGraph->GetDependencies(PreviousNode, Kind))
+				{
+					Builder.AddEdge(Node, Builder.FindOrAddNode(PreviousGraph->GetPackageName(PreviousDependency)), Kind);
+				}
+			}
+
+			++NumReusedPackages;
+
+			continue;
+		}
+
+		for (int32 KindIndex = 0; KindIndex < ARRAY_COUNT(Kinds); ++KindIndex)
+		{
+			Dependencies.Reset();
+			State.GetDependencies(FAssetIdentifier(PackageName), Dependencies, KindFlags[KindIndex]);
+
+			for (const FAssetIdentifier& Dependency : Dependencies)
+			{
+				if (Dependency.IsPackage())
+				{
+					Builder.AddEdge(Node, Builder.FindOrAddNode(Dependency.PackageName), Kinds[KindIndex]);
+				}
+			}
+		}
+	}
+
+	if (bIsEditor)
+	{
+		// packages without package data, i.e. native ones, are still valid in editor
+		for (int32 Node = 0; Node < Builder.Num(); ++Node)
+		{
+			if (Builder.GetDiskSize(Node) < 0)
+			{
+				Builder.SetPackageData(Node, 0, false);
+			}
+		}
+	}
+
+	if (PreviousGraph != nullptr)
+	{
+		UE_LOG(LogPakMgr, Verbose, TEXT("Reused the dependencies of %d of %d packages from the previous dependency graph"), NumReusedPackages, State.GetAssetPackageDataMap().Num());
+	}
+
+	return Builder.Build();
+}
+
+
+uint64 FPakMgrDependencyGraph::ComputePackageStamp(const FAssetPackageData& PackageData)
+{
+	if (!PackageData.PackageGuid.IsValid())
+	{
+		return 0;
+	}
+
+	struct FStampData
+	{
+		FGuid PackageGuid;
+		int64 DiskSize;
+	};
+
+	FStampData StampData;
+	FMemory::Memzero(StampData);
+	StampData.PackageGuid = PackageData.PackageGuid;
+	StampData.DiskSize = PackageData.DiskSize;
+
+	// zero is reserved for unknown stamps
+	return FMath::Max<uint64>(CityHash64((const char*)&StampData, sizeof(StampData)), 1);
+}
+
+
+bool FPakMgrDependencyGraph::AppendNeighbours(FName PackageName, EAssetRegistryDependencyType::Type SearchFlags, bool bReferencers, TArray<FAssetIdentifier>& OutIdentifiers) const
+{
+	const int32 Node = FindNode(PackageName);
+
+	if (Node == INDEX_NONE)
+	{
+		return false;
+	}
+
+	auto AppendNodes = [this, &OutIdentifiers](TArrayView<const int32> Nodes)
+	{
+		for (int32 Neighbour : Nodes)
+		{
+			OutIdentifiers.Emplace(PackageNames[Neighbour]);
+		}
+	};
+
+	if (SearchFlags & EAssetRegistryDependencyType::Hard)
+	{
+		AppendNodes(bReferencers ? GetReferencers(Node, EPakMgrDependencyKind::Hard) : GetDependencies(Node, EPakMgrDependencyKind::Hard));
+	}
+
+	if (SearchFlags & EAssetRegistryDependencyType::Soft)
+	{
+		AppendNodes(bReferencers ? GetReferencers(Node, EPakMgrDependencyKind::Soft) : GetDependencies(Node, EPakMgrDependencyKind::Soft));
+	}
+
+	return true;
+}
+
+
+/* FPakMgrDependencyGraph::FEdgeList implementation
+ *****************************************************************************/
+
+void FPakMgrDependencyGraph::FEdgeList::Initialize(int32 NumNodes, const TArray<TPair<int32, int32>>& Edges, bool bReverse)
+{
+	// counting sort by source node keeps each node's edges in insertion order
+	Offsets.SetNumZeroed(NumNodes + 1);
+
+	for (const TPair<int32, int32>& Edge : Edges)
+	{
+		++Offsets[(bReverse ? Edge.Value : Edge.Key) + 1];
+	}
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		Offsets[Node + 1] += Offsets[Node];
+	}
+
+	TArray<int32> Cursors(Offsets.GetData(), NumNodes);
+	Targets.SetNumUninitialized(Edges.Num());
+
+	for (const TPair<int32, int32>& Edge : Edges)
+	{
+		const int32 Source = bReverse ? Edge.Value : Edge.Key;
+		Targets[Cursors[Source]++] = bReverse ? Edge.Key : Edge.Value;
+	}
+}
@@ -0,0 +1,235 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "Containers/ArrayView.h"
+#include "Misc/AssetRegistryInterface.h"
+
+class FAssetRegistryState;
+struct FAssetPackageData;
+
+/** Kinds of package edges stored in the dependency graph. */
+enum class EPakMgrDependencyKind : uint8
+{
+	/** The package must be loaded together with its referencer. */
+	Hard,
+
+	/** The package is referenced by path and loaded on demand. */
+	Soft
+};
+
+
+/**
+ * Immutable compressed-sparse-row snapshot of the package dependency graph.
+ *
+ * Packages are identified by dense integer node ids. Hard and soft edges are stored in separate
+ * offset/target arrays together with a reverse index, so closure and referencer queries never
+ * touch the asset registry and never allocate.
+ *
+ * Once built the graph is read-only and may be shared across threads.
+ */
+class FPakMgrDependencyGraph
+{
+public:
+
+	/** Incrementally collects nodes and edges and freezes them into a graph. */
+	class FBuilder
+	{
+	public:
+
+		/**
+		 * Adds a package node, or finds it if it was added before.
+		 *
+		 * @param PackageName The long package name.
+		 * @return The node id.
+		 */
+		int32 FindOrAddNode(FName PackageName);
+
+		/**
+		 * Sets the per package data of a node.
+		 *
+		 * @param Node The node id.
+		 * @param DiskSize The size of the package on disk, negative if the package is not part of the registry source.
+		 * @param bIsRedirector Whether the package only holds an object redirector.
+		 * @param Stamp Changes whenever the package is saved, zero if unknown.
+		 */
+		void SetPackageData(int32 Node, int64 DiskSize, bool bIsRedirector, uint64 Stamp = 0);
+
+		/**
+		 * Adds a dependency edge.
+		 *
+		 * @param FromNode The referencing node.
+		 * @param ToNode The referenced node.
+		 * @param Kind The kind of the reference.
+		 */
+		void AddEdge(int32 FromNode, int32 ToNode, EPakMgrDependencyKind Kind);
+
+		/** Gets the number of nodes added so far. */
+		int32 Num() const
+		{
+			return PackageNames.Num();
+		}
+
+		/** Gets the disk size set for a node, -1 if none was set. */
+		int64 GetDiskSize(int32 Node) const
+		{
+			return DiskSizes[Node];
+		}
+
+		/** Freezes the collected data into a graph. The builder is empty afterwards. */
+		TSharedRef<const FPakMgrDependencyGraph, ESPMode::ThreadSafe> Build();
+
+	private:
+
+		TArray<FName> PackageNames;
+		TMap<FName, int32> NodeIds;
+		TArray<int64> DiskSizes;
+		TBitArray<> Redirectors;
+		TArray<uint64> Stamps;
+		TArray<TPair<int32, int32>> HardEdges;
+		TArray<TPair<int32, int32>> SoftEdges;
+	};
+
+public:
+
+	/**
+	 * Creates a snapshot of all package dependencies in a registry state.
+	 *
+	 * @param State The registry state to snapshot.
+	 * @param bIsEditor Whether the state belongs to the editor, in which case every package counts as present.
+	 * @param PreviousGraph Optional earlier snapshot. Edges of packages whose stamp did not change are copied from it instead of being queried.
+	 * @return The new graph.
+	 */
+	static TSharedRef<const FPakMgrDependencyGraph, ESPMode::ThreadSafe> CreateFromRegistryState(const FAssetRegistryState& State, bool bIsEditor, const FPakMgrDependencyGraph* PreviousGraph = nullptr);
+
+public:
+
+	/** Gets the number of nodes. */
+	int32 Num() const
+	{
+		return PackageNames.Num();
+	}
+
+	/** Gets the total number of hard and soft edges. */
+	int32 NumEdges() const
+	{
+		return HardDependencies.Targets.Num() + SoftDependencies.Targets.Num();
+	}
+
+	/**
+	 * Finds the node of a package.
+	 *
+	 * @param PackageName The long package name.
+	 * @return The node id, or INDEX_NONE if the package is unknown.
+	 */
+	int32 FindNode(FName PackageName) const
+	{
+		const int32* Node = NodeIds.Find(PackageName);
+		return Node ? *Node : INDEX_NONE;
+	}
+
+	/** Gets the package name of a node. */
+	FName GetPackageName(int32 Node) const
+	{
+		return PackageNames[Node];
+	}
+
+	/** Gets the disk size of a node's package, negative if it is not part of the registry source. */
+	int64 GetDiskSize(int32 Node) const
+	{
+		return DiskSizes[Node];
+	}
+
+	/** Checks whether a node's package exists in the registry source. */
+	bool IsInRegistrySource(int32 Node) const
+	{
+		return DiskSizes[Node] >= 0;
+	}
+
+	/** Checks whether a node's package only holds an object redirector. */
+	bool IsRedirector(int32 Node) const
+	{
+		return Redirectors[Node];
+	}
+
+	/** Gets the stamp of a node's package, which changes whenever the package is saved. Zero if unknown. */
+	uint64 GetPackageStamp(int32 Node) const
+	{
+		return Stamps[Node];
+	}
+
+	/** Gets the packages referenced by a node. */
+	TArrayView<const int32> GetDependencies(int32 Node, EPakMgrDependencyKind Kind) const
+	{
+		return (Kind == EPakMgrDependencyKind::Hard ? HardDependencies : SoftDependencies).Get(Node);
+	}
+
+	/** Gets the packages referencing a node. */
+	TArrayView<const int32> GetReferencers(int32 Node, EPakMgrDependencyKind Kind) const
+	{
+		return (Kind == EPakMgrDependencyKind::Hard ? HardReferencers : SoftReferencers).Get(Node);
+	}
+
+	/**
+	 * Checks whether the graph can answer queries for the given registry dependency types.
+	 *
+	 * Only package edges are stored, searchable names and management references are not.
+	 */
+	static bool SupportsSearchFlags(EAssetRegistryDependencyType::Type SearchFlags)
+	{
+		return (SearchFlags & ~(EAssetRegistryDependencyType::Hard | EAssetRegistryDependencyType::Soft)) == 0;
+	}
+
+	/**
+	 * Appends the neighbours of a package in the registry's identifier format.
+	 *
+	 * @param PackageName The package to query.
+	 * @param SearchFlags The dependency types to include, see SupportsSearchFlags.
+	 * @param bReferencers Whether to append referencers (true) or dependencies (false).
+	 * @param OutIdentifiers Will hold the neighbours.
+	 * @return false if the package is not part of the graph.
+	 */
+	bool AppendNeighbours(FName PackageName, EAssetRegistryDependencyType::Type SearchFlags, bool bReferencers, TArray<FAssetIdentifier>& OutIdentifiers) const;
+
+	/** Computes the stamp of a package from its registry data, see GetPackageStamp. */
+	static uint64 ComputePackageStamp(const FAssetPackageData& PackageData);
+
+private:
+
+	/** One direction of one edge kind in compressed-sparse-row form. */
+	struct FEdgeList
+	{
+		/** Holds Num() + 1 offsets into Targets. */
+		TArray<int32> Offsets;
+
+		/** Holds the target nodes of all edges, grouped by source node. */
+		TArray<int32> Targets;
+
+		TArrayView<const int32> Get(int32 Node) const
+		{
+			return TArrayView<const int32>(Targets.GetData() + Offsets[Node], Offsets[Node + 1] - Offsets[Node]);
+		}
+
+		/** Builds the list from unsorted (source, target) pairs. */
+		void Initialize(int32 NumNodes, const TArray<TPair<int32, int32>>& Edges, bool bReverse);
+	};
+
+	friend class FPakMgrDependencyGraphCache;
+
+	TArray<FName> PackageNames;
+	TMap<FName, int32> NodeIds;
+	TArray<int64> DiskSizes;
+	TBitArray<> Redirectors;
+	TArray<uint64> Stamps;
+
+	FEdgeList HardDependencies;
+	FEdgeList SoftDependencies;
+	FEdgeList HardReferencers;
+	FEdgeList SoftReferencers;
+};
+
+
+/** Type definition for shared pointers to dependency graph snapshots. */
+typedef TSharedPtr<const FPakMgrDependencyGraph, ESPMode::ThreadSafe> FPakMgrDependencyGraphPtr;
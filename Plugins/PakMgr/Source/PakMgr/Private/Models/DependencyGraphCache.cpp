@@ -0,0 +1,295 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/DependencyGraphCache.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+namespace DependencyGraphCache
+{
+	/** Identifies dependency graph cache files ('PMDG'). */
+	static const uint32 Magic = 0x47444D50;
+
+	/** Incremented whenever the layout changes, outdated files are ignored. */
+	static const uint32 Version = 1;
+
+	/** Fixed size header at the start of a cache file. */
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 NumNodes;
+		int32 NumHardEdges;
+		int32 NumSoftEdges;
+		int32 NamesSize;
+		uint64 Reserved;
+	};
+
+	static_assert(sizeof(FHeader) == 32, "The cache header layout must not change without a version bump");
+
+	/** Appends an array to a cache image, starting at the next 8 byte boundary. */
+	template<typename ElementType>
+	void AppendSection(TArray<uint8>& Image, const ElementType* Elements, int32 Num)
+	{
+		Image.AddZeroed(Align(Image.Num(), 8) - Image.Num());
+		Image.Append((const uint8*)Elements, Num * sizeof(ElementType));
+	}
+
+	/** Reads the arrays of a cache image in the order they were appended. */
+	class FReader
+	{
+	public:
+
+		FReader(const uint8* InData, int64 InSize)
+			: Data(InData)
+			, Size(InSize)
+			, Offset(sizeof(FHeader))
+		{ }
+
+		/** Copies the next section into an array, returns false if the image is too short. */
+		template<typename ElementType>
+		bool Read(int32 Num, TArray<ElementType>& OutElements)
+		{
+			const int64 SectionOffset = Align(Offset, 8);
+			const int64 SectionSize = (int64)Num * sizeof(ElementType);
+
+			if ((Num < 0) || (SectionOffset + SectionSize > Size))
+			{
+				return false;
+			}
+
+			OutElements.SetNumUninitialized(Num);
+			FMemory::Memcpy(OutElements.GetData(), Data + SectionOffset, SectionSize);
+			Offset = SectionOffset + SectionSize;
+
+			return true;
+		}
+
+	private:
+
+		const uint8* Data;
+		int64 Size;
+		int64 Offset;
+	};
+
+	/** Checks that an edge list read from disk is well formed. */
+	bool IsValidEdgeList(const TArray<int32>& Offsets, const TArray<int32>& Targets, int32 NumNodes)
+	{
+		if ((Offsets.Num() != NumNodes + 1) || (Offsets[0] != 0) || (Offsets[NumNodes] != Targets.Num()))
+		{
+			return false;
+		}
+
+		for (int32 Node = 0; Node < NumNodes; ++Node)
+		{
+			if (Offsets[Node] > Offsets[Node + 1])
+			{
+				return false;
+			}
+		}
+
+		for (int32 Target : Targets)
+		{
+			if ((Target < 0) || (Target >= NumNodes))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+
+/* FPakMgrDependencyGraphCache interface
+ *****************************************************************************/
+
+FPakMgrDependencyGraphPtr FPakMgrDependencyGraphCache::Load(const FString& Filename)
+{
+	PAKMGR_TRACE_SCOPE(LoadDependencyGraphCache);
+
+	using namespace DependencyGraphCache;
+
+	// the file is mapped if the platform supports it and read into memory otherwise, every section is then copied into its array in one go
+	TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	TUniquePtr<IMappedFileRegion> MappedRegion((MappedFile.IsValid() && (MappedFile->GetFileSize() > 0)) ? MappedFile->MapRegion() : nullptr);
+	TArray<uint8> Buffer;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+
+	if (MappedRegion.IsValid())
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(Buffer, *Filename, FILEREAD_Silent))
+	{
+		Data = Buffer.GetData();
+		Size = Buffer.Num();
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	FHeader Header;
+
+	if (Size < (int64)sizeof(FHeader))
+	{
+		return nullptr;
+	}
+
+	FMemory::Memcpy(&Header, Data, sizeof(FHeader));
+
+	if ((Header.Magic != Magic) || (Header.Version != Version) || (Header.NumNodes < 0))
+	{
+		UE_LOG(LogPakMgr, Log, TEXT("Ignoring outdated dependency graph cache %s"), *Filename);
+
+		return nullptr;
+	}
+
+	TSharedRef<FPakMgrDependencyGraph, ESPMode::ThreadSafe> Graph = MakeShared<FPakMgrDependencyGraph, ESPMode::ThreadSafe>();
+	const int32 NumNodes = Header.NumNodes;
+
+	TArray<uint8> Redirectors;
+	TArray<uint16> Names;
+	FReader Reader(Data, Size);
+
+	const bool bIsComplete = Reader.Read(NumNodes, Graph->DiskSizes)
+		&& Reader.Read(NumNodes, Graph->Stamps)
+		&& Reader.Read(NumNodes, Redirectors)
+		&& Reader.Read(NumNodes + 1, Graph->HardDependencies.Offsets) && Reader.Read(Header.NumHardEdges, Graph->HardDependencies.Targets)
+		&& Reader.Read(NumNodes + 1, Graph->SoftDependencies.Offsets) && Reader.Read(Header.NumSoftEdges, Graph->SoftDependencies.Targets)
+		&& Reader.Read(NumNodes + 1, Graph->HardReferencers.Offsets) && Reader.Read(Header.NumHardEdges, Graph->HardReferencers.Targets)
+		&& Reader.Read(NumNodes + 1, Graph->SoftReferencers.Offsets) && Reader.Read(Header.NumSoftEdges, Graph->SoftReferencers.Targets)
+		&& Reader.Read(Header.NamesSize, Names);
+
+	const bool bIsValid = bIsComplete
+		&& IsValidEdgeList(Graph->HardDependencies.Offsets, Graph->HardDependencies.Targets, NumNodes)
+		&& IsValidEdgeList(Graph->SoftDependencies.Offsets, Graph->SoftDependencies.Targets, NumNodes)
+		&& IsValidEdgeList(Graph->HardReferencers.Offsets, Graph->HardReferencers.Targets, NumNodes)
+		&& IsValidEdgeList(Graph->SoftReferencers.Offsets, Graph->SoftReferencers.Targets, NumNodes)
+		&& ((Names.Num() == 0) || (Names.Last() == 0));
+
+	if (!bIsValid)
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("Ignoring corrupt dependency graph cache %s"), *Filename);
+
+		return nullptr;
+	}
+
+	// names are null terminated UTF-16, in node order
+	Graph->PackageNames.Reserve(NumNodes);
+	Graph->NodeIds.Reserve(NumNodes);
+	Graph->Redirectors.Init(false, NumNodes);
+
+	int32 NameStart = 0;
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		if (NameStart >= Names.Num())
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("Ignoring corrupt dependency graph cache %s"), *Filename);
+
+			return nullptr;
+		}
+
+		const UTF16CHAR* Name = (const UTF16CHAR*)&Names[NameStart];
+		const FName PackageName(FUTF16ToTCHAR(Name).Get());
+
+		Graph->PackageNames.Add(PackageName);
+		Graph->NodeIds.Add(PackageName, Node);
+		Graph->Redirectors[Node] = (Redirectors[Node] != 0);
+
+		while (Names[NameStart] != 0)
+		{
+			++NameStart;
+		}
+
+		++NameStart;
+	}
+
+	return Graph;
+}
+
+
+bool FPakMgrDependencyGraphCache::Save(const FPakMgrDependencyGraph& Graph, const FString& Filename)
+{
+	PAKMGR_TRACE_SCOPE(SaveDependencyGraphCache);
+
+	using namespace DependencyGraphCache;
+
+	const int32 NumNodes = Graph.Num();
+
+	TArray<uint8> Redirectors;
+	Redirectors.SetNumUninitialized(NumNodes);
+
+	TArray<uint16> Names;
+
+	for (int32 Node = 0; Node < NumNodes; ++Node)
+	{
+		Redirectors[Node] = Graph.IsRedirector(Node) ? 1 : 0;
+
+		const FTCHARToUTF16 Name(*Graph.GetPackageName(Node).ToString());
+		Names.Append((const uint16*)Name.Get(), Name.Length());
+		Names.Add(0);
+	}
+
+	FHeader Header;
+	FMemory::Memzero(Header);
+	Header.Magic = Magic;
+	Header.Version = Version;
+	Header.NumNodes = NumNodes;
+	Header.NumHardEdges = Graph.HardDependencies.Targets.Num();
+	Header.NumSoftEdges = Graph.SoftDependencies.Targets.Num();
+	Header.NamesSize = Names.Num();
+
+	TArray<uint8> Image;
+	Image.Append((const uint8*)&Header, sizeof(FHeader));
+
+	auto AppendEdgeList = [&Image](const FPakMgrDependencyGraph::FEdgeList& EdgeList)
+	{
+		AppendSection(Image, EdgeList.Offsets.GetData(), EdgeList.Offsets.Num());
+		AppendSection(Image, EdgeList.Targets.GetData(), EdgeList.Targets.Num());
+	};
+
+	AppendSection(Image, Graph.DiskSizes.GetData(), NumNodes);
+	AppendSection(Image, Graph.Stamps.GetData(), NumNodes);
+	AppendSection(Image, Redirectors.GetData(), NumNodes);
+	AppendEdgeList(Graph.HardDependencies);
+	AppendEdgeList(Graph.SoftDependencies);
+	AppendEdgeList(Graph.HardReferencers);
+	AppendEdgeList(Graph.SoftReferencers);
+	AppendSection(Image, Names.GetData(), Names.Num());
+
+	// write next to the target first, so readers never see a partial file; the name is unique, so parallel commandlets do not share it
+	const FString TempFilename = FPaths::CreateTempFilename(*FPaths::GetPath(Filename), *(FPaths::GetCleanFilename(Filename) + TEXT("-")), TEXT(".tmp"));
+
+	if (!FFileHelper::SaveArrayToFile(Image, *TempFilename))
+	{
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+
+		return false;
+	}
+
+	if (!IFileManager::Get().Move(*Filename, *TempFilename, true, true, false, true))
+	{
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+
+		return false;
+	}
+
+	return true;
+}
+
+
+FString FPakMgrDependencyGraphCache::GetEditorCacheFilename()
+{
+	return FPaths::ProjectIntermediateDir() / TEXT("PakMgr") / TEXT("DependencyGraph.bin");
+}
@@ -0,0 +1,42 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+
+/**
+ * Reads and writes dependency graph snapshots to disk.
+ *
+ * The file holds the compressed-sparse-row arrays, disk sizes, package stamps and redirector
+ * flags in the same layout as in memory, so loading maps the file and copies each array in one go,
+ * without parsing. The package names are interned again, which is the bulk of the load.
+ *
+ * A loaded graph is only as current as the registry it was saved from. Pass it as the previous
+ * graph to FPakMgrDependencyGraph::CreateFromRegistryState to refresh it, which only queries the
+ * packages whose stamp changed.
+ */
+class FPakMgrDependencyGraphCache
+{
+public:
+
+	/**
+	 * Loads a graph.
+	 *
+	 * @param Filename The cache file.
+	 * @return The graph, or null if the file does not exist, is outdated or corrupt.
+	 */
+	static FPakMgrDependencyGraphPtr Load(const FString& Filename);
+
+	/**
+	 * Saves a graph. May be called from any thread.
+	 *
+	 * @param Graph The graph to save.
+	 * @param Filename The cache file.
+	 * @return true on success.
+	 */
+	static bool Save(const FPakMgrDependencyGraph& Graph, const FString& Filename);
+
+	/** Gets the cache file of the editor registry. */
+	static FString GetEditorCacheFilename();
+};
@@ -31,6 +31,12 @@ struct FFileItemInfo
 	/** Holds the verbosity type. */
 	ELogVerbosity::Type Verbosity;
 
+	/** Holds the graph node of the listed package, INDEX_NONE for log messages. */
+	int32 Node;
+
+	/** Holds the breadth-first depth of the listed package in its module, INDEX_NONE for log messages. */
+	int32 Depth;
+
 public:
 
 	/**
@@ -51,6 +57,8 @@ public:
 		, Time(FDateTime::Now())
 		, TimeSeconds(InTimeSeconds)
 		, Verbosity(InVerbosity)
+		, Node(INDEX_NONE)
+		, Depth(INDEX_NONE)
 	{ }
 
 public:
@@ -0,0 +1,217 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/FileItemSorter.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+
+
+namespace FileItemSorter
+{
+	/** Chunks below this size are not worth a task of their own. */
+	const int32 MinItemsPerChunk = 4096;
+
+	/** The precomputed sort key of an item. */
+	struct FEntry
+	{
+		/** Numeric key, or the rank of the module name. */
+		int64 Key;
+
+		/** String key, null unless sorting by path. */
+		const TCHAR* Text;
+
+		/** Index of the item before sorting, breaks ties. */
+		int32 Index;
+	};
+
+	/** Orders entries by key, then text, then original index. */
+	struct FCompareEntries
+	{
+		bool bDescending;
+
+		bool operator()(const FEntry& A, const FEntry& B) const
+		{
+			if (A.Key != B.Key)
+			{
+				return bDescending ? (A.Key > B.Key) : (A.Key < B.Key);
+			}
+
+			if (A.Text != B.Text)
+			{
+				const int32 Result = FCString::Stricmp(A.Text, B.Text);
+
+				if (Result != 0)
+				{
+					return bDescending ? (Result > 0) : (Result < 0);
+				}
+			}
+
+			return A.Index < B.Index;
+		}
+	};
+
+	/** Merges the sorted ranges [First, Middle) and [Middle, Last) of Source into Dest. */
+	void Merge(const FEntry* Source, FEntry* Dest, int32 First, int32 Middle, int32 Last, const FCompareEntries& Compare)
+	{
+		int32 Left = First;
+		int32 Right = Middle;
+		int32 Out = First;
+
+		while ((Left < Middle) && (Right < Last))
+		{
+			Dest[Out++] = Compare(Source[Right], Source[Left]) ? Source[Right++] : Source[Left++];
+		}
+
+		while (Left < Middle)
+		{
+			Dest[Out++] = Source[Left++];
+		}
+
+		while (Right < Last)
+		{
+			Dest[Out++] = Source[Right++];
+		}
+	}
+}
+
+
+/* FPakMgrFileItemSorter interface
+ *****************************************************************************/
+
+void FPakMgrFileItemSorter::Sort(TArray<FPakMgrLogHandle>& Items, const FPakMgrLogStore& Store, EPakMgrFileSortKey Key, bool bDescending, const FPakMgrDependencyGraph* Graph)
+{
+	using namespace FileItemSorter;
+
+	const int32 NumItems = Items.Num();
+
+	if (NumItems < 2)
+	{
+		return;
+	}
+
+	const int32 NumChunks = FMath::Clamp(NumItems / MinItemsPerChunk, 1, FTaskGraphInterface::Get().GetNumWorkerThreads() + 1);
+	const int32 ItemsPerChunk = FMath::DivideAndRoundUp(NumItems, NumChunks);
+
+	// module names are interned by the store, so they are ranked once instead of compared per entry
+	TArray<int64> ModuleRanks;
+
+	if (Key == EPakMgrFileSortKey::Module)
+	{
+		TArray<int32> InstanceIndices;
+
+		for (int32 InstanceIndex = 0; InstanceIndex < Store.GetNumInstanceNames(); ++InstanceIndex)
+		{
+			InstanceIndices.Add(InstanceIndex);
+		}
+
+		InstanceIndices.Sort([&Store](int32 A, int32 B) { return Store.GetInstanceNameByIndex(A).Compare(Store.GetInstanceNameByIndex(B), ESearchCase::IgnoreCase) < 0; });
+		ModuleRanks.SetNumUninitialized(InstanceIndices.Num());
+
+		for (int32 Rank = 0; Rank < InstanceIndices.Num(); ++Rank)
+		{
+			ModuleRanks[InstanceIndices[Rank]] = Rank;
+		}
+	}
+
+	TArray<FEntry> Entries;
+	Entries.SetNumUninitialized(NumItems);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		const int32 First = ChunkIndex * ItemsPerChunk;
+		const int32 Last = FMath::Min(First + ItemsPerChunk, NumItems);
+
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			const FPakMgrLogHandle Item = Items[Index];
+			const int32 Node = Store.GetNode(Item);
+			const bool bHasNode = (Graph != nullptr) && (Node != INDEX_NONE) && (Node < Graph->Num());
+
+			FEntry& Entry = Entries[Index];
+			Entry.Key = 0;
+			Entry.Text = nullptr;
+			Entry.Index = Index;
+
+			switch (Key)
+			{
+			case EPakMgrFileSortKey::Path:
+				Entry.Text = Store.GetText(Item);
+				break;
+
+			case EPakMgrFileSortKey::Size:
+				Entry.Key = bHasNode ? Graph->GetDiskSize(Node) : -1;
+				break;
+
+			case EPakMgrFileSortKey::ReferenceCount:
+				Entry.Key = bHasNode ? Graph->GetReferencers(Node, EPakMgrDependencyKind::Hard).Num() + Graph->GetReferencers(Node, EPakMgrDependencyKind::Soft).Num() : -1;
+				break;
+
+			case EPakMgrFileSortKey::Depth:
+				Entry.Key = Store.GetDepth(Item);
+				break;
+
+			case EPakMgrFileSortKey::Module:
+				Entry.Key = ModuleRanks[Store.GetInstanceIndex(Item)];
+				break;
+			}
+		}
+	});
+
+	// sort the chunks in parallel, then merge pairs of them until one is left
+	const FCompareEntries Compare = { bDescending };
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		const int32 First = ChunkIndex * ItemsPerChunk;
+		const int32 Last = FMath::Min(First + ItemsPerChunk, NumItems);
+
+		if (First < Last)
+		{
+			::Sort(Entries.GetData() + First, Last - First, Compare);
+		}
+	});
+
+	TArray<FEntry> MergedEntries;
+	MergedEntries.SetNumUninitialized(NumItems);
+
+	for (int32 Width = ItemsPerChunk; Width < NumItems; Width *= 2)
+	{
+		const int32 NumMerges = FMath::DivideAndRoundUp(NumItems, 2 * Width);
+
+		ParallelFor(NumMerges, [&](int32 MergeIndex)
+		{
+			const int32 First = MergeIndex * 2 * Width;
+			const int32 Middle = FMath::Min(First + Width, NumItems);
+			const int32 Last = FMath::Min(First + 2 * Width, NumItems);
+
+			Merge(Entries.GetData(), MergedEntries.GetData(), First, Middle, Last, Compare);
+		});
+
+		Swap(Entries, MergedEntries);
+	}
+
+	// reorder the items once
+	TArray<FPakMgrLogHandle> SortedItems;
+	SortedItems.Reserve(NumItems);
+
+	for (const FEntry& Entry : Entries)
+	{
+		SortedItems.Add(Items[Entry.Index]);
+	}
+
+	Items = MoveTemp(SortedItems);
+}
+
+
+const TCHAR* FPakMgrFileItemSorter::GetKeyName(EPakMgrFileSortKey Key)
+{
+	switch (Key)
+	{
+	case EPakMgrFileSortKey::Path: return TEXT("path");
+	case EPakMgrFileSortKey::Size: return TEXT("size");
+	case EPakMgrFileSortKey::ReferenceCount: return TEXT("reference count");
+	case EPakMgrFileSortKey::Depth: return TEXT("depth");
+	case EPakMgrFileSortKey::Module: return TEXT("module");
+	}
+
+	return TEXT("");
+}
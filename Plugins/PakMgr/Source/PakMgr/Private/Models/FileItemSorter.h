@@ -0,0 +1,55 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+#include "Models/LogStore.h"
+
+/** Keys the file list can be sorted by. */
+enum class EPakMgrFileSortKey : uint8
+{
+	/** The package path, ignoring case. */
+	Path,
+
+	/** The package's disk size. */
+	Size,
+
+	/** The number of hard and soft referencers of the package. */
+	ReferenceCount,
+
+	/** The package's breadth-first depth in its module. */
+	Depth,
+
+	/** The module name, ignoring case. */
+	Module
+};
+
+/**
+ * Sorts file list items.
+ *
+ * The keys of all items are read from the log store up front, in parallel, into a flat array of
+ * small entries that carry the item's index. The entries are sorted in parallel chunks that are
+ * then merged pairwise, and the items are reordered once at the end. Comparisons never touch the
+ * store or the graph, and texts are compared in place through pointers taken up front.
+ *
+ * Equal keys keep the current order, so the sort is stable.
+ */
+class FPakMgrFileItemSorter
+{
+public:
+
+	/**
+	 * Sorts items.
+	 *
+	 * @param Items The items to sort.
+	 * @param Store The store holding the items, it must not change while sorting.
+	 * @param Key The key to sort by.
+	 * @param bDescending Whether to put the largest keys first.
+	 * @param Graph The graph the items' nodes belong to, needed for the Size and ReferenceCount keys.
+	 */
+	static void Sort(TArray<FPakMgrLogHandle>& Items, const FPakMgrLogStore& Store, EPakMgrFileSortKey Key, bool bDescending, const FPakMgrDependencyGraph* Graph);
+
+	/** Gets the display name of a key. */
+	static const TCHAR* GetKeyName(EPakMgrFileSortKey Key);
+};
@@ -0,0 +1,113 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/FileItemInfo.h"
+#include "Models/LogStore.h"
+
+/**
+ * Compiled settings of the file tree filter bar.
+ *
+ * Taken once whenever the settings change, so filtering a message neither queries widgets nor
+ * allocates. Filtering is read only and may run on several threads at once.
+ */
+struct FFileTreeFilter
+{
+	/** Holds the text messages must contain, case is ignored. */
+	FString Text;
+
+	/** Holds the log categories that are filtered out. */
+	TSet<FName> DisabledCategories;
+
+	/** Holds one bit per verbosity that is filtered out. */
+	uint32 DisabledVerbosities;
+
+	/** Holds a flag indicating whether the text is only highlighted instead of filtered. */
+	bool bHighlightOnly;
+
+public:
+
+	/** Default constructor. */
+	FFileTreeFilter()
+		: DisabledVerbosities(0)
+		, bHighlightOnly(false)
+	{ }
+
+public:
+
+	/**
+	 * Checks whether a message passes the filter.
+	 *
+	 * @param Message The message to check.
+	 * @return true if the message passes, false otherwise.
+	 */
+	bool PassesFilter(const FFileItemInfo& Message) const
+	{
+		return PassesFilter(Message.Category, Message.Verbosity, *Message.Text);
+	}
+
+	/**
+	 * Checks whether a stored message passes the filter.
+	 *
+	 * @param Store The store holding the message.
+	 * @param Handle The message to check.
+	 * @return true if the message passes, false otherwise.
+	 */
+	bool PassesFilter(const FPakMgrLogStore& Store, FPakMgrLogHandle Handle) const
+	{
+		return PassesFilter(Store.GetCategory(Handle), Store.GetVerbosity(Handle), Store.GetText(Handle));
+	}
+
+	/**
+	 * Checks whether every message passing this filter also passes another one.
+	 *
+	 * If so, the messages passing the other filter can be filtered again instead of all messages.
+	 *
+	 * @param Other The filter to compare with.
+	 * @return true if this filter is at least as strict, false if it may let more messages through.
+	 */
+	bool IsNarrowerThan(const FFileTreeFilter& Other) const
+	{
+		if ((Other.DisabledVerbosities & ~DisabledVerbosities) != 0)
+		{
+			return false;
+		}
+
+		for (const FName& Category : Other.DisabledCategories)
+		{
+			if (!DisabledCategories.Contains(Category))
+			{
+				return false;
+			}
+		}
+
+		// a text containing the other text only matches where the other one does
+		return !Other.FiltersText() || (FiltersText() && Text.Contains(Other.Text));
+	}
+
+	/** Gets the bit of a verbosity in DisabledVerbosities. */
+	static uint32 GetVerbosityBit(ELogVerbosity::Type Verbosity)
+	{
+		return 1u << (Verbosity & ELogVerbosity::VerbosityMask);
+	}
+
+private:
+
+	/** Checks whether a message's fields pass the filter. */
+	bool PassesFilter(FName MessageCategory, ELogVerbosity::Type MessageVerbosity, const TCHAR* MessageText) const
+	{
+		if (((DisabledVerbosities & GetVerbosityBit(MessageVerbosity)) != 0) || DisabledCategories.Contains(MessageCategory))
+		{
+			return false;
+		}
+
+		return !FiltersText() || (FCString::Stristr(MessageText, *Text) != nullptr);
+	}
+
+	/** Checks whether the text removes messages, rather than only highlighting them. */
+	bool FiltersText() const
+	{
+		return !bHighlightOnly && !Text.IsEmpty();
+	}
+};
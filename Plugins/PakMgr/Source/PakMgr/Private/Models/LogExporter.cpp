@@ -0,0 +1,267 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/LogExporter.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "PakMgrModule.h"
+#include "PakMgrUtf8.h"
+
+
+namespace LogExporter
+{
+	/** The buffer is written out, and compressed, in blocks of this size. */
+	const int32 BlockSize = 1024 * 1024;
+
+	/** The progress counter is only updated every so many lines. */
+	const int32 LinesPerProgressUpdate = 4096;
+}
+
+
+/* FPakMgrLogExporter structors
+ *****************************************************************************/
+
+FPakMgrLogExporter::FPakMgrLogExporter(const FString& InFilename)
+	: Filename(InFilename)
+	, Format(GetFormat(InFilename))
+	, bCompress(IsCompressed(InFilename))
+{ }
+
+
+/* FPakMgrLogExporter interface
+ *****************************************************************************/
+
+void FPakMgrLogExporter::AddMessages(const FPakMgrLogStore& Store, const TArray<FPakMgrLogHandle>& Handles)
+{
+	check(!Future.IsValid());
+
+	InstanceNames.Reset(Store.GetNumInstanceNames());
+
+	for (int32 InstanceIndex = 0; InstanceIndex < Store.GetNumInstanceNames(); ++InstanceIndex)
+	{
+		InstanceNames.Add(Store.GetInstanceNameByIndex(InstanceIndex));
+	}
+
+	Categories.Reset(Store.GetNumCategories());
+
+	for (int32 CategoryIndex = 0; CategoryIndex < Store.GetNumCategories(); ++CategoryIndex)
+	{
+		const FName Category = Store.GetCategoryByIndex(CategoryIndex);
+		Categories.Add(Category.IsNone() ? FString() : Category.ToString());
+	}
+
+	// size the arrays once, the texts are then copied without any allocation
+	int32 TextLength = Text.Num();
+
+	for (const FPakMgrLogHandle& Handle : Handles)
+	{
+		if (Store.Contains(Handle))
+		{
+			TextLength += Store.GetTextLen(Handle);
+		}
+	}
+
+	Lines.Reserve(Lines.Num() + Handles.Num());
+	Text.Reserve(TextLength);
+
+	for (const FPakMgrLogHandle& Handle : Handles)
+	{
+		if (!Store.Contains(Handle))
+		{
+			continue;
+		}
+
+		FLine& Line = Lines[Lines.AddUninitialized()];
+		Line.Ticks = Store.GetTime(Handle).GetTicks();
+		Line.TimeSeconds = Store.GetTimeSeconds(Handle);
+		Line.TextOffset = Text.Num();
+		Line.TextLength = Store.GetTextLen(Handle);
+		Line.InstanceIndex = Store.GetInstanceIndex(Handle);
+		Line.CategoryIndex = Store.GetCategoryIndex(Handle);
+		Line.Verbosity = (uint8)Store.GetVerbosity(Handle);
+
+		Text.Append(Store.GetText(Handle), Line.TextLength);
+	}
+}
+
+
+void FPakMgrLogExporter::Start(const TSharedRef<FPakMgrLogExporter, ESPMode::ThreadSafe>& Exporter)
+{
+	check(!Exporter->Future.IsValid());
+
+	Exporter->Future = Async<bool>(EAsyncExecution::ThreadPool, [Exporter]()
+	{
+		return Exporter->Export();
+	});
+}
+
+
+EPakMgrLogExportFormat FPakMgrLogExporter::GetFormat(const FString& Filename)
+{
+	const FString BaseFilename = IsCompressed(Filename) ? FPaths::GetBaseFilename(Filename, false) : Filename;
+
+	return (FPaths::GetExtension(BaseFilename) == TEXT("jsonl")) ? EPakMgrLogExportFormat::JsonLines : EPakMgrLogExportFormat::Text;
+}
+
+
+bool FPakMgrLogExporter::IsCompressed(const FString& Filename)
+{
+	return FPaths::GetExtension(Filename) == TEXT("gz");
+}
+
+
+/* FPakMgrLogExporter implementation
+ *****************************************************************************/
+
+bool FPakMgrLogExporter::Export()
+{
+	const double StartTime = FPlatformTime::Seconds();
+
+	// written next to the target first, so a canceled or failed save leaves no partial file behind
+	const FString TempFilename = FPaths::CreateTempFilename(*FPaths::GetPath(Filename), *(FPaths::GetCleanFilename(Filename) + TEXT("-")), TEXT(".tmp"));
+	TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*TempFilename));
+
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to open %s for saving the log"), *TempFilename);
+
+		return false;
+	}
+
+	bool bSucceeded = WriteLines(*Archive);
+	Archive.Reset();
+
+	if (bSucceeded && !IFileManager::Get().Move(*Filename, *TempFilename, true, true, false, true))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to move the saved log to %s"), *Filename);
+
+		bSucceeded = false;
+	}
+
+	if (!bSucceeded)
+	{
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+
+		return false;
+	}
+
+	NumWritten.Set(Lines.Num());
+
+	UE_LOG(LogPakMgr, Log, TEXT("Saved %d log messages to %s in %.2f seconds"), Lines.Num(), *Filename, FPlatformTime::Seconds() - StartTime);
+
+	return true;
+}
+
+
+bool FPakMgrLogExporter::WriteLines(FArchive& Archive)
+{
+	using namespace LogExporter;
+
+	Buffer.Reserve(BlockSize + 4096);
+
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		FormatLine(LineIndex);
+
+		if ((Buffer.Num() >= BlockSize) && !FlushBuffer(Archive))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to write the log to %s"), *Filename);
+
+			return false;
+		}
+
+		if (((LineIndex + 1) % LinesPerProgressUpdate) == 0)
+		{
+			NumWritten.Set(LineIndex + 1);
+
+			if (bCancelRequested)
+			{
+				UE_LOG(LogPakMgr, Log, TEXT("Saving the log to %s was canceled"), *Filename);
+
+				return false;
+			}
+		}
+	}
+
+	if (!FlushBuffer(Archive) || !Archive.Close())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to write the log to %s"), *Filename);
+
+		return false;
+	}
+
+	return true;
+}
+
+
+void FPakMgrLogExporter::FormatLine(int32 LineIndex)
+{
+	using namespace PakMgrUtf8;
+
+	const FLine& Line = Lines[LineIndex];
+	const FDateTime Time(Line.Ticks);
+	const FString& InstanceName = InstanceNames[Line.InstanceIndex];
+
+	if (Format == EPakMgrLogExportFormat::Text)
+	{
+		// same layout as FDateTime::ToString and CopyLog
+		AppendFormat(Buffer, "%04d.%02d.%02d-%02d.%02d.%02d [",
+			Time.GetYear(), Time.GetMonth(), Time.GetDay(), Time.GetHour(), Time.GetMinute(), Time.GetSecond());
+		AppendUtf8(Buffer, *InstanceName, InstanceName.Len());
+		AppendFormat(Buffer, "] %09.3f: ", Line.TimeSeconds);
+		AppendUtf8(Buffer, Text.GetData() + Line.TextOffset, Line.TextLength);
+		AppendUtf8(Buffer, LINE_TERMINATOR, FCString::Strlen(LINE_TERMINATOR));
+
+		return;
+	}
+
+	AppendFormat(Buffer, "{\"time\":\"%04d-%02d-%02dT%02d:%02d:%02d.%03d\",\"instance\":",
+		Time.GetYear(), Time.GetMonth(), Time.GetDay(), Time.GetHour(), Time.GetMinute(), Time.GetSecond(), Time.GetMillisecond());
+	AppendJsonString(Buffer, *InstanceName, InstanceName.Len());
+	AppendFormat(Buffer, ",\"seconds\":%.3f,\"verbosity\":\"%s\"", Line.TimeSeconds, TCHAR_TO_ANSI(ToString((ELogVerbosity::Type)Line.Verbosity)));
+
+	const FString& Category = Categories[Line.CategoryIndex];
+
+	if (!Category.IsEmpty())
+	{
+		AppendAnsi(Buffer, ",\"category\":");
+		AppendJsonString(Buffer, *Category, Category.Len());
+	}
+
+	AppendAnsi(Buffer, ",\"message\":");
+	AppendJsonString(Buffer, Text.GetData() + Line.TextOffset, Line.TextLength);
+	AppendAnsi(Buffer, "}\n");
+}
+
+
+bool FPakMgrLogExporter::FlushBuffer(FArchive& Archive)
+{
+	if (Buffer.Num() == 0)
+	{
+		return !Archive.IsError();
+	}
+
+	if (bCompress)
+	{
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Gzip, Buffer.Num());
+		CompressedBuffer.SetNumUninitialized(CompressedSize, false);
+
+		if (!FCompression::CompressMemory(NAME_Gzip, CompressedBuffer.GetData(), CompressedSize, Buffer.GetData(), Buffer.Num()))
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to compress the log written to %s"), *Filename);
+
+			return false;
+		}
+
+		Archive.Serialize(CompressedBuffer.GetData(), CompressedSize);
+	}
+	else
+	{
+		Archive.Serialize(Buffer.GetData(), Buffer.Num());
+	}
+
+	Buffer.Reset();
+
+	return !Archive.IsError();
+}
@@ -0,0 +1,166 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Models/LogStore.h"
+
+/** File formats FPakMgrLogExporter writes. */
+enum class EPakMgrLogExportFormat : uint8
+{
+	/** One line per message, as copied to the clipboard. */
+	Text,
+
+	/** One JSON object per line. */
+	JsonLines
+};
+
+/**
+ * Writes log messages to a file on a worker thread.
+ *
+ * The messages are copied out of the log store first, into a few flat arrays, so the store may
+ * change while the file is written. The worker formats them as UTF-8 straight into a reusable
+ * buffer that is written out in large blocks. Gzip compressed files are written as a series of
+ * gzip members, one per block, which any gzip reader treats as a single stream. The file is written
+ * under a temporary name and only moved into place once complete.
+ *
+ * The format follows the file name: a .jsonl extension selects JSON Lines, and an additional
+ * .gz extension selects compression.
+ */
+class FPakMgrLogExporter
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InFilename The file to write.
+	 */
+	explicit FPakMgrLogExporter(const FString& InFilename);
+
+public:
+
+	/**
+	 * Copies messages to export, must be called before Start.
+	 *
+	 * @param Store The store holding the messages.
+	 * @param Handles The messages to export, in order.
+	 */
+	void AddMessages(const FPakMgrLogStore& Store, const TArray<FPakMgrLogHandle>& Handles);
+
+	/**
+	 * Starts writing the file on a worker thread.
+	 *
+	 * @param Exporter The exporter, kept alive by the worker until it is done.
+	 */
+	static void Start(const TSharedRef<FPakMgrLogExporter, ESPMode::ThreadSafe>& Exporter);
+
+	/** Asks the worker to stop, no file is written then. */
+	void Cancel()
+	{
+		bCancelRequested = true;
+	}
+
+	/** Checks whether the worker is done. */
+	bool IsFinished() const
+	{
+		return Future.IsReady();
+	}
+
+	/** Checks whether the whole file was written, only valid once finished. */
+	bool Succeeded() const
+	{
+		return Future.IsReady() && Future.Get();
+	}
+
+	/** Gets the fraction of messages written so far. */
+	float GetProgress() const
+	{
+		return (Lines.Num() > 0) ? (float)NumWritten.GetValue() / Lines.Num() : 1.0f;
+	}
+
+	/** Gets the number of messages to write. */
+	int32 GetNumMessages() const
+	{
+		return Lines.Num();
+	}
+
+	/** Gets the file being written. */
+	const FString& GetFilename() const
+	{
+		return Filename;
+	}
+
+	/** Gets the format a file name selects. */
+	static EPakMgrLogExportFormat GetFormat(const FString& Filename);
+
+	/** Checks whether a file name selects compression. */
+	static bool IsCompressed(const FString& Filename);
+
+private:
+
+	/** Writes the file, returns true on success. Runs on the worker. */
+	bool Export();
+
+	/** Writes all lines to an archive, returns false on failure or if canceled. */
+	bool WriteLines(FArchive& Archive);
+
+	/** Appends a line in the selected format to the buffer. */
+	void FormatLine(int32 LineIndex);
+
+	/** Writes the buffer to the file and empties it, returns false on failure. */
+	bool FlushBuffer(FArchive& Archive);
+
+private:
+
+	/** A message copied from the store. */
+	struct FLine
+	{
+		int64 Ticks;
+		double TimeSeconds;
+		int32 TextOffset;
+		int32 TextLength;
+		int32 InstanceIndex;
+		int32 CategoryIndex;
+		uint8 Verbosity;
+	};
+
+	/** Holds the messages to write. */
+	TArray<FLine> Lines;
+
+	/** Holds the texts of all messages, back to back. */
+	TArray<TCHAR> Text;
+
+	/** Holds the instance names, indexed as in the store. */
+	TArray<FString> InstanceNames;
+
+	/** Holds the log categories, indexed as in the store. */
+	TArray<FString> Categories;
+
+	/** Holds the file to write. */
+	FString Filename;
+
+	/** Holds the format to write. */
+	EPakMgrLogExportFormat Format;
+
+	/** Holds a flag indicating whether the file is gzip compressed. */
+	bool bCompress;
+
+	/** Holds formatted output not written yet. */
+	TArray<uint8> Buffer;
+
+	/** Holds the compressed buffer, reused for every block. */
+	TArray<uint8> CompressedBuffer;
+
+	/** Holds the number of messages written so far. */
+	FThreadSafeCounter NumWritten;
+
+	/** Holds a flag indicating whether the worker should stop. */
+	FThreadSafeBool bCancelRequested;
+
+	/** Holds the worker's result. */
+	TFuture<bool> Future;
+};
@@ -0,0 +1,91 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/LogIngestQueue.h"
+#include "HAL/PlatformTime.h"
+#include "PakMgrModule.h"
+
+
+namespace LogIngestQueue
+{
+	/** Length of a throughput measurement in seconds. */
+	const double ThroughputWindow = 1.0;
+}
+
+
+/* FPakMgrLogIngestQueue structors
+ *****************************************************************************/
+
+FPakMgrLogIngestQueue::FPakMgrLogIngestQueue(const FString& InName)
+	: Name(InName)
+	, NumDrained(0)
+	, WindowStartTime(FPlatformTime::Seconds())
+	, WindowStartDrained(0)
+{ }
+
+
+/* FPakMgrLogIngestQueue interface
+ *****************************************************************************/
+
+void FPakMgrLogIngestQueue::Enqueue(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity, FName Category, double TimeSeconds)
+{
+	FPakMgrLogIngestMessage Message;
+	Message.InstanceName = InstanceName;
+	Message.Text = Text;
+	Message.Category = Category;
+	Message.Time = FDateTime::Now();
+	Message.TimeSeconds = TimeSeconds;
+	Message.Verbosity = Verbosity;
+
+	Messages.Enqueue(MoveTemp(Message));
+}
+
+
+void FPakMgrLogIngestQueue::Enqueue(const FFileItemInfo& Message)
+{
+	FPakMgrLogIngestMessage QueuedMessage;
+	QueuedMessage.InstanceName = Message.InstanceName;
+	QueuedMessage.Text = Message.Text;
+	QueuedMessage.Category = Message.Category;
+	QueuedMessage.Time = Message.Time;
+	QueuedMessage.TimeSeconds = Message.TimeSeconds;
+	QueuedMessage.Verbosity = Message.Verbosity;
+
+	Messages.Enqueue(MoveTemp(QueuedMessage));
+}
+
+
+int32 FPakMgrLogIngestQueue::Drain(FPakMgrLogStore& Store, TArray<FPakMgrLogHandle>& OutHandles, int32 MaxMessages)
+{
+	using namespace LogIngestQueue;
+
+	OutHandles.Reset();
+
+	FPakMgrLogIngestMessage Message;
+
+	while ((OutHandles.Num() < MaxMessages) && Messages.Dequeue(Message))
+	{
+		OutHandles.Add(Store.Add(Message.InstanceName, Message.Text, Message.Verbosity, Message.Category, Message.TimeSeconds, Message.Time));
+	}
+
+	NumDrained += OutHandles.Num();
+
+	// measured here rather than per message, so producers pay nothing for it
+	const double CurrentTime = FPlatformTime::Seconds();
+
+	if (CurrentTime - WindowStartTime >= ThroughputWindow)
+	{
+		const int64 NumDrainedInWindow = NumDrained - WindowStartDrained;
+
+		if (NumDrainedInWindow > 0)
+		{
+			const double MessagesPerSecond = NumDrainedInWindow / (CurrentTime - WindowStartTime);
+
+			UE_LOG(LogPakMgr, Verbose, TEXT("%s ingested %lld log messages at %.0f per second, %lld in total"), *Name, NumDrainedInWindow, MessagesPerSecond, NumDrained);
+		}
+
+		WindowStartTime = CurrentTime;
+		WindowStartDrained = NumDrained;
+	}
+
+	return OutHandles.Num();
+}
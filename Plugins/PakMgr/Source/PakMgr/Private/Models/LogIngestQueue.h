@@ -0,0 +1,87 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Models/LogStore.h"
+
+/** A message waiting in an FPakMgrLogIngestQueue. */
+struct FPakMgrLogIngestMessage
+{
+	FString InstanceName;
+	FString Text;
+	FName Category;
+	FDateTime Time;
+	double TimeSeconds;
+	ELogVerbosity::Type Verbosity;
+
+	FPakMgrLogIngestMessage()
+		: TimeSeconds(0.0)
+		, Verbosity(ELogVerbosity::Log)
+	{ }
+};
+
+/**
+ * Collects log messages from any thread until a panel takes them into its log store.
+ *
+ * Producers push into a lock-free queue and never wait on the panel or on each other. The panel
+ * drains the queue once per frame from the core ticker, which also runs while its tab is hidden,
+ * so a burst of messages costs one list refresh per frame instead of one per message. The queue
+ * reports how many messages it passes per second to the Verbose log.
+ */
+class FPakMgrLogIngestQueue
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InName The name used when reporting throughput.
+	 */
+	explicit FPakMgrLogIngestQueue(const FString& InName);
+
+public:
+
+	/**
+	 * Queues a message, may be called from any thread.
+	 *
+	 * @param InstanceName The name of the instance that generated the message.
+	 * @param Text The message text.
+	 * @param Verbosity The verbosity type.
+	 * @param Category The log category.
+	 * @param TimeSeconds The number of seconds from the start of the instance at which the message was generated.
+	 */
+	void Enqueue(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity, FName Category, double TimeSeconds);
+
+	/** Queues a copy of a message, may be called from any thread. */
+	void Enqueue(const FFileItemInfo& Message);
+
+	/**
+	 * Moves queued messages into a log store, only called by the consumer.
+	 *
+	 * @param Store The store to add the messages to.
+	 * @param OutHandles Will hold the handles of the added messages, oldest first. Messages added early in a
+	 *        large batch may already have been dropped by the store.
+	 * @param MaxMessages The maximum number of messages to move, the rest stays queued for the next call.
+	 * @return The number of messages moved.
+	 */
+	int32 Drain(FPakMgrLogStore& Store, TArray<FPakMgrLogHandle>& OutHandles, int32 MaxMessages = MAX_int32);
+
+private:
+
+	/** Holds the queued messages. */
+	TQueue<FPakMgrLogIngestMessage, EQueueMode::Mpsc> Messages;
+
+	/** Holds the name used when reporting throughput. */
+	FString Name;
+
+	/** Holds the number of messages drained so far. */
+	int64 NumDrained;
+
+	/** Holds the time at which the current throughput measurement started. */
+	double WindowStartTime;
+
+	/** Holds the value of NumDrained when the current throughput measurement started. */
+	int64 WindowStartDrained;
+};
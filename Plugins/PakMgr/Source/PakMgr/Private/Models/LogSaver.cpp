@@ -0,0 +1,166 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/LogSaver.h"
+#include "Containers/Ticker.h"
+#include "DesktopPlatformModule.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "Misc/MessageDialog.h"
+#include "Misc/Paths.h"
+#include "Widgets/Notifications/SNotificationList.h"
+
+
+#define LOCTEXT_NAMESPACE "PakMgrLogSaver"
+
+
+/* FPakMgrLogSaver structors
+ *****************************************************************************/
+
+FPakMgrLogSaver::~FPakMgrLogSaver()
+{
+	FTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+
+	if (Notification.IsValid())
+	{
+		Notification->ExpireAndFadeout();
+	}
+}
+
+
+/* FPakMgrLogSaver interface
+ *****************************************************************************/
+
+void FPakMgrLogSaver::SaveLog(const TSharedRef<SWidget>& ParentWidget, const FPakMgrLogStore& Store, const TArray<FPakMgrLogHandle>& Handles)
+{
+	// one file at a time
+	if (Exporter.IsValid())
+	{
+		return;
+	}
+
+	IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+
+	if (DesktopPlatform == nullptr)
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("SaveLogDialogUnsupportedError", "Saving is not supported on this platform!"));
+
+		return;
+	}
+
+	TArray<FString> Filenames;
+
+	// open file dialog
+	TSharedPtr<SWindow> ParentWindow = FSlateApplication::Get().FindWidgetWindow(ParentWidget);
+	void* ParentWindowHandle = (ParentWindow.IsValid() && ParentWindow->GetNativeWindow().IsValid()) ? ParentWindow->GetNativeWindow()->GetOSWindowHandle() : nullptr;
+
+	if (!DesktopPlatform->SaveFileDialog(
+		ParentWindowHandle,
+		LOCTEXT("SaveLogDialogTitle", "Save Log As...").ToString(),
+		LastDirectory,
+		TEXT("Session.log"),
+		TEXT("Log Files (*.log)|*.log|Compressed Log Files (*.log.gz)|*.log.gz|JSON Lines (*.jsonl)|*.jsonl|Compressed JSON Lines (*.jsonl.gz)|*.jsonl.gz"),
+		EFileDialogFlags::None,
+		Filenames))
+	{
+		return;
+	}
+
+	// no log file selected?
+	if (Filenames.Num() == 0)
+	{
+		return;
+	}
+
+	FString Filename = Filenames[0];
+
+	// keep path as default for next time
+	LastDirectory = FPaths::GetPath(Filename);
+
+	// add a file extension if none was provided
+	if (FPaths::GetExtension(Filename).IsEmpty())
+	{
+		Filename += TEXT(".log");
+	}
+
+	// the messages are copied now, so the log may change while the file is written
+	Exporter = MakeShareable(new FPakMgrLogExporter(Filename));
+	Exporter->AddMessages(Store, Handles);
+	FPakMgrLogExporter::Start(Exporter.ToSharedRef());
+	bCanceled = false;
+
+	FNotificationInfo NotificationInfo(FText::Format(LOCTEXT("SaveLogProgress", "Saving {0}... {1}"), FText::FromString(FPaths::GetCleanFilename(Filename)), FText::AsPercent(0.0f)));
+	NotificationInfo.bFireAndForget = false;
+	NotificationInfo.ExpireDuration = 3.0f;
+	NotificationInfo.ButtonDetails.Add(FNotificationButtonInfo(
+		LOCTEXT("SaveLogCancelButton", "Cancel"),
+		LOCTEXT("SaveLogCancelButtonTooltip", "Stop saving, no file is written"),
+		FSimpleDelegate::CreateSP(this, &FPakMgrLogSaver::HandleCancelButtonClicked)));
+
+	Notification = FSlateNotificationManager::Get().AddNotification(NotificationInfo);
+
+	if (Notification.IsValid())
+	{
+		Notification->SetCompletionState(SNotificationItem::CS_Pending);
+	}
+
+	TickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &FPakMgrLogSaver::HandleTicker), 0.1f);
+}
+
+
+/* FPakMgrLogSaver event handlers
+ *****************************************************************************/
+
+void FPakMgrLogSaver::HandleCancelButtonClicked()
+{
+	if (Exporter.IsValid())
+	{
+		Exporter->Cancel();
+		bCanceled = true;
+	}
+}
+
+
+bool FPakMgrLogSaver::HandleTicker(float DeltaTime)
+{
+	const FText CleanFilename = FText::FromString(FPaths::GetCleanFilename(Exporter->GetFilename()));
+
+	if (!Exporter->IsFinished())
+	{
+		if (Notification.IsValid() && !bCanceled)
+		{
+			Notification->SetText(FText::Format(LOCTEXT("SaveLogProgress", "Saving {0}... {1}"), CleanFilename, FText::AsPercent(Exporter->GetProgress())));
+		}
+
+		return true;
+	}
+
+	if (Notification.IsValid())
+	{
+		if (Exporter->Succeeded())
+		{
+			Notification->SetText(FText::Format(LOCTEXT("SaveLogSucceeded", "Saved {0} messages to {1}"), FText::AsNumber(Exporter->GetNumMessages()), CleanFilename));
+			Notification->SetCompletionState(SNotificationItem::CS_Success);
+		}
+		else if (bCanceled)
+		{
+			Notification->SetText(FText::Format(LOCTEXT("SaveLogCanceled", "Canceled saving {0}"), CleanFilename));
+			Notification->SetCompletionState(SNotificationItem::CS_None);
+		}
+		else
+		{
+			Notification->SetText(FText::Format(LOCTEXT("SaveLogFailed", "Failed to save {0}, see the output log for details"), CleanFilename));
+			Notification->SetCompletionState(SNotificationItem::CS_Fail);
+		}
+
+		Notification->ExpireAndFadeout();
+		Notification.Reset();
+	}
+
+	Exporter.Reset();
+	TickerHandle.Reset();
+
+	return false;
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,67 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/LogExporter.h"
+#include "Models/LogStore.h"
+
+class SNotificationItem;
+class SWidget;
+
+/**
+ * Saves the listed log messages of a panel to a file the user picks.
+ *
+ * The file is written by an FPakMgrLogExporter on a worker thread. A notification shows the
+ * progress and offers to cancel the export; it is updated from the core ticker, so saving goes
+ * on while the panel's tab is hidden.
+ */
+class FPakMgrLogSaver
+	: public TSharedFromThis<FPakMgrLogSaver>
+{
+public:
+
+	/** Default constructor. */
+	FPakMgrLogSaver()
+		: bCanceled(false)
+	{ }
+
+	/** Destructor. A log being saved is still written, its result is reported to the output log. */
+	~FPakMgrLogSaver();
+
+public:
+
+	/**
+	 * Asks for a file name and starts saving messages to it, unless a file is still being saved.
+	 *
+	 * @param ParentWidget The widget whose window parents the file dialog.
+	 * @param Store The store holding the messages.
+	 * @param Handles The messages to save, in order.
+	 */
+	void SaveLog(const TSharedRef<SWidget>& ParentWidget, const FPakMgrLogStore& Store, const TArray<FPakMgrLogHandle>& Handles);
+
+private:
+
+	/** Callback for clicking the notification's 'Cancel' button. */
+	void HandleCancelButtonClicked();
+
+	/** Callback for reporting the progress of saving the log. */
+	bool HandleTicker(float DeltaTime);
+
+private:
+
+	/** Holds the directory where the log file was last saved to. */
+	FString LastDirectory;
+
+	/** Holds the log file being saved, if any. */
+	TSharedPtr<FPakMgrLogExporter, ESPMode::ThreadSafe> Exporter;
+
+	/** Holds the notification showing the progress of saving the log. */
+	TSharedPtr<SNotificationItem> Notification;
+
+	/** Holds the handle of the ticker reporting the progress. */
+	FDelegateHandle TickerHandle;
+
+	/** Holds a flag indicating whether the user canceled saving. */
+	bool bCanceled;
+};
@@ -0,0 +1,222 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/LogStore.h"
+#include "Misc/ConfigCacheIni.h"
+
+
+namespace LogStore
+{
+	/** Default memory limit, used unless configured otherwise. */
+	const int32 DefaultMemoryLimitMegabytes = 64;
+
+	/** Number of characters reserved for the texts of a new chunk. */
+	const int32 InitialTextPerChunk = FPakMgrLogStore::MessagesPerChunk * 64;
+}
+
+
+/* FPakMgrLogStore structors
+ *****************************************************************************/
+
+FPakMgrLogStore::FPakMgrLogStore(int64 InMemoryLimit)
+	: FirstChunkNumber(0)
+	, FirstSequence(0)
+	, NextSequence(0)
+	, FullChunksSize(0)
+	, MemoryLimit(InMemoryLimit)
+	, NumEvicted(0)
+{ }
+
+
+FPakMgrLogStore::~FPakMgrLogStore()
+{ }
+
+
+/* FPakMgrLogStore interface
+ *****************************************************************************/
+
+FPakMgrLogHandle FPakMgrLogStore::Add(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity, FName Category, double TimeSeconds, const FDateTime& Time)
+{
+	using namespace LogStore;
+
+	// start a new chunk every MessagesPerChunk messages
+	if ((Chunks.Num() == 0) || (Chunks.Last()->NumMessages == MessagesPerChunk))
+	{
+		if (Chunks.Num() > 0)
+		{
+			FullChunksSize += Chunks.Last()->GetAllocatedSize();
+		}
+		else
+		{
+			FirstChunkNumber = NextSequence / MessagesPerChunk;
+		}
+
+		TUniquePtr<FChunk> Chunk = MoveTemp(SpareChunk);
+
+		if (!Chunk.IsValid())
+		{
+			Chunk = MakeUnique<FChunk>();
+			Chunk->Text.Reserve(InitialTextPerChunk);
+		}
+
+		Chunks.Add(MoveTemp(Chunk));
+	}
+
+	FChunk& Chunk = *Chunks.Last();
+
+	int32* InstanceIndex = InstanceIndices.Find(InstanceName);
+
+	if (InstanceIndex == nullptr)
+	{
+		InstanceIndex = &InstanceIndices.Add(InstanceName, InstanceNames.Add(InstanceName));
+	}
+
+	int32* CategoryIndex = CategoryIndices.Find(Category);
+
+	if (CategoryIndex == nullptr)
+	{
+		CategoryIndex = &CategoryIndices.Add(Category, Categories.Add(Category));
+	}
+
+	const int32 RecordIndex = Chunk.NumMessages++;
+	Chunk.Ticks[RecordIndex] = Time.GetTicks();
+	Chunk.TimeSeconds[RecordIndex] = TimeSeconds;
+	Chunk.TextOffsets[RecordIndex] = Chunk.Text.Num();
+	Chunk.TextLengths[RecordIndex] = Text.Len();
+	Chunk.Nodes[RecordIndex] = INDEX_NONE;
+	Chunk.Depths[RecordIndex] = INDEX_NONE;
+	Chunk.InstanceIndices[RecordIndex] = *InstanceIndex;
+	Chunk.CategoryIndices[RecordIndex] = *CategoryIndex;
+	Chunk.Verbosities[RecordIndex] = (uint8)Verbosity;
+
+	// texts are null-terminated so they can be handed out without copying
+	Chunk.Text.Append(*Text, Text.Len());
+	Chunk.Text.Add(TEXT('\0'));
+
+	const FPakMgrLogHandle Handle(NextSequence++);
+
+	EnforceMemoryLimit();
+
+	return Handle;
+}
+
+
+FPakMgrLogHandle FPakMgrLogStore::Add(const FFileItemInfo& Message)
+{
+	const FPakMgrLogHandle Handle = Add(Message.InstanceName, Message.Text, Message.Verbosity, Message.Category, Message.TimeSeconds, Message.Time);
+
+	if (Message.Node != INDEX_NONE)
+	{
+		SetNode(Handle, Message.Node, Message.Depth);
+	}
+
+	return Handle;
+}
+
+
+void FPakMgrLogStore::Reset()
+{
+	Chunks.Empty();
+	SpareChunk.Reset();
+	InstanceNames.Empty();
+	InstanceIndices.Empty();
+	Categories.Empty();
+	CategoryIndices.Empty();
+	FullChunksSize = 0;
+
+	// continue at the next chunk, so old handles neither alias new messages nor share a chunk with them
+	NextSequence = FMath::DivideAndRoundUp<uint64>(NextSequence, MessagesPerChunk) * MessagesPerChunk;
+	FirstSequence = NextSequence;
+	FirstChunkNumber = NextSequence / MessagesPerChunk;
+}
+
+
+void FPakMgrLogStore::GetHandles(TArray<FPakMgrLogHandle>& OutHandles) const
+{
+	OutHandles.Reset(Num());
+
+	for (uint64 Sequence = FirstSequence; Sequence < NextSequence; ++Sequence)
+	{
+		OutHandles.Add(FPakMgrLogHandle(Sequence));
+	}
+}
+
+
+void FPakMgrLogStore::SetNode(FPakMgrLogHandle Handle, int32 Node, int32 Depth)
+{
+	FChunk& Chunk = GetChunk(Handle);
+	Chunk.Nodes[GetRecordIndex(Handle)] = Node;
+	Chunk.Depths[GetRecordIndex(Handle)] = Depth;
+}
+
+
+int64 FPakMgrLogStore::GetAllocatedSize() const
+{
+	int64 Size = FullChunksSize + Chunks.GetAllocatedSize() + InstanceNames.GetAllocatedSize() + InstanceIndices.GetAllocatedSize() + Categories.GetAllocatedSize() + CategoryIndices.GetAllocatedSize();
+
+	if (Chunks.Num() > 0)
+	{
+		Size += Chunks.Last()->GetAllocatedSize();
+	}
+
+	if (SpareChunk.IsValid())
+	{
+		Size += SpareChunk->GetAllocatedSize();
+	}
+
+	for (const FString& InstanceName : InstanceNames)
+	{
+		Size += InstanceName.GetAllocatedSize();
+	}
+
+	return Size;
+}
+
+
+void FPakMgrLogStore::SetMemoryLimit(int64 InMemoryLimit)
+{
+	MemoryLimit = InMemoryLimit;
+
+	EnforceMemoryLimit();
+}
+
+
+int64 FPakMgrLogStore::GetConfiguredMemoryLimit()
+{
+	int32 MemoryLimitMegabytes = LogStore::DefaultMemoryLimitMegabytes;
+
+	if (GConfig != nullptr)
+	{
+		GConfig->GetInt(TEXT("PakMgr"), TEXT("LogMemoryLimitMegabytes"), MemoryLimitMegabytes, GEditorPerProjectIni);
+	}
+
+	return (int64)FMath::Max(MemoryLimitMegabytes, 1) << 20;
+}
+
+
+/* FPakMgrLogStore implementation
+ *****************************************************************************/
+
+void FPakMgrLogStore::EnforceMemoryLimit()
+{
+	// the chunk being filled is kept, so the latest messages are always there
+	while ((Chunks.Num() > 1) && (GetAllocatedSize() > MemoryLimit))
+	{
+		TUniquePtr<FChunk> Chunk = MoveTemp(Chunks[0]);
+		Chunks.RemoveAt(0, 1, false);
+
+		FullChunksSize -= Chunk->GetAllocatedSize();
+		NumEvicted += Chunk->NumMessages;
+		FirstSequence += Chunk->NumMessages;
+		++FirstChunkNumber;
+
+		// keep one chunk around for the next one, unless that alone breaks the limit
+		Chunk->NumMessages = 0;
+		Chunk->Text.Reset();
+		SpareChunk.Reset();
+
+		if (GetAllocatedSize() + Chunk->GetAllocatedSize() <= MemoryLimit)
+		{
+			SpareChunk = MoveTemp(Chunk);
+		}
+	}
+}
@@ -0,0 +1,353 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+#include "Models/FileItemInfo.h"
+
+/**
+ * Identifies a message in an FPakMgrLogStore.
+ *
+ * Handles are sequence numbers that are never reused, so a handle to an evicted or cleared
+ * message stays invalid instead of pointing at a newer one.
+ */
+struct FPakMgrLogHandle
+{
+	/** Holds the message's sequence number, MAX_uint64 if unset. */
+	uint64 Sequence;
+
+public:
+
+	/** Creates an unset handle. */
+	FPakMgrLogHandle()
+		: Sequence(MAX_uint64)
+	{ }
+
+	/** Creates a handle to a sequence number. */
+	explicit FPakMgrLogHandle(uint64 InSequence)
+		: Sequence(InSequence)
+	{ }
+
+	/** Checks whether the handle was set, it may still refer to an evicted message. */
+	bool IsSet() const
+	{
+		return Sequence != MAX_uint64;
+	}
+
+	bool operator==(const FPakMgrLogHandle& Other) const
+	{
+		return Sequence == Other.Sequence;
+	}
+
+	bool operator!=(const FPakMgrLogHandle& Other) const
+	{
+		return Sequence != Other.Sequence;
+	}
+
+	friend uint32 GetTypeHash(const FPakMgrLogHandle& Handle)
+	{
+		return GetTypeHash(Handle.Sequence);
+	}
+};
+
+/**
+ * Ring buffer of log messages with a memory cap.
+ *
+ * Messages are packed into chunks of a fixed number of messages. A chunk stores each field in
+ * its own column, so scans over one field touch only that field, and keeps the texts of its
+ * messages back to back in one buffer. Category and instance names are interned, so a message
+ * costs a few column entries and its text, instead of a shared object with three strings.
+ * Once the store grows beyond its memory limit, the oldest chunks are dropped.
+ *
+ * A handle is found in constant time: its sequence number divided by the chunk size is the
+ * chunk, the remainder the record. Not thread-safe, though concurrent reads are.
+ */
+class FPakMgrLogStore
+{
+public:
+
+	/** Number of messages per chunk, the granularity of eviction. */
+	static const int32 MessagesPerChunk = 4096;
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InMemoryLimit The number of bytes beyond which the oldest messages are dropped.
+	 */
+	explicit FPakMgrLogStore(int64 InMemoryLimit = GetConfiguredMemoryLimit());
+
+	~FPakMgrLogStore();
+
+public:
+
+	/**
+	 * Adds a message.
+	 *
+	 * @param InstanceName The name of the instance that generated the message.
+	 * @param Text The message text.
+	 * @param Verbosity The verbosity type.
+	 * @param Category The log category.
+	 * @param TimeSeconds The number of seconds from the start of the instance at which the message was generated.
+	 * @param Time The time at which the message was generated.
+	 * @return The message's handle.
+	 */
+	FPakMgrLogHandle Add(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity, FName Category, double TimeSeconds, const FDateTime& Time);
+
+	/** Adds a copy of a message. */
+	FPakMgrLogHandle Add(const FFileItemInfo& Message);
+
+	/** Drops all messages, their handles stay invalid. */
+	void Reset();
+
+	/** Checks whether a handle refers to a message that is still in the store. */
+	bool Contains(FPakMgrLogHandle Handle) const
+	{
+		return (Handle.Sequence >= FirstSequence) && (Handle.Sequence < NextSequence);
+	}
+
+	/** Gets the number of messages in the store. */
+	int32 Num() const
+	{
+		return (int32)(NextSequence - FirstSequence);
+	}
+
+	/** Gets the handle of the oldest message, which is also the end if the store is empty. */
+	FPakMgrLogHandle GetFirst() const
+	{
+		return FPakMgrLogHandle(FirstSequence);
+	}
+
+	/** Gets the handle the next message will get. */
+	FPakMgrLogHandle GetEnd() const
+	{
+		return FPakMgrLogHandle(NextSequence);
+	}
+
+	/**
+	 * Gets the handles of all messages, oldest first.
+	 *
+	 * @param OutHandles Will hold the handles.
+	 */
+	void GetHandles(TArray<FPakMgrLogHandle>& OutHandles) const;
+
+	/** Gets the number of messages dropped to stay within the memory limit. */
+	uint64 GetNumEvicted() const
+	{
+		return NumEvicted;
+	}
+
+public:
+
+	/**
+	 * Gets a message's null-terminated text.
+	 *
+	 * The text moves when a message is added, so the pointer is only valid until then.
+	 */
+	const TCHAR* GetText(FPakMgrLogHandle Handle) const
+	{
+		const FChunk& Chunk = GetChunk(Handle);
+
+		return Chunk.Text.GetData() + Chunk.TextOffsets[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the length of a message's text. */
+	int32 GetTextLen(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).TextLengths[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the name of the instance that generated a message. */
+	const FString& GetInstanceName(FPakMgrLogHandle Handle) const
+	{
+		return InstanceNames[GetInstanceIndex(Handle)];
+	}
+
+	/** Gets the interned index of the instance that generated a message, ordered as first seen. */
+	int32 GetInstanceIndex(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).InstanceIndices[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the number of distinct instance names. */
+	int32 GetNumInstanceNames() const
+	{
+		return InstanceNames.Num();
+	}
+
+	/** Gets an interned instance name. */
+	const FString& GetInstanceNameByIndex(int32 InstanceIndex) const
+	{
+		return InstanceNames[InstanceIndex];
+	}
+
+	/** Gets a message's log category. */
+	FName GetCategory(FPakMgrLogHandle Handle) const
+	{
+		return Categories[GetCategoryIndex(Handle)];
+	}
+
+	/** Gets the interned index of a message's log category. */
+	int32 GetCategoryIndex(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).CategoryIndices[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the number of distinct log categories. */
+	int32 GetNumCategories() const
+	{
+		return Categories.Num();
+	}
+
+	/** Gets an interned log category. */
+	FName GetCategoryByIndex(int32 CategoryIndex) const
+	{
+		return Categories[CategoryIndex];
+	}
+
+	/** Gets a message's verbosity. */
+	ELogVerbosity::Type GetVerbosity(FPakMgrLogHandle Handle) const
+	{
+		return (ELogVerbosity::Type)GetChunk(Handle).Verbosities[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the number of seconds from the start of the instance at which a message was generated. */
+	double GetTimeSeconds(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).TimeSeconds[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the time at which a message was generated. */
+	FDateTime GetTime(FPakMgrLogHandle Handle) const
+	{
+		return FDateTime(GetChunk(Handle).Ticks[GetRecordIndex(Handle)]);
+	}
+
+	/** Gets the graph node of a listed package, INDEX_NONE for log messages. */
+	int32 GetNode(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).Nodes[GetRecordIndex(Handle)];
+	}
+
+	/** Gets the breadth-first depth of a listed package in its module, INDEX_NONE for log messages. */
+	int32 GetDepth(FPakMgrLogHandle Handle) const
+	{
+		return GetChunk(Handle).Depths[GetRecordIndex(Handle)];
+	}
+
+	/** Sets the graph node and depth of a listed package. */
+	void SetNode(FPakMgrLogHandle Handle, int32 Node, int32 Depth);
+
+public:
+
+	/** Gets the number of bytes held by messages and names. */
+	int64 GetAllocatedSize() const;
+
+	/** Gets the memory limit in bytes. */
+	int64 GetMemoryLimit() const
+	{
+		return MemoryLimit;
+	}
+
+	/**
+	 * Sets the memory limit, dropping the oldest messages if the store is beyond it.
+	 *
+	 * The newest chunk is never dropped, so the store may exceed a very small limit by one chunk.
+	 *
+	 * @param InMemoryLimit The limit in bytes.
+	 */
+	void SetMemoryLimit(int64 InMemoryLimit);
+
+	/** Gets the memory limit configured by LogMemoryLimitMegabytes in the [PakMgr] editor settings. */
+	static int64 GetConfiguredMemoryLimit();
+
+private:
+
+	/** A fixed number of messages, one column per field, and their texts. */
+	struct FChunk
+	{
+		int64 Ticks[MessagesPerChunk];
+		double TimeSeconds[MessagesPerChunk];
+		int32 TextOffsets[MessagesPerChunk];
+		int32 TextLengths[MessagesPerChunk];
+		int32 Nodes[MessagesPerChunk];
+		int32 Depths[MessagesPerChunk];
+		int32 InstanceIndices[MessagesPerChunk];
+		int32 CategoryIndices[MessagesPerChunk];
+		uint8 Verbosities[MessagesPerChunk];
+		TArray<TCHAR> Text;
+		int32 NumMessages;
+
+		FChunk()
+			: NumMessages(0)
+		{ }
+
+		int64 GetAllocatedSize() const
+		{
+			return sizeof(FChunk) + Text.GetAllocatedSize();
+		}
+	};
+
+	/** Gets the chunk holding a message. */
+	const FChunk& GetChunk(FPakMgrLogHandle Handle) const
+	{
+		check(Contains(Handle));
+
+		return *Chunks[(int32)(Handle.Sequence / MessagesPerChunk - FirstChunkNumber)];
+	}
+
+	/** Gets the chunk holding a message, for changing it. */
+	FChunk& GetChunk(FPakMgrLogHandle Handle)
+	{
+		check(Contains(Handle));
+
+		return *Chunks[(int32)(Handle.Sequence / MessagesPerChunk - FirstChunkNumber)];
+	}
+
+	/** Gets a message's index in its chunk. */
+	static int32 GetRecordIndex(FPakMgrLogHandle Handle)
+	{
+		return (int32)(Handle.Sequence % MessagesPerChunk);
+	}
+
+	/** Drops the oldest chunks until the store is within its memory limit. */
+	void EnforceMemoryLimit();
+
+private:
+
+	/** Holds the chunks, oldest first. */
+	TArray<TUniquePtr<FChunk>> Chunks;
+
+	/** Holds the chunk number of the oldest chunk, i.e. the sequence number of its first message divided by the chunk size. */
+	uint64 FirstChunkNumber;
+
+	/** Holds the sequence number of the oldest message. */
+	uint64 FirstSequence;
+
+	/** Holds the sequence number of the next message. */
+	uint64 NextSequence;
+
+	/** Holds the number of bytes held by all chunks but the newest. */
+	int64 FullChunksSize;
+
+	/** Holds the memory limit in bytes. */
+	int64 MemoryLimit;
+
+	/** Holds the number of messages dropped to stay within the memory limit. */
+	uint64 NumEvicted;
+
+	/** Holds the interned instance names. */
+	TArray<FString> InstanceNames;
+
+	/** Holds the index of each interned instance name. */
+	TMap<FString, int32> InstanceIndices;
+
+	/** Holds the interned log categories. */
+	TArray<FName> Categories;
+
+	/** Holds the index of each interned log category. */
+	TMap<FName, int32> CategoryIndices;
+
+	/** Holds a dropped chunk for reuse, so a full store does not reallocate every chunk. */
+	TUniquePtr<FChunk> SpareChunk;
+};
@@ -0,0 +1,138 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/LogTableModel.h"
+#include "Misc/Paths.h"
+#include "FileTree/SFileTreeItemTableRow.h"
+
+
+namespace LogTableModel
+{
+	/** Column names, as used by the list views' header rows. */
+	const FName InstanceColumn("Instance");
+	const FName MessageColumn("Message");
+	const FName NameColumn("Name");
+	const FName TimeSecondsColumn("TimeSeconds");
+
+	/** Gets a message's text on a single line, line breaks shown as separators. */
+	FString GetSingleLineText(const TCHAR* Text, int32 TextLength)
+	{
+		FString Result;
+		Result.Reserve(TextLength);
+
+		for (int32 Index = 0; Index < TextLength; ++Index)
+		{
+			if (Text[Index] == TEXT('\n'))
+			{
+				Result += TEXT(" | ");
+			}
+			else if (Text[Index] != TEXT('\r'))
+			{
+				Result.AppendChar(Text[Index]);
+			}
+		}
+
+		return Result;
+	}
+}
+
+
+/* FPakMgrLogTableModel structors
+ *****************************************************************************/
+
+FPakMgrLogTableModel::FPakMgrLogTableModel(const TSharedRef<FPakMgrLogStore>& InStore)
+	: Store(InStore)
+	, NumCreatedRows(0)
+{ }
+
+
+/* FPakMgrLogTableModel interface
+ *****************************************************************************/
+
+FText FPakMgrLogTableModel::GetCellText(FPakMgrLogHandle Handle, const FName& ColumnName) const
+{
+	using namespace LogTableModel;
+
+	if (!Store->Contains(Handle))
+	{
+		return FText::GetEmpty();
+	}
+
+	if (ColumnName == MessageColumn)
+	{
+		return FText::FromString(GetSingleLineText(Store->GetText(Handle), Store->GetTextLen(Handle)));
+	}
+	else if (ColumnName == InstanceColumn)
+	{
+		return FText::FromString(Store->GetInstanceName(Handle));
+	}
+	else if (ColumnName == TimeSecondsColumn)
+	{
+		static const FNumberFormattingOptions FormatOptions = FNumberFormattingOptions()
+			.SetMinimumFractionalDigits(3)
+			.SetMaximumFractionalDigits(3);
+
+		return FText::AsNumber(Store->GetTimeSeconds(Handle), &FormatOptions);
+	}
+	else if (ColumnName == NameColumn)
+	{
+		return FText::FromString(FPaths::GetCleanFilename(Store->GetText(Handle)));
+	}
+
+	return FText::GetEmpty();
+}
+
+
+FText FPakMgrLogTableModel::GetToolTipText(FPakMgrLogHandle Handle) const
+{
+	return Store->Contains(Handle) ? FText::FromString(Store->GetText(Handle)) : FText::GetEmpty();
+}
+
+
+FLinearColor FPakMgrLogTableModel::GetInstanceColor(FPakMgrLogHandle Handle) const
+{
+	const uint32 Hash = Store->Contains(Handle) ? GetTypeHash(Store->GetInstanceName(Handle)) : 0;
+
+	return FLinearColor((Hash & 0xff) * 360.0f / 256.0f, 0.8f, 0.3f, 1.0f).HSVToLinearRGB();
+}
+
+
+FSlateColor FPakMgrLogTableModel::GetVerbosityColor(ELogVerbosity::Type Verbosity)
+{
+	if ((Verbosity == ELogVerbosity::Error) ||
+		(Verbosity == ELogVerbosity::Fatal))
+	{
+		return FLinearColor::Red;
+	}
+	else if (Verbosity == ELogVerbosity::Warning)
+	{
+		return FLinearColor::Yellow;
+	}
+
+	return FSlateColor::UseForeground();
+}
+
+
+TSharedRef<ITableRow> FPakMgrLogTableModel::GenerateRow(FPakMgrLogHandle Handle, const TSharedRef<STableViewBase>& OwnerTable, const TAttribute<FText>& HighlightText)
+{
+	if (FreeRows.Num() > 0)
+	{
+		TSharedRef<SFileTreeitemTableRow> Row = FreeRows.Pop(false);
+		Row->SetHandle(Handle);
+
+		return Row;
+	}
+
+	++NumCreatedRows;
+
+	return SNew(SFileTreeitemTableRow, OwnerTable)
+		.HighlightText(HighlightText)
+		.Model(AsShared())
+		.Handle(Handle);
+}
+
+
+void FPakMgrLogTableModel::ReleaseRow(const TSharedRef<ITableRow>& Row)
+{
+	// every row of the list view was made by GenerateRow
+	FreeRows.Add(StaticCastSharedRef<SFileTreeitemTableRow>(Row->AsWidget()));
+}
@@ -0,0 +1,103 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/Attribute.h"
+#include "Styling/SlateColor.h"
+#include "Models/LogStore.h"
+
+class ITableRow;
+class SFileTreeitemTableRow;
+class STableViewBase;
+
+/**
+ * Table model shared by the PakMgr list views, which list handles into a log store.
+ *
+ * The model turns a message's fields into what the columns show. Only rows on screen ask for
+ * their cells, and a row asks once when it is bound to a message, not every frame. Rows the list
+ * view releases after scrolling are kept and bound to the next messages that come into view, so
+ * scrolling neither creates nor destroys widgets once the visible rows exist.
+ *
+ * A model serves a single list view. Rows keep the model alive only weakly.
+ */
+class FPakMgrLogTableModel
+	: public TSharedFromThis<FPakMgrLogTableModel>
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InStore The store holding the listed messages.
+	 */
+	explicit FPakMgrLogTableModel(const TSharedRef<FPakMgrLogStore>& InStore);
+
+public:
+
+	/** Gets the store holding the listed messages. */
+	const TSharedRef<FPakMgrLogStore>& GetStore() const
+	{
+		return Store;
+	}
+
+	/**
+	 * Switches to another store, its handles may collide with the previous store's.
+	 *
+	 * The list view must be rebuilt afterwards, so no row stays bound to the previous store.
+	 */
+	void SetStore(const TSharedRef<FPakMgrLogStore>& InStore)
+	{
+		Store = InStore;
+	}
+
+	/**
+	 * Gets the text of a cell.
+	 *
+	 * @param Handle The message listed in the row.
+	 * @param ColumnName The column, as named in the list view's header row.
+	 * @return The text, empty for columns that show no text or messages no longer in the store.
+	 */
+	FText GetCellText(FPakMgrLogHandle Handle, const FName& ColumnName) const;
+
+	/** Gets the tool tip text of a row, or empty if the message is no longer in the store. */
+	FText GetToolTipText(FPakMgrLogHandle Handle) const;
+
+	/** Gets the color of a message's instance, the same for every message of the instance. */
+	FLinearColor GetInstanceColor(FPakMgrLogHandle Handle) const;
+
+	/** Gets the text color of a message's verbosity. */
+	static FSlateColor GetVerbosityColor(ELogVerbosity::Type Verbosity);
+
+public:
+
+	/**
+	 * Gets a row for a message, recycling a released row if there is one.
+	 *
+	 * @param Handle The message to show.
+	 * @param OwnerTable The list view, which must be the same for every call.
+	 * @param HighlightText The highlight string, only used for new rows.
+	 * @return The row.
+	 */
+	TSharedRef<ITableRow> GenerateRow(FPakMgrLogHandle Handle, const TSharedRef<STableViewBase>& OwnerTable, const TAttribute<FText>& HighlightText);
+
+	/** Keeps a row the list view released for the next GenerateRow. */
+	void ReleaseRow(const TSharedRef<ITableRow>& Row);
+
+	/** Gets the number of rows created so far, recycled ones included. */
+	int32 GetNumCreatedRows() const
+	{
+		return NumCreatedRows;
+	}
+
+private:
+
+	/** Holds the store holding the listed messages. */
+	TSharedRef<FPakMgrLogStore> Store;
+
+	/** Holds the rows released by the list view. */
+	TArray<TSharedRef<SFileTreeitemTableRow>> FreeRows;
+
+	/** Holds the number of rows created so far. */
+	int32 NumCreatedRows;
+};
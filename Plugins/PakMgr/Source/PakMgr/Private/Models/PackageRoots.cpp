@@ -0,0 +1,249 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/PackageRoots.h"
+#include "Misc/App.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+
+
+/* FPakMgrPackageRoots static functions
+ *****************************************************************************/
+
+FPakMgrPackageRoots& FPakMgrPackageRoots::Get()
+{
+	static FPakMgrPackageRoots Instance;
+	return Instance;
+}
+
+
+/* FPakMgrPackageRoots interface
+ *****************************************************************************/
+
+void FPakMgrPackageRoots::Initialize()
+{
+	FPackageName::OnContentPathDismounted().AddRaw(this, &FPakMgrPackageRoots::HandleContentPathDismounted);
+}
+
+
+void FPakMgrPackageRoots::Shutdown()
+{
+	FPackageName::OnContentPathDismounted().RemoveAll(this);
+
+	FRWScopeLock ScopeLock(TablesLock, SLT_Write);
+
+	Roots.Empty();
+	RootIndices.Empty();
+	PackageRootIndices.Empty();
+}
+
+
+EPakMgrPackageRoot FPakMgrPackageRoots::Classify(FName PackageName)
+{
+	FRWScopeLock ScopeLock(TablesLock, SLT_ReadOnly);
+
+	const int32 RootIndex = FindPackageRoot(PackageName, ScopeLock);
+
+	return (RootIndex != INDEX_NONE) ? Roots[RootIndex].Kind : EPakMgrPackageRoot::Unknown;
+}
+
+
+bool FPakMgrPackageRoots::HasValidRoot(const FString& Path)
+{
+	FString RootName = GetRootName(Path);
+
+	// a bare root like /Game is valid as well
+	if (RootName.IsEmpty() && (Path.Len() > 1) && (Path[0] == TEXT('/')))
+	{
+		RootName = Path / TEXT("");
+	}
+
+	if (RootName.IsEmpty())
+	{
+		return false;
+	}
+
+	FRWScopeLock ScopeLock(TablesLock, SLT_ReadOnly);
+
+	const int32* CachedRootIndex = RootIndices.Find(RootName);
+	int32 RootIndex = (CachedRootIndex != nullptr) ? *CachedRootIndex : INDEX_NONE;
+
+	if (RootIndex == INDEX_NONE)
+	{
+		ScopeLock.ReleaseReadOnlyLockAndAcquireWriteLock_USE_WITH_CAUTION();
+		RootIndex = FindOrAddRoot(RootName);
+	}
+
+	return (RootIndex != INDEX_NONE) && !Roots[RootIndex].ContentDirectory.IsEmpty();
+}
+
+
+bool FPakMgrPackageRoots::TryConvertToFilename(FName PackageName, FString& OutFilename)
+{
+	FRWScopeLock ScopeLock(TablesLock, SLT_ReadOnly);
+
+	const int32 RootIndex = FindPackageRoot(PackageName, ScopeLock);
+
+	if ((RootIndex == INDEX_NONE) || Roots[RootIndex].ContentDirectory.IsEmpty())
+	{
+		return false;
+	}
+
+	const FRoot& Root = Roots[RootIndex];
+	OutFilename = Root.ContentDirectory + PackageName.ToString().RightChop(Root.Name.Len());
+
+	return true;
+}
+
+
+bool FPakMgrPackageRoots::TryConvertToCookedFilename(FName PackageName, FString& OutFilename)
+{
+	FRWScopeLock ScopeLock(TablesLock, SLT_ReadOnly);
+
+	const int32 RootIndex = FindPackageRoot(PackageName, ScopeLock);
+
+	if ((RootIndex == INDEX_NONE) || Roots[RootIndex].CookedDirectory.IsEmpty())
+	{
+		return false;
+	}
+
+	const FRoot& Root = Roots[RootIndex];
+	OutFilename = Root.CookedDirectory + PackageName.ToString().RightChop(Root.Name.Len());
+
+	return true;
+}
+
+
+/* FPakMgrPackageRoots implementation
+ *****************************************************************************/
+
+int32 FPakMgrPackageRoots::FindPackageRoot(FName PackageName, FRWScopeLock& ScopeLock)
+{
+	if (const int32* RootIndex = PackageRootIndices.Find(PackageName))
+	{
+		return *RootIndex;
+	}
+
+	// the tables may change while the lock is upgraded, so the package is looked up again
+	ScopeLock.ReleaseReadOnlyLockAndAcquireWriteLock_USE_WITH_CAUTION();
+
+	return FindOrAddPackageRoot(PackageName);
+}
+
+
+int32 FPakMgrPackageRoots::FindOrAddPackageRoot(FName PackageName)
+{
+	if (const int32* RootIndex = PackageRootIndices.Find(PackageName))
+	{
+		return *RootIndex;
+	}
+
+	const int32 RootIndex = FindOrAddRoot(GetRootName(PackageName.ToString()));
+
+	// unmounted roots are asked again, they may be mounted later
+	if (RootIndex != INDEX_NONE)
+	{
+		PackageRootIndices.Add(PackageName, RootIndex);
+	}
+
+	return RootIndex;
+}
+
+
+int32 FPakMgrPackageRoots::FindOrAddRoot(const FString& RootName)
+{
+	if (RootName.IsEmpty())
+	{
+		return INDEX_NONE;
+	}
+
+	if (const int32* RootIndex = RootIndices.Find(RootName))
+	{
+		return *RootIndex;
+	}
+
+	FRoot Root;
+	Root.Name = RootName;
+	Root.Kind = EPakMgrPackageRoot::Plugin;
+
+	if (RootName == TEXT("/Script/"))
+	{
+		Root.Kind = EPakMgrPackageRoot::Script;
+	}
+	else if ((RootName == TEXT("/Memory/")) || (RootName == TEXT("/Temp/")))
+	{
+		Root.Kind = EPakMgrPackageRoot::Transient;
+	}
+	else if (RootName == TEXT("/Game/"))
+	{
+		Root.Kind = EPakMgrPackageRoot::Game;
+	}
+	else if (RootName == TEXT("/Engine/"))
+	{
+		Root.Kind = EPakMgrPackageRoot::Engine;
+	}
+
+	FString ContentDirectory;
+
+	if (FPackageName::TryConvertLongPackageNameToFilename(RootName, ContentDirectory))
+	{
+		Root.ContentDirectory = FPaths::ConvertRelativePathToFull(ContentDirectory) / TEXT("");
+	}
+	else if (Root.Kind == EPakMgrPackageRoot::Plugin)
+	{
+		// an unknown root without files is not a root at all
+		return INDEX_NONE;
+	}
+
+	if (!Root.ContentDirectory.IsEmpty() && (Root.Kind != EPakMgrPackageRoot::Script) && (Root.Kind != EPakMgrPackageRoot::Transient))
+	{
+		// the cooker mirrors the project and engine directories below the cooked directory
+		const FString ProjectDir = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
+		const FString EngineDir = FPaths::ConvertRelativePathToFull(FPaths::EngineDir());
+
+		if (Root.ContentDirectory.StartsWith(ProjectDir))
+		{
+			Root.CookedDirectory = FString(FApp::GetProjectName()) / Root.ContentDirectory.RightChop(ProjectDir.Len());
+		}
+		else if (Root.ContentDirectory.StartsWith(EngineDir))
+		{
+			Root.CookedDirectory = FString(TEXT("Engine")) / Root.ContentDirectory.RightChop(EngineDir.Len());
+		}
+	}
+
+	const int32 RootIndex = Roots.Add(Root);
+	RootIndices.Add(RootName, RootIndex);
+
+	return RootIndex;
+}
+
+
+FString FPakMgrPackageRoots::GetRootName(const FString& Path)
+{
+	if ((Path.Len() < 2) || (Path[0] != TEXT('/')))
+	{
+		return FString();
+	}
+
+	int32 SlashIndex = INDEX_NONE;
+
+	if (!Path.RightChop(1).FindChar(TEXT('/'), SlashIndex))
+	{
+		return FString();
+	}
+
+	return Path.Left(SlashIndex + 2);
+}
+
+
+/* FPakMgrPackageRoots event handlers
+ *****************************************************************************/
+
+void FPakMgrPackageRoots::HandleContentPathDismounted(const FString& AssetPath, const FString& ContentPath)
+{
+	FRWScopeLock ScopeLock(TablesLock, SLT_Write);
+
+	// root indices of all cached packages would be stale, and dismounts are rare
+	Roots.Empty();
+	RootIndices.Empty();
+	PackageRootIndices.Empty();
+}
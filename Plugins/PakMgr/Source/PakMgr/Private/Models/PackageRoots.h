@@ -0,0 +1,169 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/ScopeRWLock.h"
+
+/** Kinds of mount roots a long package name can start with. */
+enum class EPakMgrPackageRoot : uint8
+{
+	/** Not a long package name, or its root is not mounted. */
+	Unknown,
+
+	/** Native packages below /Script/. */
+	Script,
+
+	/** Packages that only exist in memory, below /Memory/ or /Temp/. */
+	Transient,
+
+	/** Project content below /Game/. */
+	Game,
+
+	/** Engine content below /Engine/. */
+	Engine,
+
+	/** Content of any other mounted root, usually a plugin. */
+	Plugin
+};
+
+
+/**
+ * Classifies package names by their mount root.
+ *
+ * The root of every package name is looked up once and cached per FName, together with the
+ * content directory of the root, so classifying the packages of large dependency graphs never
+ * converts names to strings again. Roots that are not mounted yet are not cached, so plugins
+ * mounted later are picked up, and the cache is cleared whenever a content root is dismounted
+ * between Initialize and Shutdown.
+ *
+ * All methods are thread safe. Lookups of cached packages only take a read lock, so the workers
+ * gathering reference closures in parallel do not wait for each other.
+ */
+class FPakMgrPackageRoots
+{
+public:
+
+	/** Gets the classifier shared by PakMgr. */
+	static FPakMgrPackageRoots& Get();
+
+public:
+
+	/**
+	 * Starts clearing the cache whenever a content root is dismounted.
+	 *
+	 * Called by the module on startup. The shared instance is a function static, which is destroyed
+	 * too late to unbind delegates itself.
+	 *
+	 * @see Shutdown
+	 */
+	void Initialize();
+
+	/**
+	 * Stops watching content roots and empties the cache.
+	 *
+	 * Called by the module on shutdown.
+	 *
+	 * @see Initialize
+	 */
+	void Shutdown();
+
+public:
+
+	/**
+	 * Gets the mount root kind of a package.
+	 *
+	 * @param PackageName The long package name.
+	 * @return The root kind.
+	 */
+	EPakMgrPackageRoot Classify(FName PackageName);
+
+	/** Returns true if the package is a native /Script/ package. */
+	bool IsScriptPackage(FName PackageName)
+	{
+		return Classify(PackageName) == EPakMgrPackageRoot::Script;
+	}
+
+	/**
+	 * Checks whether a package or folder path starts with a mounted root.
+	 *
+	 * @param Path A long package name or package path, for example /Game or /Game/Maps/Entry.
+	 * @return true if the root is mounted.
+	 */
+	bool HasValidRoot(const FString& Path);
+
+	/**
+	 * Converts a package name to the full name of its file on disk, without extension.
+	 *
+	 * @param PackageName The long package name.
+	 * @param OutFilename Will hold the filename.
+	 * @return false if the package has no mounted content directory.
+	 */
+	bool TryConvertToFilename(FName PackageName, FString& OutFilename);
+
+	/**
+	 * Converts a package name to the name of its cooked file relative to the cooked directory, without extension.
+	 *
+	 * The cooker mirrors the project and engine directories below the cooked directory, for
+	 * example /Game/Maps/Entry becomes <Project>/Content/Maps/Entry.
+	 *
+	 * @param PackageName The long package name.
+	 * @param OutFilename Will hold the filename.
+	 * @return false if the package is not below the project or engine directory.
+	 */
+	bool TryConvertToCookedFilename(FName PackageName, FString& OutFilename);
+
+private:
+
+	/** A mount root. */
+	struct FRoot
+	{
+		/** Holds the root with leading and trailing slash, for example /Game/. */
+		FString Name;
+
+		/** Holds the root kind. */
+		EPakMgrPackageRoot Kind;
+
+		/** Holds the full content directory with trailing slash, empty for roots without files. */
+		FString ContentDirectory;
+
+		/** Holds the cooked directory relative to the cooked output, empty if the root is not cooked. */
+		FString CookedDirectory;
+	};
+
+	/**
+	 * Finds the root of a package, returns INDEX_NONE if it is not mounted.
+	 *
+	 * Expects a read lock to be held, which is upgraded to a write lock if the package is not cached yet.
+	 */
+	int32 FindPackageRoot(FName PackageName, FRWScopeLock& ScopeLock);
+
+	/** Finds the root of a package, returns INDEX_NONE if it is not mounted. Expects the write lock to be held. */
+	int32 FindOrAddPackageRoot(FName PackageName);
+
+	/** Finds or adds a root by name, returns INDEX_NONE if it is not mounted. Expects the write lock to be held. */
+	int32 FindOrAddRoot(const FString& RootName);
+
+	/** Gets the root part of a package name or path, empty if there is none. */
+	static FString GetRootName(const FString& Path);
+
+private:
+
+	/** Callback for dismounting a content root. */
+	void HandleContentPathDismounted(const FString& AssetPath, const FString& ContentPath);
+
+private:
+
+	/** Holds the roots seen so far. */
+	TArray<FRoot> Roots;
+
+	/** Maps root names to indices into Roots. */
+	TMap<FString, int32> RootIndices;
+
+	/** Maps package names to indices into Roots. */
+	TMap<FName, int32> PackageRootIndices;
+
+	/** Guards all tables. */
+	FRWLock TablesLock;
+};
@@ -0,0 +1,56 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/PakModuleInfo.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakModuleInfo interface
+ *****************************************************************************/
+
+void FPakModuleInfo::CreateModules(const FPakMgrDependencyGraphPtr& Graph, const TArray<FString>& MapFilenames, TArray<FPakModuleInfo>& OutModules)
+{
+	PAKMGR_TRACE_SCOPE(CreateModules);
+
+	OutModules.Reset();
+
+	TArray<int32> Roots;
+
+	for (const FString& MapFilename : MapFilenames)
+	{
+		FString PackageName;
+
+		if (!FPackageName::TryConvertFilenameToLongPackageName(MapFilename, PackageName))
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("GenRef: %s is not inside a mounted content directory"), *MapFilename);
+			continue;
+		}
+
+		const int32 Root = Graph->FindNode(FName(*PackageName));
+
+		if (Root == INDEX_NONE)
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("GenRef: %s is not known to the asset registry"), *PackageName);
+			continue;
+		}
+
+		FPakModuleInfo& Module = OutModules.AddDefaulted_GetRef();
+		Module.Name = FPaths::GetBaseFilename(MapFilename);
+		Module.MapFilename = MapFilename;
+		Module.RootPackage = FName(*PackageName);
+		Module.Graph = Graph;
+		Roots.Add(Root);
+	}
+
+	TArray<FPakMgrDependencyClosure> Closures;
+	FPakMgrDependencyClosure::ComputeParallel(*Graph, Roots, /*bIncludeSoft=*/true, Closures);
+
+	for (int32 ModuleIndex = 0; ModuleIndex < OutModules.Num(); ++ModuleIndex)
+	{
+		OutModules[ModuleIndex].Closure = MoveTemp(Closures[ModuleIndex]);
+
+		UE_LOG(LogPakMgr, Log, TEXT("GenRef: module %s references %d packages"), *OutModules[ModuleIndex].Name, OutModules[ModuleIndex].Closure.Nodes.Num());
+	}
+}
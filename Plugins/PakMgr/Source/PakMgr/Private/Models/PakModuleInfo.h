@@ -0,0 +1,42 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+#include "Models/DependencyClosure.h"
+
+/**
+ * Structure for a pak module, i.e. a map and everything it references.
+ */
+struct FPakModuleInfo
+{
+	/** Holds the module name, equal to the map's base file name. */
+	FString Name;
+
+	/** Holds the map file the module was added from. */
+	FString MapFilename;
+
+	/** Holds the long package name of the map. */
+	FName RootPackage;
+
+	/** Holds the graph snapshot the closure was computed on. */
+	FPakMgrDependencyGraphPtr Graph;
+
+	/** Holds the map's hard and soft dependency closure. */
+	FPakMgrDependencyClosure Closure;
+
+public:
+
+	/**
+	 * Creates the modules of a set of maps and computes their closures in parallel.
+	 *
+	 * The maps do not need to be loaded. Maps outside of the mounted content directories or unknown
+	 * to the graph are skipped with a warning.
+	 *
+	 * @param Graph The graph to compute the closures on.
+	 * @param MapFilenames The map files to create modules for.
+	 * @param OutModules Will hold the modules.
+	 */
+	static void CreateModules(const FPakMgrDependencyGraphPtr& Graph, const TArray<FString>& MapFilenames, TArray<FPakModuleInfo>& OutModules);
+};
@@ -0,0 +1,370 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/PathSearchIndex.h"
+#include "Misc/ScopeRWLock.h"
+
+
+namespace PathSearchIndex
+{
+	/** Number of results handed to the callback at once. */
+	static const int32 BatchSize = 256;
+
+	/** Number of paths Build adds per lock. */
+	static const int32 BuildChunkSize = 4096;
+
+	/** Removed paths are only compacted away beyond this many. */
+	static const int32 MinRemovedToCompact = 1024;
+
+	/** Intersects two sorted id lists. */
+	void Intersect(const TArray<int32>& A, const TArray<int32>& B, TArray<int32>& OutIds)
+	{
+		OutIds.Reset();
+
+		int32 IndexA = 0;
+		int32 IndexB = 0;
+
+		while ((IndexA < A.Num()) && (IndexB < B.Num()))
+		{
+			if (A[IndexA] < B[IndexB])
+			{
+				++IndexA;
+			}
+			else if (A[IndexA] > B[IndexB])
+			{
+				++IndexB;
+			}
+			else
+			{
+				OutIds.Add(A[IndexA]);
+				++IndexA;
+				++IndexB;
+			}
+		}
+	}
+}
+
+
+/* FPakMgrPathSearchIndex structors
+ *****************************************************************************/
+
+FPakMgrPathSearchIndex::FPakMgrPathSearchIndex()
+	: bIsBuilding(false)
+{ }
+
+
+/* FPakMgrPathSearchIndex interface
+ *****************************************************************************/
+
+void FPakMgrPathSearchIndex::BeginBuild()
+{
+	FRWScopeLock Lock(IndexLock, SLT_Write);
+
+	bIsBuilding = true;
+	RemovedWhileBuilding.Reset();
+}
+
+
+void FPakMgrPathSearchIndex::Build(const TArray<FName>& InPaths)
+{
+	using namespace PathSearchIndex;
+
+	for (int32 ChunkStart = 0; ChunkStart < InPaths.Num(); ChunkStart += BuildChunkSize)
+	{
+		FRWScopeLock Lock(IndexLock, SLT_Write);
+
+		const int32 ChunkEnd = FMath::Min(ChunkStart + BuildChunkSize, InPaths.Num());
+
+		for (int32 PathIndex = ChunkStart; PathIndex < ChunkEnd; ++PathIndex)
+		{
+			if (!RemovedWhileBuilding.Contains(InPaths[PathIndex]))
+			{
+				AddPathLocked(InPaths[PathIndex]);
+			}
+		}
+	}
+
+	FRWScopeLock Lock(IndexLock, SLT_Write);
+
+	bIsBuilding = false;
+	RemovedWhileBuilding.Empty();
+}
+
+
+void FPakMgrPathSearchIndex::AddPath(FName Path)
+{
+	FRWScopeLock Lock(IndexLock, SLT_Write);
+
+	if (bIsBuilding)
+	{
+		RemovedWhileBuilding.Remove(Path);
+	}
+
+	AddPathLocked(Path);
+}
+
+
+void FPakMgrPathSearchIndex::RemovePath(FName Path)
+{
+	using namespace PathSearchIndex;
+
+	FRWScopeLock Lock(IndexLock, SLT_Write);
+
+	// the snapshot being built may still hold the path
+	if (bIsBuilding)
+	{
+		RemovedWhileBuilding.Add(Path);
+	}
+
+	int32 PathId = INDEX_NONE;
+
+	if (!PathIds.RemoveAndCopyValue(Path, PathId))
+	{
+		return;
+	}
+
+	RemovedIds[PathId] = true;
+	LowerPaths[PathId].Empty();
+
+	const int32 NumRemoved = Paths.Num() - PathIds.Num();
+
+	if ((NumRemoved >= MinRemovedToCompact) && (NumRemoved * 2 > Paths.Num()))
+	{
+		Compact();
+	}
+}
+
+
+bool FPakMgrPathSearchIndex::IsBuilding() const
+{
+	FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+
+	return bIsBuilding;
+}
+
+
+int32 FPakMgrPathSearchIndex::Num() const
+{
+	FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+
+	return PathIds.Num();
+}
+
+
+void FPakMgrPathSearchIndex::Search(const FString& Query, EPakMgrPathSearchMode Mode, int32 MaxResults, FOnResults OnResults) const
+{
+	using namespace PathSearchIndex;
+
+	const FString LowerQuery = Query.ToLower();
+
+	if (LowerQuery.IsEmpty() || (MaxResults <= 0))
+	{
+		return;
+	}
+
+	TArray<uint64> QueryTrigrams;
+	GetTrigrams(LowerQuery, QueryTrigrams);
+
+	TArray<FName> Matches;
+	{
+		FRWScopeLock Lock(IndexLock, SLT_ReadOnly);
+		FindMatches(LowerQuery, QueryTrigrams, Mode, MaxResults, Matches);
+	}
+
+	// the callback runs without the lock, so a slow consumer never holds up AddPath and RemovePath
+	TArray<FName> Batch;
+	Batch.Reserve(BatchSize);
+
+	for (int32 BatchStart = 0; BatchStart < Matches.Num(); BatchStart += BatchSize)
+	{
+		Batch.Reset();
+		Batch.Append(Matches.GetData() + BatchStart, FMath::Min(BatchSize, Matches.Num() - BatchStart));
+
+		if (!OnResults(Batch))
+		{
+			return;
+		}
+	}
+}
+
+
+/* FPakMgrPathSearchIndex implementation
+ *****************************************************************************/
+
+void FPakMgrPathSearchIndex::AddPathLocked(FName Path)
+{
+	if (Path.IsNone() || PathIds.Contains(Path))
+	{
+		return;
+	}
+
+	const int32 PathId = Paths.Add(Path);
+	LowerPaths.Add(Path.ToString().ToLower());
+	RemovedIds.Add(false);
+	PathIds.Add(Path, PathId);
+
+	TArray<uint64> Trigrams;
+	GetTrigrams(LowerPaths[PathId], Trigrams);
+
+	// ids only grow, so appending keeps the lists sorted
+	for (uint64 Trigram : Trigrams)
+	{
+		Postings.FindOrAdd(Trigram).Add(PathId);
+	}
+}
+
+
+void FPakMgrPathSearchIndex::Compact()
+{
+	TArray<FName> RemainingPaths;
+	RemainingPaths.Reserve(PathIds.Num());
+
+	for (int32 PathId = 0; PathId < Paths.Num(); ++PathId)
+	{
+		if (!RemovedIds[PathId])
+		{
+			RemainingPaths.Add(Paths[PathId]);
+		}
+	}
+
+	Paths.Reset();
+	LowerPaths.Reset();
+	RemovedIds.Empty();
+	PathIds.Reset();
+	Postings.Empty();
+
+	for (FName Path : RemainingPaths)
+	{
+		AddPathLocked(Path);
+	}
+}
+
+
+void FPakMgrPathSearchIndex::FindMatches(const FString& LowerQuery, const TArray<uint64>& QueryTrigrams, EPakMgrPathSearchMode Mode, int32 MaxResults, TArray<FName>& OutMatches) const
+{
+	using namespace PathSearchIndex;
+
+	if (QueryTrigrams.Num() == 0)
+	{
+		// too short to have trigrams, compare every path
+		for (int32 PathId = 0; (PathId < Paths.Num()) && (OutMatches.Num() < MaxResults); ++PathId)
+		{
+			if (!RemovedIds[PathId] && LowerPaths[PathId].Contains(LowerQuery, ESearchCase::CaseSensitive))
+			{
+				OutMatches.Add(Paths[PathId]);
+			}
+		}
+
+		return;
+	}
+
+	if (Mode == EPakMgrPathSearchMode::Substring)
+	{
+		// every trigram of the query must be present, rarest first keeps the candidates few
+		TArray<const TArray<int32>*> Lists;
+
+		for (uint64 Trigram : QueryTrigrams)
+		{
+			const TArray<int32>* List = Postings.Find(Trigram);
+
+			if (List == nullptr)
+			{
+				return;
+			}
+
+			Lists.Add(List);
+		}
+
+		Lists.Sort([](const TArray<int32>& A, const TArray<int32>& B) { return A.Num() < B.Num(); });
+
+		TArray<int32> Candidates = *Lists[0];
+		TArray<int32> Intersection;
+
+		for (int32 ListIndex = 1; (ListIndex < Lists.Num()) && (Candidates.Num() > 0); ++ListIndex)
+		{
+			Intersect(Candidates, *Lists[ListIndex], Intersection);
+			Swap(Candidates, Intersection);
+		}
+
+		// sharing all trigrams does not mean they are adjacent
+		for (int32 CandidateIndex = 0; (CandidateIndex < Candidates.Num()) && (OutMatches.Num() < MaxResults); ++CandidateIndex)
+		{
+			const int32 PathId = Candidates[CandidateIndex];
+
+			if (!RemovedIds[PathId] && LowerPaths[PathId].Contains(LowerQuery, ESearchCase::CaseSensitive))
+			{
+				OutMatches.Add(Paths[PathId]);
+			}
+		}
+
+		return;
+	}
+
+	// a typo touches up to three trigrams, allow one typo in short queries and two in long ones
+	const int32 MaxTypos = (LowerQuery.Len() > 8) ? 2 : 1;
+	const int32 MinShared = FMath::Max(1, QueryTrigrams.Num() - 3 * MaxTypos);
+
+	TArray<uint16> SharedCounts;
+	SharedCounts.SetNumZeroed(Paths.Num());
+
+	TArray<int32> Candidates;
+
+	for (uint64 Trigram : QueryTrigrams)
+	{
+		if (const TArray<int32>* List = Postings.Find(Trigram))
+		{
+			for (int32 PathId : *List)
+			{
+				if (++SharedCounts[PathId] == MinShared)
+				{
+					Candidates.Add(PathId);
+				}
+			}
+		}
+	}
+
+	// most shared trigrams first, then the shortest, i.e. closest, path
+	Candidates.Sort([this, &SharedCounts](int32 A, int32 B)
+	{
+		if (SharedCounts[A] != SharedCounts[B])
+		{
+			return SharedCounts[A] > SharedCounts[B];
+		}
+
+		return LowerPaths[A].Len() < LowerPaths[B].Len();
+	});
+
+	for (int32 CandidateIndex = 0; (CandidateIndex < Candidates.Num()) && (OutMatches.Num() < MaxResults); ++CandidateIndex)
+	{
+		if (!RemovedIds[Candidates[CandidateIndex]])
+		{
+			OutMatches.Add(Paths[Candidates[CandidateIndex]]);
+		}
+	}
+}
+
+
+void FPakMgrPathSearchIndex::GetTrigrams(const FString& LowerText, TArray<uint64>& OutTrigrams)
+{
+	OutTrigrams.Reset();
+
+	for (int32 Index = 0; Index + 2 < LowerText.Len(); ++Index)
+	{
+		// wider characters are folded, which only adds candidates
+		OutTrigrams.Add(((uint64)(LowerText[Index] & 0xFFFF) << 32) | ((uint64)(LowerText[Index + 1] & 0xFFFF) << 16) | (uint64)(LowerText[Index + 2] & 0xFFFF));
+	}
+
+	// paths repeat trigrams, e.g. in /Game/Foo/Foo.Foo, but each id must only be listed once
+	OutTrigrams.Sort();
+
+	int32 NumUnique = 0;
+
+	for (int32 Index = 0; Index < OutTrigrams.Num(); ++Index)
+	{
+		if ((NumUnique == 0) || (OutTrigrams[NumUnique - 1] != OutTrigrams[Index]))
+		{
+			OutTrigrams[NumUnique++] = OutTrigrams[Index];
+		}
+	}
+
+	OutTrigrams.SetNum(NumUnique, false);
+}
@@ -0,0 +1,118 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "Templates/Function.h"
+
+/** How FPakMgrPathSearchIndex::Search matches paths. */
+enum class EPakMgrPathSearchMode : uint8
+{
+	/** Paths containing the query, ignoring case. */
+	Substring,
+
+	/** Paths sharing most trigrams with the query, best matches first. Tolerates a typo or two. */
+	Fuzzy
+};
+
+/**
+ * Trigram inverted index over package and object paths.
+ *
+ * Every lower case path is broken into its three character sequences, and each sequence maps to
+ * the sorted ids of the paths containing it. A substring query intersects the lists of its own
+ * trigrams, shortest first, and only compares the few paths left. A fuzzy query counts shared
+ * trigrams instead, so a typo only costs the trigrams it touches.
+ *
+ * Path ids are never reused, which keeps the lists sorted as paths are added. Removed paths are
+ * only flagged and the index is compacted once they make up half of it. All functions may be
+ * called from any thread, searches share the index and only block adding and removing paths while
+ * they collect their matches.
+ */
+class FPakMgrPathSearchIndex
+{
+public:
+
+	/** Callback receiving a batch of search results, returns false to stop the search. */
+	typedef TFunctionRef<bool(const TArray<FName>&)> FOnResults;
+
+	FPakMgrPathSearchIndex();
+
+	/**
+	 * Marks the start of an initial build.
+	 *
+	 * Call before taking the snapshot passed to Build. Paths removed until Build finishes are not
+	 * added by it, even if they are part of the snapshot.
+	 */
+	void BeginBuild();
+
+	/**
+	 * Adds a snapshot of paths, usually on a worker thread. Other callers are only blocked for one chunk at a time.
+	 *
+	 * @param InPaths The package and object paths.
+	 * @see BeginBuild
+	 */
+	void Build(const TArray<FName>& InPaths);
+
+	/** Adds a path, does nothing if it is already known. */
+	void AddPath(FName Path);
+
+	/** Removes a path, does nothing if it is unknown. */
+	void RemovePath(FName Path);
+
+	/** Checks whether an initial build is still running. */
+	bool IsBuilding() const;
+
+	/** Gets the number of paths in the index. */
+	int32 Num() const;
+
+	/**
+	 * Searches the index.
+	 *
+	 * @param Query The text to search for, case is ignored.
+	 * @param Mode How to match paths.
+	 * @param MaxResults The maximum number of results.
+	 * @param OnResults Receives the results in batches once they are collected, called without holding the lock.
+	 */
+	void Search(const FString& Query, EPakMgrPathSearchMode Mode, int32 MaxResults, FOnResults OnResults) const;
+
+private:
+
+	/** Adds a path, the lock must be held. */
+	void AddPathLocked(FName Path);
+
+	/** Rebuilds the trigram lists without removed paths, the lock must be held. */
+	void Compact();
+
+	/** Collects up to MaxResults paths matching a query, the lock must be held. */
+	void FindMatches(const FString& LowerQuery, const TArray<uint64>& QueryTrigrams, EPakMgrPathSearchMode Mode, int32 MaxResults, TArray<FName>& OutMatches) const;
+
+	/** Gets the unique trigrams of a lower case text. */
+	static void GetTrigrams(const FString& LowerText, TArray<uint64>& OutTrigrams);
+
+private:
+
+	/** Guards everything below, searches only read. */
+	mutable FRWLock IndexLock;
+
+	/** Path of each id. */
+	TArray<FName> Paths;
+
+	/** Lower case path of each id, compared against queries. */
+	TArray<FString> LowerPaths;
+
+	/** Flags the ids of removed paths. */
+	TBitArray<> RemovedIds;
+
+	/** Id of each path in the index. */
+	TMap<FName, int32> PathIds;
+
+	/** Sorted path ids of each trigram. */
+	TMap<uint64, TArray<int32>> Postings;
+
+	/** Paths removed while the initial build was running. */
+	TSet<FName> RemovedWhileBuilding;
+
+	/** Whether the initial build is running. */
+	bool bIsBuilding;
+};
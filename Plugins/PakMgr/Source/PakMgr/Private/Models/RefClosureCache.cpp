@@ -0,0 +1,161 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/RefClosureCache.h"
+#include "AssetRegistryModule.h"
+#include "Misc/ScopeLock.h"
+#include "Models/PackageRoots.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+/* FRefClosureCache structors
+ *****************************************************************************/
+
+FRefClosureCache::FRefClosureCache()
+	: NumRegistryQueries(0)
+	, NumCacheHits(0)
+{ }
+
+
+/* FRefClosureCache interface
+ *****************************************************************************/
+
+const FRefClosureCache::FEntry& FRefClosureCache::FindOrGather(const FAssetIdentifier& Identifier, bool bReferencers, EAssetRegistryDependencyType::Type SearchFlags, EAssetRegistryDependencyType::Type HardSearchFlags, bool bShowNativePackages, const FPakMgrDependencyGraphPtr& SnapshotGraph)
+{
+	// dependency types fit into a byte, so the whole query packs into one key
+	const FKey Key(Identifier, (uint32)SearchFlags | ((uint32)HardSearchFlags << 8) | (bReferencers ? 1u << 16 : 0u) | (bShowNativePackages ? 1u << 17 : 0u));
+
+	{
+		FScopeLock Lock(&CriticalSection);
+
+		if (const TUniquePtr<FEntry>* Entry = Entries.Find(Key))
+		{
+			++NumCacheHits;
+
+			return **Entry;
+		}
+	}
+
+	// gathered without the lock, so other threads are not held up by the registry
+	TUniquePtr<FEntry> NewEntry = MakeUnique<FEntry>();
+	const int32 NumQueries = Gather(*NewEntry, Identifier, bReferencers, SearchFlags, HardSearchFlags, bShowNativePackages, SnapshotGraph);
+
+	FScopeLock Lock(&CriticalSection);
+
+	NumRegistryQueries += NumQueries;
+
+	// another thread may have gathered the same entry meanwhile, the first one is kept
+	TUniquePtr<FEntry>& Entry = Entries.FindOrAdd(Key);
+
+	if (!Entry.IsValid())
+	{
+		Entry = MoveTemp(NewEntry);
+	}
+
+	return *Entry;
+}
+
+
+void FRefClosureCache::Reset()
+{
+	FScopeLock Lock(&CriticalSection);
+
+	Entries.Reset();
+	NumRegistryQueries = 0;
+	NumCacheHits = 0;
+}
+
+
+/* FRefClosureCache implementation
+ *****************************************************************************/
+
+int32 FRefClosureCache::Gather(FEntry& OutEntry, const FAssetIdentifier& Identifier, bool bReferencers, EAssetRegistryDependencyType::Type SearchFlags, EAssetRegistryDependencyType::Type HardSearchFlags, bool bShowNativePackages, const FPakMgrDependencyGraphPtr& SnapshotGraph)
+{
+	PAKMGR_TRACE_SCOPE(GatherRefClosure);
+
+	// requests answered from a snapshot may run on a worker thread and must not touch the module or the registry
+	const bool bSnapshotOnly = SnapshotGraph.IsValid();
+	const FPakMgrDependencyGraphPtr Graph = bSnapshotOnly ? SnapshotGraph : IPakMgrModule::Get().GetDependencyGraph();
+
+	// hard and non-hard types are disjoint, so querying them separately touches every registry edge once
+	const EAssetRegistryDependencyType::Type HardFlags = (EAssetRegistryDependencyType::Type)(SearchFlags & HardSearchFlags);
+	const EAssetRegistryDependencyType::Type OtherFlags = (EAssetRegistryDependencyType::Type)(SearchFlags & ~HardSearchFlags);
+
+	int32 NumQueries = 0;
+
+	auto Query = [&](EAssetRegistryDependencyType::Type QueryFlags, TArray<FAssetIdentifier>& OutIdentifiers)
+	{
+		if (QueryFlags == 0)
+		{
+			return;
+		}
+
+		// plain package edges come from the snapshot, everything else from the registry
+		const bool bAnsweredByGraph = Graph.IsValid() && Identifier.IsPackage() && FPakMgrDependencyGraph::SupportsSearchFlags(QueryFlags)
+			&& Graph->AppendNeighbours(Identifier.PackageName, QueryFlags, bReferencers, OutIdentifiers);
+
+		if (!bAnsweredByGraph && !bSnapshotOnly)
+		{
+			IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+			++NumQueries;
+
+			if (bReferencers)
+			{
+				AssetRegistry.GetReferencers(Identifier, OutIdentifiers, QueryFlags);
+			}
+			else
+			{
+				AssetRegistry.GetDependencies(Identifier, OutIdentifiers, QueryFlags);
+			}
+		}
+
+		if (!bShowNativePackages)
+		{
+			FPakMgrPackageRoots& PackageRoots = FPakMgrPackageRoots::Get();
+			auto RemoveNativePackage = [&PackageRoots](const FAssetIdentifier& InAsset) { return !InAsset.IsValue() && PackageRoots.IsScriptPackage(InAsset.PackageName); };
+
+			OutIdentifiers.RemoveAll(RemoveNativePackage);
+		}
+
+		// Filter for our registry source
+		if (!bSnapshotOnly)
+		{
+			IPakMgrModule::Get().FilterAssetIdentifiersForCurrentRegistrySource(OutIdentifiers, SearchFlags, !bReferencers);
+		}
+	};
+
+	TArray<FAssetIdentifier> HardReferences;
+	TArray<FAssetIdentifier> OtherReferences;
+	Query(HardFlags, HardReferences);
+	Query(OtherFlags, OtherReferences);
+
+	TSet<FAssetIdentifier> SeenReferences;
+	SeenReferences.Reserve(HardReferences.Num() + OtherReferences.Num());
+	OutEntry.References.Reserve(HardReferences.Num() + OtherReferences.Num());
+
+	for (const FAssetIdentifier& Reference : HardReferences)
+	{
+		bool bAlreadySeen = false;
+		SeenReferences.Add(Reference, &bAlreadySeen);
+
+		if (!bAlreadySeen)
+		{
+			OutEntry.References.Add(Reference);
+			OutEntry.HardFlags.Add(true);
+		}
+	}
+
+	for (const FAssetIdentifier& Reference : OtherReferences)
+	{
+		bool bAlreadySeen = false;
+		SeenReferences.Add(Reference, &bAlreadySeen);
+
+		if (!bAlreadySeen)
+		{
+			OutEntry.References.Add(Reference);
+			OutEntry.HardFlags.Add(false);
+		}
+	}
+
+	return NumQueries;
+}
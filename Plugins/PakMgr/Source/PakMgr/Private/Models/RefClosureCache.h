@@ -0,0 +1,118 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "HAL/CriticalSection.h"
+#include "Misc/AssetRegistryInterface.h"
+#include "Models/DependencyGraph.h"
+
+/**
+ * Caches the filtered referencers and dependencies of asset identifiers.
+ *
+ * The reference graph walks the same identifiers in its size pass and its node pass, and
+ * re-rooting the graph walks most of them again. Every (identifier, direction, search flags)
+ * triple is fetched from the asset registry once and reused until the cache is reset.
+ *
+ * The cache may be shared between threads, so a cancelled background build and the build replacing
+ * it keep filling the same cache. Requests answered from a graph snapshot never touch the asset
+ * registry or the module, so only those may be made on worker threads. Entries are never removed
+ * before Reset, which must only be called while no other thread uses the cache.
+ */
+class FRefClosureCache
+{
+public:
+
+	/** Filtered references of a single identifier in one direction. */
+	struct FEntry
+	{
+		/** Holds all references matching the search flags, hard references first. */
+		TArray<FAssetIdentifier> References;
+
+		/** Holds one bit per element of References, set if that reference is a hard reference. */
+		TBitArray<> HardFlags;
+
+		/** Checks whether the reference at the given index is a hard reference. */
+		bool IsHardReference(int32 Index) const
+		{
+			return HardFlags[Index];
+		}
+	};
+
+public:
+
+	/** Default constructor. */
+	FRefClosureCache();
+
+public:
+
+	/**
+	 * Gets the references of an identifier, asking the asset registry only on the first request.
+	 *
+	 * @param Identifier The identifier to get the references of.
+	 * @param bReferencers Whether to get referencers (true) or dependencies (false).
+	 * @param SearchFlags All dependency types to gather.
+	 * @param HardSearchFlags The subset of SearchFlags that counts as a hard reference.
+	 * @param bShowNativePackages Whether /Script packages are kept in the result.
+	 * @param SnapshotGraph If set, references are only taken from this snapshot. Identifiers it cannot answer have no references, and registry source filtering is skipped.
+	 * @return The cached entry, valid until the next call to Reset.
+	 */
+	const FEntry& FindOrGather(const FAssetIdentifier& Identifier, bool bReferencers, EAssetRegistryDependencyType::Type SearchFlags, EAssetRegistryDependencyType::Type HardSearchFlags, bool bShowNativePackages, const FPakMgrDependencyGraphPtr& SnapshotGraph = FPakMgrDependencyGraphPtr());
+
+	/** Discards all cached entries. */
+	void Reset();
+
+	/** Gets the number of registry queries issued since the last reset. */
+	int32 GetNumRegistryQueries() const
+	{
+		return NumRegistryQueries;
+	}
+
+	/** Gets the number of requests answered from the cache since the last reset. */
+	int32 GetNumCacheHits() const
+	{
+		return NumCacheHits;
+	}
+
+private:
+
+	/** Key of a cached entry. */
+	struct FKey
+	{
+		FAssetIdentifier Identifier;
+		uint32 Flags;
+
+		FKey(const FAssetIdentifier& InIdentifier, uint32 InFlags)
+			: Identifier(InIdentifier)
+			, Flags(InFlags)
+		{ }
+
+		bool operator==(const FKey& Other) const
+		{
+			return Flags == Other.Flags && Identifier == Other.Identifier;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(GetTypeHash(Key.Identifier), Key.Flags);
+		}
+	};
+
+	/** Fills an entry from the asset registry or a snapshot, returns the number of registry queries. Does not touch the cache, so no lock needs to be held. */
+	int32 Gather(FEntry& OutEntry, const FAssetIdentifier& Identifier, bool bReferencers, EAssetRegistryDependencyType::Type SearchFlags, EAssetRegistryDependencyType::Type HardSearchFlags, bool bShowNativePackages, const FPakMgrDependencyGraphPtr& SnapshotGraph);
+
+private:
+
+	/** Holds the cached entries. Entries are heap allocated so references stay valid while the map grows. */
+	TMap<FKey, TUniquePtr<FEntry>> Entries;
+
+	/** Holds the number of registry queries issued since the last reset. */
+	int32 NumRegistryQueries;
+
+	/** Holds the number of cache hits since the last reset. */
+	int32 NumCacheHits;
+
+	/** Guards the entries and counters. */
+	FCriticalSection CriticalSection;
+};
@@ -7,6 +7,40 @@
 #include "CollectionManagerModule.h"
 #include "PakMgrModule.h"
 #include "Engine/AssetManager.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Models/DependencyGraph.h"
+#include "Widgets/Notifications/SNotificationList.h"
+#include "PakMgrTrace.h"
+
+#define LOCTEXT_NAMESPACE "RefGraph"
+
+/** State shared between the graph and the worker of a background build */
+struct FRefGraphBuildTask
+{
+	/** Set to stop the worker early */
+	FThreadSafeBool bCancelRequested;
+
+	/** The number of identifiers the worker has visited so far */
+	FThreadSafeCounter NumVisited;
+
+	/** The layout computed by the worker */
+	FRefGraphLayout Layout;
+
+	/** Whether the worker finished without being cancelled */
+	bool bSucceeded;
+
+	/** Whether nodes of the previous layout may be reused */
+	bool bReuseNodes;
+
+	FRefGraphBuildTask()
+		: bSucceeded(false)
+		, bReuseNodes(false)
+	{ }
+};
 
 URefGraph::URefGraph(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
@@ -21,6 +55,8 @@ URefGraph::URefGraph(const FObjectInitializer& ObjectInitializer)
 	bIsShowManagementReferences = false;
 	bIsShowSearchableNames = false;
 	bIsShowNativePackages = false;
+
+	ReferenceCache = MakeShareable(new FRefClosureCache);
 }
 
 void URefGraph::SetGraphRoot(const TArray<FAssetIdentifier>& GraphRootIdentifiers, const FIntPoint& GraphRootOrigin)
@@ -54,157 +90,376 @@ const TArray<FAssetIdentifier>& URefGraph::GetCurrentGraphRootIdentifiers() cons
 
 URefNode* URefGraph::RebuildGraph()
 {
-	RemoveAllNodes();
-	URefNode* NewRootNode = ConstructNodes(CurrentGraphRootIdentifiers, CurrentGraphRootOrigin);
-	NotifyGraphChanged();
+	CancelBuild();
+
+	// an explicit rebuild picks up registry changes made since the last one, also those no registry event reported
+	IPakMgrModule::Get().InvalidateDependencyGraph();
+
+	// a cancelled build may still be filling the old cache, so it is replaced rather than reset
+	ReferenceCache = MakeShareable(new FRefClosureCache);
+
+	// asset data may have changed as well, so no node is reused
+	return BuildGraph(false);
+}
+
+URefNode* URefGraph::RefocusGraph()
+{
+	return BuildGraph(true);
+}
 
-	return NewRootNode;
+void URefGraph::RefocusGraphAsync()
+{
+	StartBuild(true);
 }
 
-URefNode* URefGraph::ConstructNodes(const TArray<FAssetIdentifier>& GraphRootIdentifiers, const FIntPoint& GraphRootOrigin)
+URefNode* URefGraph::BuildGraph(bool bReuseNodes)
 {
-	URefNode* RootNode = NULL;
+	CancelBuild();
+
+	const FRefGraphLayoutSettings Settings = CreateLayoutSettings();
+	FRefGraphLayout Layout;
+	FRefGraphLayoutBuilder(Settings, *ReferenceCache).Build(CurrentGraphRootIdentifiers, CurrentGraphRootOrigin, Layout);
 
-	if (GraphRootIdentifiers.Num() > 0)
+	return CreateNodesFromLayout(Layout, bReuseNodes);
+}
+
+void URefGraph::StartBuild(bool bReuseNodes)
+{
+	CancelBuild();
+
+	FPakMgrDependencyGraphPtr Graph;
+
+	if (CanBuildAsync())
 	{
-		TSet<FName> AllowedPackageNames;
-		if (ShouldFilterByCollection())
-		{
-			FCollectionManagerModule& CollectionManagerModule = FCollectionManagerModule::GetModule();
-			TArray<FName> AssetPaths;
-			CollectionManagerModule.Get().GetAssetsInCollection(CurrentCollectionFilter, ECollectionShareType::CST_All, AssetPaths);
-			AllowedPackageNames.Reserve(AssetPaths.Num());
-			for (FName AssetPath : AssetPaths)
-			{
-				AllowedPackageNames.Add(FName(*FPackageName::ObjectPathToPackageName(AssetPath.ToString())));
-			}
-		}
+		Graph = IPakMgrModule::Get().GetDependencyGraph();
+	}
 
-		TMap<FAssetIdentifier, int32> ReferencerNodeSizes;
-		TSet<FAssetIdentifier> VisitedReferencerSizeNames;
-		int32 ReferencerDepth = 1;
-		RecursivelyGatherSizes(/*bReferencers=*/true, GraphRootIdentifiers, AllowedPackageNames, ReferencerDepth, VisitedReferencerSizeNames, ReferencerNodeSizes);
+	if (!Graph.IsValid())
+	{
+		BuildGraph(bReuseNodes);
+		return;
+	}
 
-		TMap<FAssetIdentifier, int32> DependencyNodeSizes;
-		TSet<FAssetIdentifier> VisitedDependencySizeNames;
-		int32 DependencyDepth = 1;
-		RecursivelyGatherSizes(/*bReferencers=*/false, GraphRootIdentifiers, AllowedPackageNames, DependencyDepth, VisitedDependencySizeNames, DependencyNodeSizes);
+	TSharedRef<FRefGraphBuildTask, ESPMode::ThreadSafe> Task = MakeShareable(new FRefGraphBuildTask);
+	Task->bReuseNodes = bReuseNodes;
+	BuildTask = Task;
 
-		TSet<FName> AllPackageNames;
+	// everything the worker reads is copied here, the worker never touches the graph itself
+	FRefGraphLayoutSettings Settings = CreateLayoutSettings();
+	Settings.SnapshotGraph = Graph;
+	const TArray<FAssetIdentifier> Roots = CurrentGraphRootIdentifiers;
+	const FIntPoint Origin = CurrentGraphRootOrigin;
+	TSharedPtr<FRefClosureCache, ESPMode::ThreadSafe> Cache = ReferenceCache;
+	TWeakObjectPtr<URefGraph> WeakThis(this);
 
-		auto AddPackage = [](const FAssetIdentifier& AssetId, TSet<FName>& PackageNames)
+	Async<void>(EAsyncExecution::ThreadPool, [Task, Settings, Roots, Origin, Cache, WeakThis]()
+	{
+		Task->bSucceeded = FRefGraphLayoutBuilder(Settings, *Cache, &Task->bCancelRequested, &Task->NumVisited).Build(Roots, Origin, Task->Layout);
+
+		AsyncTask(ENamedThreads::GameThread, [Task, WeakThis]()
 		{
-			// Only look for asset data if this is a package
-			if (!AssetId.IsValue())
+			URefGraph* This = WeakThis.Get();
+
+			if (This != nullptr)
 			{
-				PackageNames.Add(AssetId.PackageName);
+				This->HandleBuildFinished(Task);
 			}
-		};
+		});
+	});
 
-		for (const FAssetIdentifier& AssetId : VisitedReferencerSizeNames)
-		{
-			AddPackage(AssetId, AllPackageNames);
-		}
+	// builds finishing within the first interval show no notification at all
+	if (FSlateApplication::IsInitialized())
+	{
+		BuildProgressTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &URefGraph::HandleBuildProgressTicker), 0.25f);
+	}
+}
 
-		for (const FAssetIdentifier& AssetId : VisitedDependencySizeNames)
-		{
-			AddPackage(AssetId, AllPackageNames);
-		}
+void URefGraph::CancelBuild()
+{
+	if (!BuildTask.IsValid())
+	{
+		return;
+	}
 
-		TMap<FName, FAssetData> PackagesToAssetDataMap;
-		GatherAssetData(AllPackageNames, PackagesToAssetDataMap);
+	// the worker keeps filling the shared cache until it notices, so the next build can use what it gathered
+	BuildTask->bCancelRequested = true;
+	BuildTask.Reset();
 
-		// Create the root node
-		RootNode = CreateReferenceNode();
-		RootNode->SetupReferenceNode(GraphRootOrigin, GraphRootIdentifiers, PackagesToAssetDataMap.FindRef(GraphRootIdentifiers[0].PackageName));
+	StopBuildProgress();
+}
+
+bool URefGraph::IsBuilding() const
+{
+	return BuildTask.IsValid();
+}
 
-		TSet<FAssetIdentifier> VisitedReferencerNames;
-		int32 VisitedReferencerDepth = 1;
-		RecursivelyConstructNodes(/*bReferencers=*/true, RootNode, GraphRootIdentifiers, GraphRootOrigin, ReferencerNodeSizes, PackagesToAssetDataMap, AllowedPackageNames, VisitedReferencerDepth, VisitedReferencerNames);
+int32 URefGraph::GetBuildProgress() const
+{
+	return BuildTask.IsValid() ? BuildTask->NumVisited.GetValue() : 0;
+}
+
+void URefGraph::BeginDestroy()
+{
+	CancelBuild();
+
+	Super::BeginDestroy();
+}
 
-		TSet<FAssetIdentifier> VisitedDependencyNames;
-		int32 VisitedDependencyDepth = 1;
-		RecursivelyConstructNodes(/*bReferencers=*/false, RootNode, GraphRootIdentifiers, GraphRootOrigin, DependencyNodeSizes, PackagesToAssetDataMap, AllowedPackageNames, VisitedDependencyDepth, VisitedDependencyNames);
+FRefGraphLayoutSettings URefGraph::CreateLayoutSettings() const
+{
+	FRefGraphLayoutSettings Settings;
+	Settings.SearchFlags = GetReferenceSearchFlags(false);
+	Settings.HardSearchFlags = GetReferenceSearchFlags(true);
+	Settings.MaxSearchDepth = MaxSearchDepth;
+	Settings.MaxSearchBreadth = MaxSearchBreadth;
+	Settings.bLimitSearchDepth = bLimitSearchDepth;
+	Settings.bLimitSearchBreadth = bLimitSearchBreadth;
+	Settings.bFilterByCollection = ShouldFilterByCollection();
+	Settings.bShowNativePackages = bIsShowNativePackages;
+
+	if (Settings.bFilterByCollection)
+	{
+		FCollectionManagerModule& CollectionManagerModule = FCollectionManagerModule::GetModule();
+		TArray<FName> AssetPaths;
+		CollectionManagerModule.Get().GetAssetsInCollection(CurrentCollectionFilter, ECollectionShareType::CST_All, AssetPaths);
+		Settings.AllowedPackageNames.Reserve(AssetPaths.Num());
+		for (FName AssetPath : AssetPaths)
+		{
+			Settings.AllowedPackageNames.Add(FName(*FPackageName::ObjectPathToPackageName(AssetPath.ToString())));
+		}
 	}
 
-	return RootNode;
+	return Settings;
 }
 
-int32 URefGraph::RecursivelyGatherSizes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, const TSet<FName>& AllowedPackageNames, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, TMap<FAssetIdentifier, int32>& OutNodeSizes) const
+bool URefGraph::CanBuildAsync() const
 {
-	check(Identifiers.Num() > 0);
+	// the asset registry and the registry source filter may only be used on the game thread
+	if (IPakMgrModule::Get().NeedsRegistrySourceFiltering() || !FPakMgrDependencyGraph::SupportsSearchFlags(GetReferenceSearchFlags(false)))
+	{
+		return false;
+	}
 
-	VisitedNames.Append(Identifiers);
+	for (const FAssetIdentifier& AssetId : CurrentGraphRootIdentifiers)
+	{
+		if (!AssetId.IsPackage())
+		{
+			return false;
+		}
+	}
 
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	TArray<FAssetIdentifier> ReferenceNames;
+	return true;
+}
+
+URefNode* URefGraph::CreateNodesFromLayout(const FRefGraphLayout& Layout, bool bReuseNodes)
+{
+	PAKMGR_TRACE_SCOPE(CreateRefGraphNodes);
+
+	// nodes of the previous layout that may be moved into the new one
+	TMultiMap<FAssetIdentifier, URefNode*> ReusableNodes;
+	TArray<URefNode*> ReusableCollapsedNodes;
 
-	if (bReferencers)
+	if (bReuseNodes)
 	{
-		for (const FAssetIdentifier& AssetId : Identifiers)
+		for (UEdGraphNode* Node : Nodes)
 		{
-			AssetRegistryModule.Get().GetReferencers(AssetId, ReferenceNames, GetReferenceSearchFlags(false));
+			URefNode* RefNode = Cast<URefNode>(Node);
+
+			if (RefNode == NULL)
+			{
+				continue;
+			}
+
+			RefNode->ResetReferenceLinks();
+
+			if (RefNode->IsCollapsed())
+			{
+				ReusableCollapsedNodes.Add(RefNode);
+			}
+			else
+			{
+				ReusableNodes.Add(RefNode->GetIdentifier(), RefNode);
+			}
 		}
 	}
 	else
 	{
-		for (const FAssetIdentifier& AssetId : Identifiers)
+		RemoveAllNodes();
+	}
+
+	// match the layout against the previous nodes first, so only new packages need asset data
+	TArray<URefNode*> LayoutNodes;
+	LayoutNodes.SetNumZeroed(Layout.Nodes.Num());
+
+	TSet<FName> NewPackageNames;
+
+	for (int32 NodeIndex = 0; NodeIndex < Layout.Nodes.Num(); ++NodeIndex)
+	{
+		const FRefGraphLayout::FNode& LayoutNode = Layout.Nodes[NodeIndex];
+
+		if (LayoutNode.NumCollapsed > 0)
+		{
+			if (ReusableCollapsedNodes.Num() > 0)
+			{
+				LayoutNodes[NodeIndex] = ReusableCollapsedNodes.Pop(false);
+			}
+
+			continue;
+		}
+
+		for (TMultiMap<FAssetIdentifier, URefNode*>::TKeyIterator It = ReusableNodes.CreateKeyIterator(LayoutNode.Identifiers[0]); It; ++It)
+		{
+			if (It.Value()->Identifiers == LayoutNode.Identifiers)
+			{
+				LayoutNodes[NodeIndex] = It.Value();
+				It.RemoveCurrent();
+
+				break;
+			}
+		}
+
+		// Only look for asset data if this is a package
+		if ((LayoutNodes[NodeIndex] == NULL) && !LayoutNode.Identifiers[0].IsValue())
 		{
-			AssetRegistryModule.Get().GetDependencies(AssetId, ReferenceNames, GetReferenceSearchFlags(false));
+			NewPackageNames.Add(LayoutNode.Identifiers[0].PackageName);
 		}
 	}
 
-	if (!bIsShowNativePackages)
+	for (const TPair<FAssetIdentifier, URefNode*>& Pair : ReusableNodes)
 	{
-		auto RemoveNativePackage = [](const FAssetIdentifier& InAsset) { return InAsset.PackageName.ToString().StartsWith(TEXT("/Script")) && !InAsset.IsValue(); };
+		RemoveNode(Pair.Value);
+	}
 
-		ReferenceNames.RemoveAll(RemoveNativePackage);
+	for (URefNode* CollapsedNode : ReusableCollapsedNodes)
+	{
+		RemoveNode(CollapsedNode);
 	}
 
-	int32 NodeSize = 0;
-	if (ReferenceNames.Num() > 0 && !ExceedsMaxSearchDepth(CurrentDepth))
+	TMap<FName, FAssetData> PackagesToAssetDataMap;
+
+	if (NewPackageNames.Num() > 0)
 	{
-		int32 NumReferencesMade = 0;
-		int32 NumReferencesExceedingMax = 0;
+		GatherAssetData(NewPackageNames, PackagesToAssetDataMap);
+	}
 
-		// Filter for our registry source
-		IPakMgrModule::Get().FilterAssetIdentifiersForCurrentRegistrySource(ReferenceNames, GetReferenceSearchFlags(false), !bReferencers);
+	for (int32 NodeIndex = 0; NodeIndex < Layout.Nodes.Num(); ++NodeIndex)
+	{
+		const FRefGraphLayout::FNode& LayoutNode = Layout.Nodes[NodeIndex];
+		URefNode* NewNode = LayoutNodes[NodeIndex];
 
-		// Since there are referencers, use the size of all your combined referencers.
-		// Do not count your own size since there could just be a horizontal line of nodes
-		for (FAssetIdentifier& AssetId : ReferenceNames)
+		if (LayoutNode.NumCollapsed > 0)
 		{
-			if (!VisitedNames.Contains(AssetId) && (!AssetId.IsPackage() || !ShouldFilterByCollection() || AllowedPackageNames.Contains(AssetId.PackageName)))
+			if (NewNode == NULL)
 			{
-				if (!ExceedsMaxSearchBreadth(NumReferencesMade))
-				{
-					TArray<FAssetIdentifier> NewPackageNames;
-					NewPackageNames.Add(AssetId);
-					NodeSize += RecursivelyGatherSizes(bReferencers, NewPackageNames, AllowedPackageNames, CurrentDepth + 1, VisitedNames, OutNodeSizes);
-					NumReferencesMade++;
-				}
-				else
-				{
-					NumReferencesExceedingMax++;
-				}
+				NewNode = CreateReferenceNode();
 			}
+
+			NewNode->SetReferenceNodeCollapsed(LayoutNode.Location, LayoutNode.NumCollapsed);
+		}
+		else if (NewNode == NULL)
+		{
+			NewNode = CreateReferenceNode();
+			NewNode->SetupReferenceNode(LayoutNode.Location, LayoutNode.Identifiers, PackagesToAssetDataMap.FindRef(LayoutNode.Identifiers[0].PackageName));
+		}
+		else
+		{
+			NewNode->NodePosX = LayoutNode.Location.X;
+			NewNode->NodePosY = LayoutNode.Location.Y;
 		}
 
-		if (NumReferencesExceedingMax > 0)
+		LayoutNodes[NodeIndex] = NewNode;
+
+		if (LayoutNode.Parent == INDEX_NONE)
 		{
-			// Add one size for the collapsed node
-			NodeSize++;
+			continue;
+		}
+
+		// parents always precede their children
+		URefNode* ParentNode = LayoutNodes[LayoutNode.Parent];
+
+		if (LayoutNode.bIsReferencer)
+		{
+			if (LayoutNode.bIsHardLink)
+			{
+				NewNode->GetDependencyPin()->PinType.PinCategory = TEXT("hard");
+			}
+
+			ParentNode->AddReferencer(NewNode);
+		}
+		else
+		{
+			if (LayoutNode.bIsHardLink)
+			{
+				NewNode->GetReferencerPin()->PinType.PinCategory = TEXT("hard");
+			}
+
+			NewNode->AddReferencer(ParentNode);
 		}
 	}
 
-	if (NodeSize == 0)
+	NotifyGraphChanged();
+
+	return (LayoutNodes.Num() > 0) ? LayoutNodes[0] : NULL;
+}
+
+void URefGraph::HandleBuildFinished(TSharedRef<FRefGraphBuildTask, ESPMode::ThreadSafe> Task)
+{
+	// a newer build or a cancel replaced this one
+	if (BuildTask != Task)
+	{
+		return;
+	}
+
+	BuildTask.Reset();
+	StopBuildProgress();
+
+	if (Task->bSucceeded)
+	{
+		CreateNodesFromLayout(Task->Layout, Task->bReuseNodes);
+	}
+}
+
+bool URefGraph::HandleBuildProgressTicker(float DeltaTime)
+{
+	if (!BuildTask.IsValid())
+	{
+		return false;
+	}
+
+	const FText ProgressText = FText::Format(LOCTEXT("BuildProgress", "Gathering references... {0} visited"), FText::AsNumber(GetBuildProgress()));
+
+	if (!BuildNotification.IsValid())
+	{
+		FNotificationInfo NotificationInfo(ProgressText);
+		NotificationInfo.bFireAndForget = false;
+		NotificationInfo.ExpireDuration = 0.5f;
+
+		BuildNotification = FSlateNotificationManager::Get().AddNotification(NotificationInfo);
+
+		if (BuildNotification.IsValid())
+		{
+			BuildNotification->SetCompletionState(SNotificationItem::CS_Pending);
+		}
+	}
+	else
 	{
-		// If you have no valid children, the node size is just 1 (counting only self to make a straight line)
-		NodeSize = 1;
+		BuildNotification->SetText(ProgressText);
 	}
 
-	OutNodeSizes.Add(Identifiers[0], NodeSize);
-	return NodeSize;
+	return true;
+}
+
+void URefGraph::StopBuildProgress()
+{
+	FTicker::GetCoreTicker().RemoveTicker(BuildProgressTickerHandle);
+	BuildProgressTickerHandle.Reset();
+
+	if (BuildNotification.IsValid())
+	{
+		BuildNotification->SetCompletionState(SNotificationItem::CS_None);
+		BuildNotification->ExpireAndFadeout();
+		BuildNotification.Reset();
+	}
 }
 
 EAssetRegistryDependencyType::Type URefGraph::GetReferenceSearchFlags(bool bHardOnly) const
@@ -256,173 +511,6 @@ void URefGraph::GatherAssetData(const TSet<FName>& AllPackageNames, TMap<FName,
 	}
 }
 
-URefNode* URefGraph::RecursivelyConstructNodes(bool bReferencers, URefNode* RootNode, const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, const TMap<FAssetIdentifier, int32>& NodeSizes, const TMap<FName, FAssetData>& PackagesToAssetDataMap, const TSet<FName>& AllowedPackageNames, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames)
-{
-	check(Identifiers.Num() > 0);
-
-	VisitedNames.Append(Identifiers);
-
-	URefNode* NewNode = NULL;
-	if (RootNode->GetIdentifier() == Identifiers[0])
-	{
-		// Don't create the root node. It is already created!
-		NewNode = RootNode;
-	}
-	else
-	{
-		NewNode = CreateReferenceNode();
-		NewNode->SetupReferenceNode(NodeLoc, Identifiers, PackagesToAssetDataMap.FindRef(Identifiers[0].PackageName));
-	}
-
-	FAssetRegistryModule& AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-	TArray<FAssetIdentifier> ReferenceNames;
-	TArray<FAssetIdentifier> HardReferenceNames;
-	if (bReferencers)
-	{
-		for (const FAssetIdentifier& AssetId : Identifiers)
-		{
-			AssetRegistryModule.Get().GetReferencers(AssetId, HardReferenceNames, GetReferenceSearchFlags(true));
-			AssetRegistryModule.Get().GetReferencers(AssetId, ReferenceNames, GetReferenceSearchFlags(false));
-		}
-	}
-	else
-	{
-		for (const FAssetIdentifier& AssetId : Identifiers)
-		{
-			AssetRegistryModule.Get().GetDependencies(AssetId, HardReferenceNames, GetReferenceSearchFlags(true));
-			AssetRegistryModule.Get().GetDependencies(AssetId, ReferenceNames, GetReferenceSearchFlags(false));
-		}
-	}
-
-	if (!bIsShowNativePackages)
-	{
-		auto RemoveNativePackage = [](const FAssetIdentifier& InAsset) { return InAsset.PackageName.ToString().StartsWith(TEXT("/Script")) && !InAsset.IsValue(); };
-
-		HardReferenceNames.RemoveAll(RemoveNativePackage);
-		ReferenceNames.RemoveAll(RemoveNativePackage);
-	}
-
-	if (ReferenceNames.Num() > 0 && !ExceedsMaxSearchDepth(CurrentDepth))
-	{
-		FIntPoint ReferenceNodeLoc = NodeLoc;
-
-		if (bReferencers)
-		{
-			// Referencers go left
-			ReferenceNodeLoc.X -= 800;
-		}
-		else
-		{
-			// Dependencies go right
-			ReferenceNodeLoc.X += 800;
-		}
-
-		const int32 NodeSizeY = 200;
-		const int32 TotalReferenceSizeY = NodeSizes.FindChecked(Identifiers[0]) * NodeSizeY;
-
-		ReferenceNodeLoc.Y -= TotalReferenceSizeY * 0.5f;
-		ReferenceNodeLoc.Y += NodeSizeY * 0.5f;
-
-		int32 NumReferencesMade = 0;
-		int32 NumReferencesExceedingMax = 0;
-
-		// Filter for our registry source
-		IPakMgrModule::Get().FilterAssetIdentifiersForCurrentRegistrySource(ReferenceNames, GetReferenceSearchFlags(false), !bReferencers);
-		IPakMgrModule::Get().FilterAssetIdentifiersForCurrentRegistrySource(HardReferenceNames, GetReferenceSearchFlags(false), !bReferencers);
-
-		for (int32 RefIdx = 0; RefIdx < ReferenceNames.Num(); ++RefIdx)
-		{
-			FAssetIdentifier ReferenceName = ReferenceNames[RefIdx];
-
-			if (!VisitedNames.Contains(ReferenceName) && (!ReferenceName.IsPackage() || !ShouldFilterByCollection() || AllowedPackageNames.Contains(ReferenceName.PackageName)))
-			{
-				bool bIsHardReference = HardReferenceNames.Contains(ReferenceName);
-
-				if (!ExceedsMaxSearchBreadth(NumReferencesMade))
-				{
-					int32 ThisNodeSizeY = ReferenceName.IsValue() ? 100 : NodeSizeY;
-
-					const int32 RefSizeY = NodeSizes.FindChecked(ReferenceName);
-					FIntPoint RefNodeLoc;
-					RefNodeLoc.X = ReferenceNodeLoc.X;
-					RefNodeLoc.Y = ReferenceNodeLoc.Y + RefSizeY * ThisNodeSizeY * 0.5 - ThisNodeSizeY * 0.5;
-
-					TArray<FAssetIdentifier> NewIdentifiers;
-					NewIdentifiers.Add(ReferenceName);
-
-					URefNode* ReferenceNode = RecursivelyConstructNodes(bReferencers, RootNode, NewIdentifiers, RefNodeLoc, NodeSizes, PackagesToAssetDataMap, AllowedPackageNames, CurrentDepth + 1, VisitedNames);
-					if (bIsHardReference)
-					{
-						if (bReferencers)
-						{
-							ReferenceNode->GetDependencyPin()->PinType.PinCategory = TEXT("hard");
-						}
-						else
-						{
-							ReferenceNode->GetReferencerPin()->PinType.PinCategory = TEXT("hard"); //-V595
-						}
-					}
-
-					if (ensure(ReferenceNode))
-					{
-						if (bReferencers)
-						{
-							NewNode->AddReferencer(ReferenceNode);
-						}
-						else
-						{
-							ReferenceNode->AddReferencer(NewNode);
-						}
-
-						ReferenceNodeLoc.Y += RefSizeY * ThisNodeSizeY;
-					}
-
-					NumReferencesMade++;
-				}
-				else
-				{
-					NumReferencesExceedingMax++;
-				}
-			}
-		}
-
-		if (NumReferencesExceedingMax > 0)
-		{
-			// There are more references than allowed to be displayed. Make a collapsed node.
-			URefNode* ReferenceNode = CreateReferenceNode();
-			FIntPoint RefNodeLoc;
-			RefNodeLoc.X = ReferenceNodeLoc.X;
-			RefNodeLoc.Y = ReferenceNodeLoc.Y;
-
-			if (ensure(ReferenceNode))
-			{
-				ReferenceNode->SetReferenceNodeCollapsed(RefNodeLoc, NumReferencesExceedingMax);
-
-				if (bReferencers)
-				{
-					NewNode->AddReferencer(ReferenceNode);
-				}
-				else
-				{
-					ReferenceNode->AddReferencer(NewNode);
-				}
-			}
-		}
-	}
-
-	return NewNode;
-}
-
-bool URefGraph::ExceedsMaxSearchDepth(int32 Depth) const
-{
-	return bLimitSearchDepth && Depth > MaxSearchDepth;
-}
-
-bool URefGraph::ExceedsMaxSearchBreadth(int32 Breadth) const
-{
-	return bLimitSearchBreadth && Breadth > MaxSearchBreadth;
-}
-
 URefNode* URefGraph::CreateReferenceNode()
 {
 	const bool bSelectNewNode = false;
@@ -443,4 +531,4 @@ bool URefGraph::ShouldFilterByCollection() const
 	return bEnableCollectionFilter && CurrentCollectionFilter != NAME_None;
 }
 
-
+#undef LOCTEXT_NAMESPACE
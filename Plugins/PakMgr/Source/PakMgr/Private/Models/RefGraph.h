@@ -8,8 +8,13 @@
 #include "EdGraph/EdGraph.h"
 #include "Misc/AssetRegistryInterface.h"
 #include "Models/RefNode.h"
+#include "Models/RefClosureCache.h"
+#include "Models/RefGraphLayout.h"
 #include "RefGraph.generated.h"
 
+class SNotificationItem;
+struct FRefGraphBuildTask;
+
 UCLASS()
 class URefGraph : public UEdGraph
 {
@@ -25,15 +30,48 @@ public:
 	/** Force the graph to rebuild */
 	class URefNode* RebuildGraph();
 
+	/** Rebuilds the graph around the current root, reusing the references gathered by earlier builds */
+	class URefNode* RefocusGraph();
+
+	/** Like RefocusGraph, but gathers and lays out the references in the background, cancelling a build that is still running. Nodes are created on the game thread once done */
+	void RefocusGraphAsync();
+
+	/** Stops a running background build without waiting for it, leaving the current nodes in place */
+	void CancelBuild();
+
+	/** Returns true while a background build is running */
+	bool IsBuilding() const;
+
+	/** Returns the number of identifiers the running background build has visited so far, for progress display */
+	int32 GetBuildProgress() const;
+
+	//~ UObject interface
+	virtual void BeginDestroy() override;
+
 private:
-	URefNode* ConstructNodes(const TArray<FAssetIdentifier>& GraphRootIdentifiers, const FIntPoint& GraphRootOrigin);
-	int32 RecursivelyGatherSizes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, const TSet<FName>& AllowedPackageNames, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, TMap<FAssetIdentifier, int32>& OutNodeSizes) const;
-	void GatherAssetData(const TSet<FName>& AllPackageNames, TMap<FName, FAssetData>& OutPackageToAssetDataMap) const;
-	class URefNode* RecursivelyConstructNodes(bool bReferencers, URefNode* RootNode, const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, const TMap<FAssetIdentifier, int32>& NodeSizes, const TMap<FName, FAssetData>& PackagesToAssetDataMap, const TSet<FName>& AllowedPackageNames, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames);
+	/** Builds the graph on the calling thread */
+	URefNode* BuildGraph(bool bReuseNodes);
+	/** Starts a background build, or builds on the calling thread if the settings do not allow one */
+	void StartBuild(bool bReuseNodes);
+	/** Captures the current search settings for a layout build */
+	FRefGraphLayoutSettings CreateLayoutSettings() const;
+	/** Returns true if the current settings only need the dependency graph snapshot, which worker threads may read */
+	bool CanBuildAsync() const;
+	/**
+	 * Replaces the nodes with the nodes of a layout, returns the root node.
+	 * With bReuseNodes, nodes showing the same identifiers as before are moved instead of recreated,
+	 * so only nodes entering or leaving the graph are created or removed.
+	 */
+	URefNode* CreateNodesFromLayout(const FRefGraphLayout& Layout, bool bReuseNodes);
+	/** Creates the nodes of a finished background build, unless a newer build replaced it */
+	void HandleBuildFinished(TSharedRef<FRefGraphBuildTask, ESPMode::ThreadSafe> Task);
+	/** Shows the progress of a running background build in a notification */
+	bool HandleBuildProgressTicker(float DeltaTime);
+	/** Stops reporting the progress of the background build and dismisses its notification */
+	void StopBuildProgress();
 
+	void GatherAssetData(const TSet<FName>& AllPackageNames, TMap<FName, FAssetData>& OutPackageToAssetDataMap) const;
 	EAssetRegistryDependencyType::Type GetReferenceSearchFlags(bool bHardOnly) const;
-	bool ExceedsMaxSearchDepth(int32 Depth) const;
-	bool ExceedsMaxSearchBreadth(int32 Breadth) const;
 	URefNode* CreateReferenceNode();
 	/** Removes all nodes from the graph */
 	void RemoveAllNodes();
@@ -59,4 +97,16 @@ private:
 	bool bIsShowManagementReferences;
 	bool bIsShowSearchableNames;
 	bool bIsShowNativePackages;
+
+	/** Registry references shared by the size pass, the node pass and re-rooting. Background builds fill it as well, and a cancelled build may still be filling it while the next one starts */
+	TSharedPtr<FRefClosureCache, ESPMode::ThreadSafe> ReferenceCache;
+
+	/** The running background build, null if there is none */
+	TSharedPtr<FRefGraphBuildTask, ESPMode::ThreadSafe> BuildTask;
+
+	/** Notification showing the progress of the running background build, null until the build takes a while */
+	TSharedPtr<SNotificationItem> BuildNotification;
+
+	/** Ticker updating BuildNotification */
+	FDelegateHandle BuildProgressTickerHandle;
 };
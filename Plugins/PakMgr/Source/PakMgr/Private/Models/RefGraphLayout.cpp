@@ -0,0 +1,267 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "Models/RefGraphLayout.h"
+#include "PakMgrTrace.h"
+
+
+/* FRefGraphLayoutBuilder structors
+ *****************************************************************************/
+
+FRefGraphLayoutBuilder::FRefGraphLayoutBuilder(const FRefGraphLayoutSettings& InSettings, FRefClosureCache& InCache, const FThreadSafeBool* InCancelFlag, FThreadSafeCounter* InNumVisited)
+	: Settings(InSettings)
+	, Cache(InCache)
+	, CancelFlag(InCancelFlag)
+	, NumVisited(InNumVisited)
+{ }
+
+
+/* FRefGraphLayoutBuilder interface
+ *****************************************************************************/
+
+bool FRefGraphLayoutBuilder::Build(const TArray<FAssetIdentifier>& Roots, const FIntPoint& Origin, FRefGraphLayout& OutLayout)
+{
+	PAKMGR_TRACE_SCOPE(LayoutRefGraph);
+
+	OutLayout.Nodes.Reset();
+
+	if (Roots.Num() == 0)
+	{
+		return !IsCancelled();
+	}
+
+	TMap<FAssetIdentifier, int32> ReferencerNodeSizes;
+	TSet<FAssetIdentifier> VisitedReferencerSizeNames;
+	RecursivelyGatherSizes(/*bReferencers=*/true, Roots, 1, VisitedReferencerSizeNames, ReferencerNodeSizes);
+
+	TMap<FAssetIdentifier, int32> DependencyNodeSizes;
+	TSet<FAssetIdentifier> VisitedDependencySizeNames;
+	RecursivelyGatherSizes(/*bReferencers=*/false, Roots, 1, VisitedDependencySizeNames, DependencyNodeSizes);
+
+	if (IsCancelled())
+	{
+		return false;
+	}
+
+	// the root is shared by both directions
+	AddNode(Roots, Origin, INDEX_NONE, false, false, OutLayout);
+
+	TSet<FAssetIdentifier> VisitedReferencerNames;
+	RecursivelyPlaceNodes(/*bReferencers=*/true, Roots, Origin, INDEX_NONE, false, ReferencerNodeSizes, 1, VisitedReferencerNames, OutLayout);
+
+	TSet<FAssetIdentifier> VisitedDependencyNames;
+	RecursivelyPlaceNodes(/*bReferencers=*/false, Roots, Origin, INDEX_NONE, false, DependencyNodeSizes, 1, VisitedDependencyNames, OutLayout);
+
+	return !IsCancelled();
+}
+
+
+/* FRefGraphLayoutBuilder implementation
+ *****************************************************************************/
+
+int32 FRefGraphLayoutBuilder::RecursivelyGatherSizes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, TMap<FAssetIdentifier, int32>& OutNodeSizes)
+{
+	check(Identifiers.Num() > 0);
+
+	VisitedNames.Append(Identifiers);
+
+	if (NumVisited != nullptr)
+	{
+		NumVisited->Add(Identifiers.Num());
+	}
+
+	TArray<FAssetIdentifier> ReferenceNames;
+
+	for (const FAssetIdentifier& AssetId : Identifiers)
+	{
+		ReferenceNames.Append(FindOrGatherReferences(AssetId, bReferencers).References);
+	}
+
+	int32 NodeSize = 0;
+	if (ReferenceNames.Num() > 0 && !ExceedsMaxSearchDepth(CurrentDepth))
+	{
+		int32 NumReferencesMade = 0;
+		int32 NumReferencesExceedingMax = 0;
+
+		// Since there are referencers, use the size of all your combined referencers.
+		// Do not count your own size since there could just be a horizontal line of nodes
+		for (FAssetIdentifier& AssetId : ReferenceNames)
+		{
+			if (IsCancelled())
+			{
+				break;
+			}
+
+			if (!VisitedNames.Contains(AssetId) && IsAllowed(AssetId))
+			{
+				if (!ExceedsMaxSearchBreadth(NumReferencesMade))
+				{
+					TArray<FAssetIdentifier> NewPackageNames;
+					NewPackageNames.Add(AssetId);
+					NodeSize += RecursivelyGatherSizes(bReferencers, NewPackageNames, CurrentDepth + 1, VisitedNames, OutNodeSizes);
+					NumReferencesMade++;
+				}
+				else
+				{
+					NumReferencesExceedingMax++;
+				}
+			}
+		}
+
+		if (NumReferencesExceedingMax > 0)
+		{
+			// Add one size for the collapsed node
+			NodeSize++;
+		}
+	}
+
+	if (NodeSize == 0)
+	{
+		// If you have no valid children, the node size is just 1 (counting only self to make a straight line)
+		NodeSize = 1;
+	}
+
+	OutNodeSizes.Add(Identifiers[0], NodeSize);
+	return NodeSize;
+}
+
+
+int32 FRefGraphLayoutBuilder::RecursivelyPlaceNodes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, int32 Parent, bool bIsHardLink, const TMap<FAssetIdentifier, int32>& NodeSizes, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, FRefGraphLayout& OutLayout)
+{
+	check(Identifiers.Num() > 0);
+
+	VisitedNames.Append(Identifiers);
+
+	// Don't add the root node. It is already added!
+	const int32 NodeIndex = (Parent == INDEX_NONE) ? 0 : AddNode(Identifiers, NodeLoc, Parent, bReferencers, bIsHardLink, OutLayout);
+
+	TArray<FAssetIdentifier> ReferenceNames;
+	TSet<FAssetIdentifier> HardReferenceNames;
+
+	for (const FAssetIdentifier& AssetId : Identifiers)
+	{
+		const FRefClosureCache::FEntry& Entry = FindOrGatherReferences(AssetId, bReferencers);
+
+		for (int32 EntryIdx = 0; EntryIdx < Entry.References.Num(); ++EntryIdx)
+		{
+			if (Entry.IsHardReference(EntryIdx))
+			{
+				HardReferenceNames.Add(Entry.References[EntryIdx]);
+			}
+		}
+
+		ReferenceNames.Append(Entry.References);
+	}
+
+	if (ReferenceNames.Num() > 0 && !ExceedsMaxSearchDepth(CurrentDepth))
+	{
+		FIntPoint ReferenceNodeLoc = NodeLoc;
+
+		if (bReferencers)
+		{
+			// Referencers go left
+			ReferenceNodeLoc.X -= 800;
+		}
+		else
+		{
+			// Dependencies go right
+			ReferenceNodeLoc.X += 800;
+		}
+
+		const int32 NodeSizeY = 200;
+		const int32 TotalReferenceSizeY = NodeSizes.FindChecked(Identifiers[0]) * NodeSizeY;
+
+		ReferenceNodeLoc.Y -= TotalReferenceSizeY * 0.5f;
+		ReferenceNodeLoc.Y += NodeSizeY * 0.5f;
+
+		int32 NumReferencesMade = 0;
+		int32 NumReferencesExceedingMax = 0;
+
+		for (int32 RefIdx = 0; RefIdx < ReferenceNames.Num(); ++RefIdx)
+		{
+			if (IsCancelled())
+			{
+				return NodeIndex;
+			}
+
+			FAssetIdentifier ReferenceName = ReferenceNames[RefIdx];
+
+			if (!VisitedNames.Contains(ReferenceName) && IsAllowed(ReferenceName))
+			{
+				if (!ExceedsMaxSearchBreadth(NumReferencesMade))
+				{
+					int32 ThisNodeSizeY = ReferenceName.IsValue() ? 100 : NodeSizeY;
+
+					const int32 RefSizeY = NodeSizes.FindChecked(ReferenceName);
+					FIntPoint RefNodeLoc;
+					RefNodeLoc.X = ReferenceNodeLoc.X;
+					RefNodeLoc.Y = ReferenceNodeLoc.Y + RefSizeY * ThisNodeSizeY * 0.5 - ThisNodeSizeY * 0.5;
+
+					TArray<FAssetIdentifier> NewIdentifiers;
+					NewIdentifiers.Add(ReferenceName);
+
+					RecursivelyPlaceNodes(bReferencers, NewIdentifiers, RefNodeLoc, NodeIndex, HardReferenceNames.Contains(ReferenceName), NodeSizes, CurrentDepth + 1, VisitedNames, OutLayout);
+
+					ReferenceNodeLoc.Y += RefSizeY * ThisNodeSizeY;
+					NumReferencesMade++;
+				}
+				else
+				{
+					NumReferencesExceedingMax++;
+				}
+			}
+		}
+
+		if (NumReferencesExceedingMax > 0)
+		{
+			// There are more references than allowed to be displayed. Make a collapsed node.
+			const int32 CollapsedIndex = AddNode(TArray<FAssetIdentifier>(), ReferenceNodeLoc, NodeIndex, bReferencers, false, OutLayout);
+			OutLayout.Nodes[CollapsedIndex].NumCollapsed = NumReferencesExceedingMax;
+		}
+	}
+
+	return NodeIndex;
+}
+
+
+int32 FRefGraphLayoutBuilder::AddNode(const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, int32 Parent, bool bIsReferencer, bool bIsHardLink, FRefGraphLayout& OutLayout) const
+{
+	FRefGraphLayout::FNode& Node = OutLayout.Nodes.AddDefaulted_GetRef();
+	Node.Identifiers = Identifiers;
+	Node.Location = NodeLoc;
+	Node.NumCollapsed = 0;
+	Node.Parent = Parent;
+	Node.bIsReferencer = bIsReferencer;
+	Node.bIsHardLink = bIsHardLink;
+
+	return OutLayout.Nodes.Num() - 1;
+}
+
+
+const FRefClosureCache::FEntry& FRefGraphLayoutBuilder::FindOrGatherReferences(const FAssetIdentifier& AssetId, bool bReferencers)
+{
+	return Cache.FindOrGather(AssetId, bReferencers, Settings.SearchFlags, Settings.HardSearchFlags, Settings.bShowNativePackages, Settings.SnapshotGraph);
+}
+
+
+bool FRefGraphLayoutBuilder::IsAllowed(const FAssetIdentifier& AssetId) const
+{
+	return !AssetId.IsPackage() || !Settings.bFilterByCollection || Settings.AllowedPackageNames.Contains(AssetId.PackageName);
+}
+
+
+bool FRefGraphLayoutBuilder::ExceedsMaxSearchDepth(int32 Depth) const
+{
+	return Settings.bLimitSearchDepth && Depth > Settings.MaxSearchDepth;
+}
+
+
+bool FRefGraphLayoutBuilder::ExceedsMaxSearchBreadth(int32 Breadth) const
+{
+	return Settings.bLimitSearchBreadth && Breadth > Settings.MaxSearchBreadth;
+}
+
+
+bool FRefGraphLayoutBuilder::IsCancelled() const
+{
+	return (CancelFlag != nullptr) && *CancelFlag;
+}
@@ -0,0 +1,136 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetData.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/AssetRegistryInterface.h"
+#include "Models/RefClosureCache.h"
+
+/**
+ * Planned reference graph: the nodes to show, where to put them and how they are linked.
+ *
+ * A layout holds no UObjects, so it can be computed on any thread and turned into URefNodes on
+ * the game thread afterwards.
+ */
+struct FRefGraphLayout
+{
+	/** A planned node. */
+	struct FNode
+	{
+		/** Holds the identifiers shown by the node, empty for collapsed nodes. */
+		TArray<FAssetIdentifier> Identifiers;
+
+		/** Holds the position of the node. */
+		FIntPoint Location;
+
+		/** Holds the number of references a collapsed node stands for, zero for other nodes. */
+		int32 NumCollapsed;
+
+		/** Holds the index of the node this node was reached from, INDEX_NONE for the root. */
+		int32 Parent;
+
+		/** Holds whether the node references its parent (true) or is referenced by it (false). */
+		bool bIsReferencer;
+
+		/** Holds whether the link to the parent is a hard reference. */
+		bool bIsHardLink;
+	};
+
+	/** Holds the nodes, the root first and every node after its parent. */
+	TArray<FNode> Nodes;
+};
+
+
+/**
+ * Settings of a reference graph layout, captured from the graph when a build starts.
+ */
+struct FRefGraphLayoutSettings
+{
+	/** Holds all dependency types to follow. */
+	EAssetRegistryDependencyType::Type SearchFlags;
+
+	/** Holds the subset of SearchFlags that counts as a hard reference. */
+	EAssetRegistryDependencyType::Type HardSearchFlags;
+
+	/** Holds the number of levels shown in each direction, if bLimitSearchDepth is set. */
+	int32 MaxSearchDepth;
+
+	/** Holds the number of references shown per node before the rest is collapsed, if bLimitSearchBreadth is set. */
+	int32 MaxSearchBreadth;
+
+	/** Holds the packages allowed by the collection filter, if bFilterByCollection is set. */
+	TSet<FName> AllowedPackageNames;
+
+	/** Holds the snapshot references are taken from instead of the asset registry, required on worker threads. */
+	FPakMgrDependencyGraphPtr SnapshotGraph;
+
+	bool bLimitSearchDepth;
+	bool bLimitSearchBreadth;
+	bool bFilterByCollection;
+	bool bShowNativePackages;
+};
+
+
+/**
+ * Computes reference graph layouts.
+ *
+ * The layout is built in two passes over the references: the first one computes the height of
+ * every subtree, the second one places the nodes. References are taken from a closure cache, which
+ * may be shared with other builders. A builder running on a worker thread needs a graph snapshot
+ * (see FRefGraphLayoutSettings::SnapshotGraph).
+ */
+class FRefGraphLayoutBuilder
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InSettings The layout settings.
+	 * @param InCache The cache to take references from.
+	 * @param InCancelFlag Optional flag that stops the build when set.
+	 * @param InNumVisited Optional counter of the identifiers visited so far, for progress reporting.
+	 */
+	FRefGraphLayoutBuilder(const FRefGraphLayoutSettings& InSettings, FRefClosureCache& InCache, const FThreadSafeBool* InCancelFlag = nullptr, FThreadSafeCounter* InNumVisited = nullptr);
+
+public:
+
+	/**
+	 * Builds the layout around a root.
+	 *
+	 * @param Roots The identifiers shown by the root node.
+	 * @param Origin The position of the root node.
+	 * @param OutLayout Will hold the layout.
+	 * @return false if the build was cancelled.
+	 */
+	bool Build(const TArray<FAssetIdentifier>& Roots, const FIntPoint& Origin, FRefGraphLayout& OutLayout);
+
+private:
+
+	int32 RecursivelyGatherSizes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, TMap<FAssetIdentifier, int32>& OutNodeSizes);
+	int32 RecursivelyPlaceNodes(bool bReferencers, const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, int32 Parent, bool bIsHardLink, const TMap<FAssetIdentifier, int32>& NodeSizes, int32 CurrentDepth, TSet<FAssetIdentifier>& VisitedNames, FRefGraphLayout& OutLayout);
+	int32 AddNode(const TArray<FAssetIdentifier>& Identifiers, const FIntPoint& NodeLoc, int32 Parent, bool bIsReferencer, bool bIsHardLink, FRefGraphLayout& OutLayout) const;
+
+	const FRefClosureCache::FEntry& FindOrGatherReferences(const FAssetIdentifier& AssetId, bool bReferencers);
+	bool IsAllowed(const FAssetIdentifier& AssetId) const;
+	bool ExceedsMaxSearchDepth(int32 Depth) const;
+	bool ExceedsMaxSearchBreadth(int32 Breadth) const;
+	bool IsCancelled() const;
+
+private:
+
+	/** Holds the layout settings. */
+	const FRefGraphLayoutSettings& Settings;
+
+	/** Holds the cache references are taken from. */
+	FRefClosureCache& Cache;
+
+	/** Holds the cancel flag, may be null. */
+	const FThreadSafeBool* CancelFlag;
+
+	/** Holds the progress counter, may be null. */
+	FThreadSafeCounter* NumVisited;
+};
@@ -5,6 +5,7 @@
 #include "GenericPlatform/GenericPlatformFile.h"
 #include "EdGraph/EdGraphPin.h"
 #include "HAL/PlatformFilemanager.h"
+#include "Models/PackageRoots.h"
 
 #define LOCTEXT_NAMESPACE "RefNode"
 
@@ -64,7 +65,11 @@ void URefNode::SetupReferenceNode(const FIntPoint& NodeLoc, const TArray<FAssetI
 	}
 
 	CacheAssetData(InAssetData);
-	AllocateDefaultPins();
+
+	if (ReferencerPin == NULL)
+	{
+		AllocateDefaultPins();
+	}
 }
 
 void URefNode::SetReferenceNodeCollapsed(const FIntPoint& NodeLoc, int32 InNumReferencesExceedingMax)
@@ -79,7 +84,11 @@ void URefNode::SetReferenceNodeCollapsed(const FIntPoint& NodeLoc, int32 InNumRe
 
 	NodeTitle = LOCTEXT("ReferenceNodeCollapsedTitle", "Collapsed nodes");
 	CacheAssetData(FAssetData());
-	AllocateDefaultPins();
+
+	if (ReferencerPin == NULL)
+	{
+		AllocateDefaultPins();
+	}
 }
 
 void URefNode::AddReferencer(URefNode* ReferencerNode)
@@ -94,6 +103,17 @@ void URefNode::AddReferencer(URefNode* ReferencerNode)
 	}
 }
 
+void URefNode::ResetReferenceLinks()
+{
+	BreakAllNodeLinks();
+
+	for (UEdGraphPin* Pin : Pins)
+	{
+		Pin->PinType.PinCategory = NAME_None;
+		Pin->bHidden = true;
+	}
+}
+
 FAssetIdentifier URefNode::GetIdentifier() const
 {
 	if (Identifiers.Num() > 0)
@@ -178,7 +198,7 @@ UObject* URefNode::GetJumpTargetForDoubleClick() const
 	if (Identifiers.Num() > 0)
 	{
 		GetReferenceViewerGraph()->SetGraphRoot(Identifiers, FIntPoint(NodePosX, NodePosY));
-		GetReferenceViewerGraph()->RebuildGraph();
+		GetReferenceViewerGraph()->RefocusGraphAsync();
 	}
 	return NULL;
 }
@@ -207,16 +227,19 @@ void URefNode::CacheAssetData(const FAssetData& AssetData)
 
 		if (Identifiers.Num() == 1)
 		{
-			const FString PackageNameStr = Identifiers[0].PackageName.ToString();
-			if (FPackageName::IsValidLongPackageName(PackageNameStr, true))
+			FPakMgrPackageRoots& PackageRoots = FPakMgrPackageRoots::Get();
+			const FName PackageName = Identifiers[0].PackageName;
+
+			if (PackageRoots.IsScriptPackage(PackageName))
 			{
-				if (PackageNameStr.StartsWith(TEXT("/Script")))
-				{
-					CachedAssetData.AssetClass = FName(TEXT("Code"));
-				}
-				else
+				CachedAssetData.AssetClass = FName(TEXT("Code"));
+			}
+			else
+			{
+				FString PotentiallyMapFilename;
+				if (PackageRoots.TryConvertToFilename(PackageName, PotentiallyMapFilename))
 				{
-					const FString PotentiallyMapFilename = FPackageName::LongPackageNameToFilename(PackageNameStr, FPackageName::GetMapPackageExtension());
+					PotentiallyMapFilename += FPackageName::GetMapPackageExtension();
 					const bool bIsMapPackage = FPlatformFileManager::Get().GetPlatformFile().FileExists(*PotentiallyMapFilename);
 					if (bIsMapPackage)
 					{
@@ -50,6 +50,8 @@ private:
 	void SetupReferenceNode(const FIntPoint& NodeLoc, const TArray<FAssetIdentifier>& NewIdentifiers, const FAssetData& InAssetData);
 	void SetReferenceNodeCollapsed(const FIntPoint& NodeLoc, int32 InNumReferencesExceedingMax);
 	void AddReferencer(class URefNode* ReferencerNode);
+	/** Breaks and hides all links so the node can be placed in a new layout */
+	void ResetReferenceLinks();
 
 	TArray<FAssetIdentifier> Identifiers;
 	FText NodeTitle;
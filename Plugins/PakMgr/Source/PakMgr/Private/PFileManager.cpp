@@ -180,6 +180,25 @@ bool FPFileManager::SetAddModule(FString& moduleName)
 }
 
 
+const TArray<FPakModuleInfo>& FPFileManager::GetModules() const
+{
+	return Modules;
+}
+
+
+void FPFileManager::SetModules(const TArray<FPakModuleInfo>& InModules)
+{
+	Modules = InModules;
+	ModulesChangedDelegate.Broadcast();
+}
+
+
+FSimpleMulticastDelegate& FPFileManager::OnModulesChanged()
+{
+	return ModulesChangedDelegate;
+}
+
+
 /* FSessionManager implementation
  *****************************************************************************/
 
@@ -82,6 +82,9 @@ public:
 	virtual bool SelectSession(const TSharedPtr<IFileInfo>& Session) override;
 	virtual bool SetInstanceSelected(const TSharedRef<IFileInstanceInfo>& Instance, bool Selected) override;
 	virtual bool SetAddModule(FString& moduleName) override;
+	virtual const TArray<FPakModuleInfo>& GetModules() const override;
+	virtual void SetModules(const TArray<FPakModuleInfo>& InModules) override;
+	virtual FSimpleMulticastDelegate& OnModulesChanged() override;
 
 protected:
 
@@ -142,6 +145,9 @@ private:
 	/** Holds the collection of discovered sessions. */
 	TMap<FGuid, TSharedPtr<FFileInfo>> Sessions;
 
+	/** Holds the generated pak modules. */
+	TArray<FPakModuleInfo> Modules;
+
 private:
 
 	/** Holds a delegate to be invoked before a session is selected. */
@@ -149,6 +155,9 @@ private:
 
 	FAddModuleEvent AddModuleDelegate;
 
+	/** Holds a delegate to be invoked when the generated modules changed. */
+	FSimpleMulticastDelegate ModulesChangedDelegate;
+
 	/** Holds a delegate to be invoked when an instance changes its selection state. */
 	FInstanceSelectionChangedEvent InstanceSelectionChangedDelegate;
 
@@ -0,0 +1,243 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakBuildCache.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/Archive.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+namespace PakBuildCache
+{
+	/** Identifies cache index files. */
+	const uint32 Magic = 0x50424331; // 'PBC1'
+
+	/** Version of the index format, bump to invalidate existing caches. */
+	const int32 Version = 1;
+
+	/** Name of the index file inside the cache directory. */
+	const TCHAR* IndexFilename = TEXT("BuildCache.bin");
+
+	/** Name of the block directory inside the cache directory. */
+	const TCHAR* BlocksDirectory = TEXT("Blocks");
+}
+
+
+/* FPakBuildCache::FEntry interface
+ *****************************************************************************/
+
+int64 FPakBuildCache::FEntry::GetCompressedSize() const
+{
+	int64 CompressedSize = 0;
+
+	for (int32 BlockSize : BlockSizes)
+	{
+		CompressedSize += BlockSize;
+	}
+
+	return CompressedSize;
+}
+
+
+FArchive& operator<<(FArchive& Ar, FPakBuildCache::FEntry& Entry)
+{
+	return Ar << Entry.Size << Entry.Timestamp << Entry.ContentHash << Entry.StoredHash << Entry.BlockSizes;
+}
+
+
+/* FPakBuildCache structors
+ *****************************************************************************/
+
+FPakBuildCache::FPakBuildCache(const FString& InDirectory, FName InCompressionFormat, int32 InCompressionBlockSize)
+	: Directory(InDirectory / FString::Printf(TEXT("%s_%d"), *InCompressionFormat.ToString(), InCompressionBlockSize))
+{ }
+
+
+/* FPakBuildCache interface
+ *****************************************************************************/
+
+void FPakBuildCache::Load()
+{
+	PAKMGR_TRACE_SCOPE(LoadBuildCache);
+
+	using namespace PakBuildCache;
+
+	TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*(Directory / IndexFilename)));
+
+	if (!Reader.IsValid())
+	{
+		return;
+	}
+
+	uint32 FileMagic = 0;
+	int32 FileVersion = 0;
+	TMap<FString, FEntry> LoadedEntries;
+
+	*Reader << FileMagic << FileVersion;
+
+	if ((FileMagic != Magic) || (FileVersion != Version))
+	{
+		UE_LOG(LogPakMgr, Log, TEXT("Ignoring outdated pak build cache in %s"), *Directory);
+		return;
+	}
+
+	*Reader << LoadedEntries;
+
+	if (Reader->IsError())
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("Ignoring damaged pak build cache in %s"), *Directory);
+		return;
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	Entries = MoveTemp(LoadedEntries);
+}
+
+
+void FPakBuildCache::Save()
+{
+	PAKMGR_TRACE_SCOPE(SaveBuildCache);
+
+	using namespace PakBuildCache;
+
+	FScopeLock Lock(&CriticalSection);
+
+	// write next to the index first, a crash while writing must not damage the cache
+	const FString Filename = Directory / IndexFilename;
+	const FString TempFilename = Filename + TEXT(".tmp");
+	TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFilename));
+
+	if (!Writer.IsValid())
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("Failed to save the pak build cache to %s"), *Directory);
+		return;
+	}
+
+	uint32 FileMagic = Magic;
+	int32 FileVersion = Version;
+
+	*Writer << FileMagic << FileVersion << Entries;
+
+	const bool bWritten = Writer->Close();
+	Writer.Reset();
+
+	// blocks are only pruned once the index no longer references them
+	if (!bWritten || !IFileManager::Get().Move(*Filename, *TempFilename, true, true, false, true))
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("Failed to save the pak build cache to %s"), *Directory);
+		IFileManager::Get().Delete(*TempFilename, false, false, true);
+		return;
+	}
+
+	TSet<FString> ReferencedBlocks;
+
+	for (const TPair<FString, FEntry>& Entry : Entries)
+	{
+		if (Entry.Value.BlockSizes.Num() > 0)
+		{
+			ReferencedBlocks.Add(FPaths::GetCleanFilename(GetBlocksFilename(Entry.Value)));
+		}
+	}
+
+	TArray<FString> BlockFiles;
+	IFileManager::Get().FindFiles(BlockFiles, *(Directory / BlocksDirectory), TEXT(".blocks"));
+
+	for (const FString& BlockFile : BlockFiles)
+	{
+		if (!ReferencedBlocks.Contains(BlockFile))
+		{
+			IFileManager::Get().Delete(*(Directory / BlocksDirectory / BlockFile), false, false, true);
+		}
+	}
+}
+
+
+bool FPakBuildCache::Find(const FString& Filename, FEntry& OutEntry) const
+{
+	FScopeLock Lock(&CriticalSection);
+	const FEntry* Entry = Entries.Find(Filename);
+
+	if (Entry == nullptr)
+	{
+		return false;
+	}
+
+	OutEntry = *Entry;
+
+	return true;
+}
+
+
+void FPakBuildCache::Store(const FString& Filename, const FEntry& Entry, const TArray<TArray<uint8>>& Blocks)
+{
+	if (Blocks.Num() > 0)
+	{
+		const FString BlocksFilename = GetBlocksFilename(Entry);
+
+		// blocks are content-addressed, existing ones already hold the same data
+		if (IFileManager::Get().FileSize(*BlocksFilename) != Entry.GetCompressedSize())
+		{
+			TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*BlocksFilename));
+
+			if (!Writer.IsValid())
+			{
+				return;
+			}
+
+			for (const TArray<uint8>& Block : Blocks)
+			{
+				Writer->Serialize(const_cast<uint8*>(Block.GetData()), Block.Num());
+			}
+
+			if (!Writer->Close())
+			{
+				IFileManager::Get().Delete(*BlocksFilename, false, false, true);
+				return;
+			}
+		}
+	}
+
+	FScopeLock Lock(&CriticalSection);
+	Entries.Add(Filename, Entry);
+}
+
+
+bool FPakBuildCache::LoadBlocks(const FEntry& Entry, TArray<TArray<uint8>>& OutBlocks) const
+{
+	PAKMGR_TRACE_SCOPE(LoadCachedBlocks);
+
+	TArray<uint8> Data;
+
+	if (!FFileHelper::LoadFileToArray(Data, *GetBlocksFilename(Entry), FILEREAD_Silent) || (Data.Num() != Entry.GetCompressedSize()))
+	{
+		return false;
+	}
+
+	// verify the blocks before they go into a pak
+	FSHAHash StoredHash;
+	FSHA1::HashBuffer(Data.GetData(), Data.Num(), StoredHash.Hash);
+
+	if (StoredHash != Entry.StoredHash)
+	{
+		return false;
+	}
+
+	int32 Offset = 0;
+	OutBlocks.Reset(Entry.BlockSizes.Num());
+
+	for (int32 BlockSize : Entry.BlockSizes)
+	{
+		OutBlocks.Emplace(Data.GetData() + Offset, BlockSize);
+		Offset += BlockSize;
+	}
+
+	return true;
+}
+
+
+FString FPakBuildCache::GetBlocksFilename(const FEntry& Entry) const
+{
+	return Directory / PakBuildCache::BlocksDirectory / Entry.ContentHash.ToString() + TEXT(".blocks");
+}
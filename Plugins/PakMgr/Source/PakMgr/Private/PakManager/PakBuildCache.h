@@ -0,0 +1,113 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+#include "HAL/CriticalSection.h"
+
+/**
+ * Persistent cache of compressed pak entries.
+ *
+ * For every cooked file the cache remembers its size, time stamp and content hash together with
+ * the compressed blocks it produced. Every combination of compression settings has its own
+ * subdirectory, inside which entries are keyed by the file's pak path, i.e. by package name. The
+ * blocks are stored content-addressed, so files that did not change can be copied into a new pak
+ * without compressing them again.
+ *
+ * All methods are thread-safe.
+ */
+class FPakBuildCache
+{
+public:
+
+	/** Cached state of a single cooked file. */
+	struct FEntry
+	{
+		/** Holds the size of the cooked file. */
+		int64 Size;
+
+		/** Holds the modification time of the cooked file. */
+		FDateTime Timestamp;
+
+		/** Holds the SHA1 hash of the cooked file. */
+		FSHAHash ContentHash;
+
+		/** Holds the SHA1 hash of the data stored in the pak. */
+		FSHAHash StoredHash;
+
+		/** Holds the size of each compressed block, empty if the file is stored uncompressed. */
+		TArray<int32> BlockSizes;
+
+		/** Default constructor. */
+		FEntry()
+			: Size(0)
+		{ }
+
+		/** Gets the total size of the compressed blocks. */
+		int64 GetCompressedSize() const;
+
+		/** Serializes an entry from or into an archive. */
+		friend FArchive& operator<<(FArchive& Ar, FEntry& Entry);
+	};
+
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InDirectory The root directory of the cache.
+	 * @param InCompressionFormat The compression format of the cached blocks.
+	 * @param InCompressionBlockSize The uncompressed block size of the cached blocks.
+	 */
+	FPakBuildCache(const FString& InDirectory, FName InCompressionFormat, int32 InCompressionBlockSize);
+
+public:
+
+	/** Loads the cache index, keeping the cache empty if there is none or it is outdated. */
+	void Load();
+
+	/** Saves the cache index and deletes blocks that are no longer referenced. The index is replaced in one step, a crash while saving keeps the previous one. */
+	void Save();
+
+	/**
+	 * Finds the entry of a file.
+	 *
+	 * @param Filename The file name inside the pak.
+	 * @param OutEntry Will hold the entry.
+	 * @return false if the file is not cached.
+	 */
+	bool Find(const FString& Filename, FEntry& OutEntry) const;
+
+	/**
+	 * Adds or replaces the entry of a file and stores its compressed blocks.
+	 *
+	 * @param Filename The file name inside the pak.
+	 * @param Entry The entry to store.
+	 * @param Blocks The compressed blocks, empty if they are stored already or the file is stored uncompressed.
+	 */
+	void Store(const FString& Filename, const FEntry& Entry, const TArray<TArray<uint8>>& Blocks);
+
+	/**
+	 * Loads the compressed blocks of an entry.
+	 *
+	 * @param Entry The entry to load the blocks of.
+	 * @param OutBlocks Will hold the blocks.
+	 * @return false if the blocks are missing or damaged.
+	 */
+	bool LoadBlocks(const FEntry& Entry, TArray<TArray<uint8>>& OutBlocks) const;
+
+	/** Gets the file holding the compressed blocks of an entry. */
+	FString GetBlocksFilename(const FEntry& Entry) const;
+
+private:
+
+	/** Holds the cache directory of the compression settings. */
+	FString Directory;
+
+	/** Holds the entries by pak file name. */
+	TMap<FString, FEntry> Entries;
+
+	/** Holds a critical section guarding the entries. */
+	mutable FCriticalSection CriticalSection;
+};
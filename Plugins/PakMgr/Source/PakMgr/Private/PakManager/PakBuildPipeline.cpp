@@ -0,0 +1,701 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakBuildPipeline.h"
+#include "Async/AsyncFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Compression.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Models/PackageRoots.h"
+#include "PakManager/PakManifest.h"
+#include "PakManager/PakWriter.h"
+#include "PakManager/PakPartitioner.h"
+#include "PakManager/PakSharedAnalysis.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+namespace PakBuildPipeline
+{
+	/** Extensions of the files a cooked package may consist of, the package file comes first. */
+	const TCHAR* CookedExtensions[] = { TEXT(".uasset"), TEXT(".umap"), TEXT(".uexp"), TEXT(".ubulk"), TEXT(".uptnl") };
+
+	/** Name of the paks holding the packages shared by several modules. */
+	const TCHAR* SharedPakName = TEXT("Common");
+}
+
+
+/* FPakBuildPipeline::FInFlightFile
+ *****************************************************************************/
+
+struct FPakBuildPipeline::FInFlightFile
+{
+	/** Holds the file being processed. */
+	const FPakBuildFile& File;
+
+	/** Holds the handle the file is read through. */
+	IAsyncReadFileHandle* ReadHandle;
+
+	/** Holds the pending read. */
+	IAsyncReadRequest* ReadRequest;
+
+	/** Holds the task compressing the file, completes once the file can be written. */
+	FGraphEventRef Processed;
+
+	/** Holds the file contents, released after compression unless the file is stored uncompressed. */
+	uint8* Data;
+
+	/** Holds the compressed blocks, empty if the file is stored uncompressed. */
+	TArray<TArray<uint8>> CompressedBlocks;
+
+	/** Holds the SHA1 hash of the stored data. */
+	uint8 Hash[20];
+
+	/** Holds the build cache entry of the file, valid if bHasCacheEntry is set. */
+	FPakBuildCache::FEntry CacheEntry;
+
+	/** Holds whether the build cache knows the file. */
+	bool bHasCacheEntry;
+
+	/** Holds whether the cached blocks are read instead of the cooked file. */
+	bool bReadingCachedBlocks;
+
+	/** Holds whether the stored data was taken from the build cache. */
+	bool bFromCache;
+
+	/** Holds whether the file was read and compressed successfully. */
+	bool bSucceeded;
+
+	FInFlightFile(const FPakBuildFile& InFile)
+		: File(InFile)
+		, ReadHandle(nullptr)
+		, ReadRequest(nullptr)
+		, Data(nullptr)
+		, bHasCacheEntry(false)
+		, bReadingCachedBlocks(false)
+		, bFromCache(false)
+		, bSucceeded(false)
+	{ }
+
+	~FInFlightFile()
+	{
+		delete ReadRequest;
+		delete ReadHandle;
+		FMemory::Free(Data);
+	}
+};
+
+
+/* FPakBuildPipeline structors
+ *****************************************************************************/
+
+FPakBuildPipeline::FPakBuildPipeline(const FPakBuildSettings& InSettings, bool bInManifestOnly)
+	: Settings(InSettings)
+	, bManifestOnly(bInManifestOnly)
+{
+	if (bManifestOnly)
+	{
+		return;
+	}
+
+	// uncompressed files are copied as they are, there is nothing worth caching
+	if (Settings.bUseBuildCache && (Settings.CompressionFormat != NAME_None))
+	{
+		Cache = MakeUnique<FPakBuildCache>(Settings.CacheDirectory, Settings.CompressionFormat, Settings.CompressionBlockSize);
+		Cache->Load();
+	}
+
+	if (Settings.bUseOpenOrder)
+	{
+		OpenOrder = MakeUnique<FPakOpenOrder>();
+
+		if (OpenOrder->Load(Settings.OpenOrderFilename))
+		{
+			UE_LOG(LogPakMgr, Log, TEXT("GenPaks: placing files in the open order of %d logged files from %s"), OpenOrder->Num(), *Settings.OpenOrderFilename);
+		}
+		else
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("GenPaks: failed to read the open order log %s, files are placed in dependency order"), *Settings.OpenOrderFilename);
+		}
+	}
+}
+
+
+/* FPakBuildPipeline interface
+ *****************************************************************************/
+
+bool FPakBuildPipeline::GatherPackageFiles(FName PackageName, TArray<FPakBuildFile>& OutFiles) const
+{
+	using namespace PakBuildPipeline;
+
+	FString CookedRelativeFilename;
+
+	if (!FPakMgrPackageRoots::Get().TryConvertToCookedFilename(PackageName, CookedRelativeFilename))
+	{
+		return false;
+	}
+
+	const int32 NumFilesBefore = OutFiles.Num();
+
+	for (const TCHAR* Extension : CookedExtensions)
+	{
+		const FString PakFilename = CookedRelativeFilename + Extension;
+		const FString SourceFilename = Settings.CookedDirectory / PakFilename;
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*SourceFilename);
+
+		if (StatData.bIsValid && !StatData.bIsDirectory)
+		{
+			FPakBuildFile& File = OutFiles.AddDefaulted_GetRef();
+			File.PackageName = PackageName;
+			File.SourceFilename = SourceFilename;
+			File.PakFilename = PakFilename;
+			File.Size = StatData.FileSize;
+			File.Timestamp = StatData.ModificationTime;
+		}
+	}
+
+	return OutFiles.Num() > NumFilesBefore;
+}
+
+
+bool FPakBuildPipeline::CreateModuleJobs(const TArray<FPakModuleInfo>& Modules, TArray<FPakBuildJob>& OutJobs) const
+{
+	PAKMGR_TRACE_SCOPE(CreateModuleJobs);
+
+	using namespace PakBuildPipeline;
+
+	FPakSharedAnalysis Analysis;
+	bool bExtractShared = false;
+
+	if (Settings.bExtractSharedPackages && (Modules.Num() > 1))
+	{
+		bExtractShared = FPakSharedAnalysis::Analyze(Modules, Settings.SharingThreshold, Analysis);
+
+		if (!bExtractShared)
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("GenPaks: modules were computed on different dependency graphs, shared packages are not extracted"));
+		}
+	}
+
+	if (bExtractShared && (Analysis.SharedNodes.Num() > 0))
+	{
+		TArray<FString> CommonModules;
+
+		for (int32 ModuleIndex = 0; ModuleIndex < Modules.Num(); ++ModuleIndex)
+		{
+			if (Analysis.ModulesUsingSharedNodes[ModuleIndex])
+			{
+				CommonModules.Add(Modules[ModuleIndex].Name);
+			}
+		}
+
+		CreateJobs(SharedPakName, Modules[0].Graph, Analysis.SharedNodes, CommonModules, OutJobs);
+
+		UE_LOG(LogPakMgr, Log, TEXT("GenPaks: moved %d packages used by at least %d of %d modules to common paks"), Analysis.SharedNodes.Num(), Settings.SharingThreshold, Modules.Num());
+	}
+
+	for (int32 ModuleIndex = 0; ModuleIndex < Modules.Num(); ++ModuleIndex)
+	{
+		const FPakModuleInfo& Module = Modules[ModuleIndex];
+
+		if (Module.Graph.IsValid())
+		{
+			CreateJobs(Module.Name, Module.Graph, bExtractShared ? Analysis.ModuleNodes[ModuleIndex] : Module.Closure.Nodes, { Module.Name }, OutJobs);
+		}
+	}
+
+	// pak file names are case insensitive on some platforms, and so is the set
+	TSet<FString> PakNames;
+
+	for (const FPakBuildJob& Job : OutJobs)
+	{
+		bool bIsAlreadyInSet = false;
+		PakNames.Add(Job.Name, &bIsAlreadyInSet);
+
+		if (bIsAlreadyInSet)
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("GenPaks: more than one pak would be named %s, please rename the module map that clashes with it"), *Job.Name);
+			OutJobs.Reset();
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+FPakBuildResult FPakBuildPipeline::BuildPak(const FPakBuildJob& Job)
+{
+	PAKMGR_TRACE_SCOPE_TEXT(BuildPak, Job.Name);
+
+	check(!bManifestOnly);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	FPakBuildResult Result;
+	Result.Name = Job.Name;
+	Result.PakFilename = Job.PakFilename;
+
+	FPakWriter Writer(Job.PakFilename, Settings.MountPoint);
+
+	if (!Writer.Open())
+	{
+		return Result;
+	}
+
+	TArray<TUniquePtr<FInFlightFile>> InFlightFiles;
+	InFlightFiles.SetNum(Job.Files.Num());
+
+	int32 NextFileToStart = 0;
+	int32 NextFileToWrite = 0;
+	int64 BytesInFlight = 0;
+	bool bFailed = false;
+
+	for (; NextFileToWrite < Job.Files.Num(); ++NextFileToWrite)
+	{
+		// keep readers and compressors busy up to the memory budget, but always allow one file
+		while ((NextFileToStart < Job.Files.Num()) && !bCancelRequested &&
+			((NextFileToStart == NextFileToWrite) || (BytesInFlight + Job.Files[NextFileToStart].Size <= Settings.MaxBytesInFlight)))
+		{
+			InFlightFiles[NextFileToStart] = StartFile(Job.Files[NextFileToStart]);
+			BytesInFlight += Job.Files[NextFileToStart].Size;
+			++NextFileToStart;
+		}
+
+		PAKMGR_TRACE_COUNTER(PakBytesInFlight, BytesInFlight);
+
+		if (bCancelRequested)
+		{
+			bFailed = true;
+			break;
+		}
+
+		FInFlightFile& InFlightFile = *InFlightFiles[NextFileToWrite];
+
+		if (InFlightFile.Processed.IsValid())
+		{
+			// time the writer spends here is time reading or compressing is behind
+			PAKMGR_TRACE_SCOPE(WaitForPakFile);
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(InFlightFile.Processed);
+		}
+
+		if (!InFlightFile.bSucceeded)
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("GenPaks: failed to read %s"), *InFlightFile.File.SourceFilename);
+			bFailed = true;
+			break;
+		}
+
+		TArray<TArrayView<const uint8>, TInlineAllocator<16>> Blocks;
+
+		if (InFlightFile.CompressedBlocks.Num() > 0)
+		{
+			for (const TArray<uint8>& Block : InFlightFile.CompressedBlocks)
+			{
+				Blocks.Add(Block);
+			}
+		}
+		else if (InFlightFile.File.Size > 0)
+		{
+			Blocks.Add(TArrayView<const uint8>(InFlightFile.Data, InFlightFile.File.Size));
+		}
+
+		const FName CompressionFormat = (InFlightFile.CompressedBlocks.Num() > 0) ? Settings.CompressionFormat : NAME_None;
+
+		if (!Writer.AddEntry(InFlightFile.File.PakFilename, CompressionFormat, Settings.CompressionBlockSize, InFlightFile.File.Size, Blocks, InFlightFile.Hash))
+		{
+			bFailed = true;
+			break;
+		}
+
+		Result.UncompressedSize += InFlightFile.File.Size;
+		Result.NumCachedFiles += InFlightFile.bFromCache ? 1 : 0;
+		BytesInFlight -= InFlightFile.File.Size;
+		InFlightFiles[NextFileToWrite].Reset();
+	}
+
+	// tasks reference the in-flight files, so let them finish before the files go away
+	for (int32 FileIndex = NextFileToWrite; FileIndex < NextFileToStart; ++FileIndex)
+	{
+		if (InFlightFiles[FileIndex].IsValid() && InFlightFiles[FileIndex]->Processed.IsValid())
+		{
+			FTaskGraphInterface::Get().WaitUntilTaskCompletes(InFlightFiles[FileIndex]->Processed);
+		}
+	}
+
+	InFlightFiles.Empty();
+
+	if (!bFailed)
+	{
+		Result.NumFiles = Writer.GetNumEntries();
+		Result.bSucceeded = Writer.Finalize();
+		Result.PakSize = IFileManager::Get().FileSize(*Job.PakFilename);
+	}
+
+	Result.Seconds = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogPakMgr, Log, TEXT("GenPaks: %s %s, %d files (%d from cache), %lld bytes -> %lld bytes in %.2f seconds"),
+		*Job.PakFilename, Result.bSucceeded ? TEXT("written") : TEXT("failed"), Result.NumFiles, Result.NumCachedFiles, Result.UncompressedSize, Result.PakSize, Result.Seconds);
+
+	return Result;
+}
+
+
+bool FPakBuildPipeline::BuildPaks(const TArray<FPakBuildJob>& Jobs)
+{
+	PAKMGR_TRACE_SCOPE(BuildPaks);
+
+	bool bSucceeded = true;
+
+	for (const FPakBuildJob& Job : Jobs)
+	{
+		if (bCancelRequested)
+		{
+			bSucceeded = false;
+			break;
+		}
+
+		FPakBuildResult Result = BuildPak(Job);
+		bSucceeded &= Result.bSucceeded;
+		CompletedResults.Enqueue(MoveTemp(Result));
+	}
+
+	// once per build, saving rewrites the whole index and scans the block directory
+	if (Cache.IsValid())
+	{
+		Cache->Save();
+	}
+
+	if (bSucceeded && !SaveManifest(Jobs))
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("GenPaks: failed to write the pak manifest to %s"), *Settings.OutputDirectory);
+	}
+
+	return bSucceeded;
+}
+
+
+bool FPakBuildPipeline::SaveManifest(const TArray<FPakBuildJob>& Jobs) const
+{
+	PAKMGR_TRACE_SCOPE(SaveManifest);
+
+	FPakManifest Manifest;
+	Manifest.Initialize(Jobs);
+
+	return Manifest.SaveBinary(GetManifestFilename()) && Manifest.SaveJson(Settings.OutputDirectory / TEXT("PakManifest.json"));
+}
+
+
+/* FPakBuildPipeline implementation
+ *****************************************************************************/
+
+void FPakBuildPipeline::CreateJobs(const FString& Name, const FPakMgrDependencyGraphPtr& Graph, const TArray<int32>& Nodes, const TArray<FString>& Modules, TArray<FPakBuildJob>& OutJobs) const
+{
+	PAKMGR_TRACE_SCOPE_TEXT(CreatePakJobs, Name);
+
+	TArray<TArray<int32>> Parts;
+
+	if (Settings.bLimitPakSize)
+	{
+		FPakPartitioner::Partition(*Graph, Nodes, Settings.MaxPakSize, Parts);
+	}
+	else
+	{
+		Parts.Add(Nodes);
+	}
+
+	for (int32 PartIndex = 0; PartIndex < Parts.Num(); ++PartIndex)
+	{
+		FPakBuildJob& Job = OutJobs.AddDefaulted_GetRef();
+		Job.Name = (Parts.Num() > 1) ? FString::Printf(TEXT("%s_%d"), *Name, PartIndex) : Name;
+		Job.PakFilename = Settings.OutputDirectory / Job.Name + TEXT(".pak");
+		Job.Modules = Modules;
+		Job.Graph = Graph;
+
+		for (int32 Node : Parts[PartIndex])
+		{
+			const FName PackageName = Graph->GetPackageName(Node);
+
+			if (!Graph->IsInRegistrySource(Node) || FPakMgrPackageRoots::Get().IsScriptPackage(PackageName))
+			{
+				continue;
+			}
+
+			if (!GatherPackageFiles(PackageName, Job.Files))
+			{
+				UE_LOG(LogPakMgr, Warning, TEXT("GenPaks: no cooked files found for %s in %s"), *PackageName.ToString(), *Settings.CookedDirectory);
+			}
+		}
+
+		if (OpenOrder.IsValid())
+		{
+			OpenOrder->SortFiles(*Graph, Job.Files);
+		}
+	}
+
+	if (Parts.Num() > 1)
+	{
+		UE_LOG(LogPakMgr, Log, TEXT("GenPaks: split %s into %d paks of at most %lld bytes"), *Name, Parts.Num(), Settings.MaxPakSize);
+	}
+}
+
+
+TUniquePtr<FPakBuildPipeline::FInFlightFile> FPakBuildPipeline::StartFile(const FPakBuildFile& File)
+{
+	TUniquePtr<FInFlightFile> InFlightFile = MakeUnique<FInFlightFile>(File);
+
+	if (File.Size == 0)
+	{
+		FSHA1::HashBuffer(nullptr, 0, InFlightFile->Hash);
+		InFlightFile->bSucceeded = true;
+
+		return InFlightFile;
+	}
+
+	FString ReadFilename = File.SourceFilename;
+	int64 ReadSize = File.Size;
+
+	if (Cache.IsValid() && Cache->Find(File.PakFilename, InFlightFile->CacheEntry))
+	{
+		InFlightFile->bHasCacheEntry = true;
+
+		// files that were not touched since the last build are copied without opening them
+		if ((InFlightFile->CacheEntry.Size == File.Size) && (InFlightFile->CacheEntry.Timestamp == File.Timestamp) && (InFlightFile->CacheEntry.BlockSizes.Num() > 0))
+		{
+			InFlightFile->bReadingCachedBlocks = true;
+			ReadFilename = Cache->GetBlocksFilename(InFlightFile->CacheEntry);
+			ReadSize = InFlightFile->CacheEntry.GetCompressedSize();
+		}
+	}
+
+	// compression waits for the read completion callback and for the request to be stored
+	FGraphEventRef ReadCompleted = FGraphEvent::CreateGraphEvent();
+	FGraphEventRef ReadIssued = FGraphEvent::CreateGraphEvent();
+	FGraphEventArray Prerequisites;
+	Prerequisites.Add(ReadCompleted);
+	Prerequisites.Add(ReadIssued);
+
+	FInFlightFile* InFlightFilePtr = InFlightFile.Get();
+
+	InFlightFile->Processed = FFunctionGraphTask::CreateAndDispatchWhenReady([this, InFlightFilePtr]()
+	{
+		CompressFile(*InFlightFilePtr);
+	}, TStatId(), &Prerequisites);
+
+	FAsyncFileCallBack ReadCallback = [ReadCompleted](bool /*bWasCancelled*/, IAsyncReadRequest* /*Request*/)
+	{
+		TArray<FBaseGraphTask*> NewTasks;
+		ReadCompleted->DispatchSubsequents(NewTasks);
+	};
+
+	InFlightFile->ReadHandle = FPlatformFileManager::Get().GetPlatformFile().OpenAsyncRead(*ReadFilename);
+	InFlightFile->ReadRequest = InFlightFile->ReadHandle->ReadRequest(0, ReadSize, AIOP_Normal, &ReadCallback);
+
+	TArray<FBaseGraphTask*> NewTasks;
+	ReadIssued->DispatchSubsequents(NewTasks);
+
+	return InFlightFile;
+}
+
+
+void FPakBuildPipeline::CompressFile(FInFlightFile& InFlightFile) const
+{
+	PAKMGR_TRACE_SCOPE_TEXT(CompressFile, InFlightFile.File.PakFilename);
+
+	InFlightFile.ReadRequest->WaitCompletion();
+	InFlightFile.Data = InFlightFile.ReadRequest->GetReadResults();
+
+	delete InFlightFile.ReadRequest;
+	InFlightFile.ReadRequest = nullptr;
+	delete InFlightFile.ReadHandle;
+	InFlightFile.ReadHandle = nullptr;
+
+	const int64 Size = InFlightFile.File.Size;
+
+	if (InFlightFile.bReadingCachedBlocks)
+	{
+		const FPakBuildCache::FEntry& CacheEntry = InFlightFile.CacheEntry;
+		FSHAHash StoredHash;
+
+		if (InFlightFile.Data != nullptr)
+		{
+			FSHA1::HashBuffer(InFlightFile.Data, CacheEntry.GetCompressedSize(), StoredHash.Hash);
+		}
+
+		if ((InFlightFile.Data != nullptr) && (StoredHash == CacheEntry.StoredHash))
+		{
+			int64 Offset = 0;
+
+			for (int32 BlockSize : CacheEntry.BlockSizes)
+			{
+				InFlightFile.CompressedBlocks.Emplace(InFlightFile.Data + Offset, BlockSize);
+				Offset += BlockSize;
+			}
+
+			FMemory::Memcpy(InFlightFile.Hash, CacheEntry.StoredHash.Hash, sizeof(InFlightFile.Hash));
+			FMemory::Free(InFlightFile.Data);
+			InFlightFile.Data = nullptr;
+			InFlightFile.bFromCache = true;
+			InFlightFile.bSucceeded = true;
+
+			return;
+		}
+
+		UE_LOG(LogPakMgr, Warning, TEXT("GenPaks: build cache entry of %s is damaged, recompressing"), *InFlightFile.File.PakFilename);
+
+		// fall back to the cooked file
+		FMemory::Free(InFlightFile.Data);
+		InFlightFile.Data = nullptr;
+		InFlightFile.bHasCacheEntry = false;
+
+		TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*InFlightFile.File.SourceFilename));
+
+		if (!Reader.IsValid() || (Reader->TotalSize() != Size))
+		{
+			return;
+		}
+
+		InFlightFile.Data = (uint8*)FMemory::Malloc(Size);
+		Reader->Serialize(InFlightFile.Data, Size);
+
+		if (!Reader->Close())
+		{
+			return;
+		}
+	}
+
+	if (InFlightFile.Data == nullptr)
+	{
+		return;
+	}
+
+	FSHAHash ContentHash;
+
+	if (Cache.IsValid())
+	{
+		FSHA1::HashBuffer(InFlightFile.Data, Size, ContentHash.Hash);
+
+		if (ReuseCachedBlocks(InFlightFile, ContentHash))
+		{
+			InFlightFile.bFromCache = true;
+			InFlightFile.bSucceeded = true;
+
+			return;
+		}
+	}
+
+	if (Settings.CompressionFormat != NAME_None)
+	{
+		const int32 BlockSize = Settings.CompressionBlockSize;
+		const int32 NumBlocks = (int32)((Size + BlockSize - 1) / BlockSize);
+		FThreadSafeBool bCompressionFailed;
+
+		InFlightFile.CompressedBlocks.SetNum(NumBlocks);
+
+		ParallelFor(NumBlocks, [&](int32 BlockIndex)
+		{
+			const int64 BlockOffset = (int64)BlockIndex * BlockSize;
+			const int32 UncompressedBlockSize = (int32)FMath::Min<int64>(BlockSize, Size - BlockOffset);
+			int32 CompressedBlockSize = FCompression::CompressMemoryBound(Settings.CompressionFormat, UncompressedBlockSize);
+			TArray<uint8>& Block = InFlightFile.CompressedBlocks[BlockIndex];
+
+			Block.SetNumUninitialized(CompressedBlockSize);
+
+			if (FCompression::CompressMemory(Settings.CompressionFormat, Block.GetData(), CompressedBlockSize, InFlightFile.Data + BlockOffset, UncompressedBlockSize))
+			{
+				Block.SetNum(CompressedBlockSize, false);
+			}
+			else
+			{
+				bCompressionFailed = true;
+			}
+		});
+
+		int64 CompressedSize = 0;
+
+		for (const TArray<uint8>& Block : InFlightFile.CompressedBlocks)
+		{
+			CompressedSize += Block.Num();
+		}
+
+		// like UnrealPak, files that do not shrink are stored as they are
+		if (bCompressionFailed || (CompressedSize >= Size))
+		{
+			InFlightFile.CompressedBlocks.Empty();
+		}
+	}
+
+	if (InFlightFile.CompressedBlocks.Num() > 0)
+	{
+		FSHA1 Sha;
+
+		for (const TArray<uint8>& Block : InFlightFile.CompressedBlocks)
+		{
+			Sha.Update(Block.GetData(), Block.Num());
+		}
+
+		Sha.Final();
+		Sha.GetHash(InFlightFile.Hash);
+
+		FMemory::Free(InFlightFile.Data);
+		InFlightFile.Data = nullptr;
+	}
+	else
+	{
+		FSHA1::HashBuffer(InFlightFile.Data, Size, InFlightFile.Hash);
+	}
+
+	if (Cache.IsValid())
+	{
+		FPakBuildCache::FEntry CacheEntry;
+		CacheEntry.Size = Size;
+		CacheEntry.Timestamp = InFlightFile.File.Timestamp;
+		CacheEntry.ContentHash = ContentHash;
+		FMemory::Memcpy(CacheEntry.StoredHash.Hash, InFlightFile.Hash, sizeof(InFlightFile.Hash));
+
+		for (const TArray<uint8>& Block : InFlightFile.CompressedBlocks)
+		{
+			CacheEntry.BlockSizes.Add(Block.Num());
+		}
+
+		Cache->Store(InFlightFile.File.PakFilename, CacheEntry, InFlightFile.CompressedBlocks);
+	}
+
+	InFlightFile.bSucceeded = true;
+}
+
+
+bool FPakBuildPipeline::ReuseCachedBlocks(FInFlightFile& InFlightFile, const FSHAHash& ContentHash) const
+{
+	FPakBuildCache::FEntry& CacheEntry = InFlightFile.CacheEntry;
+
+	if (!InFlightFile.bHasCacheEntry || (CacheEntry.Size != InFlightFile.File.Size) || (CacheEntry.ContentHash != ContentHash))
+	{
+		return false;
+	}
+
+	// files that did not shrink last time are stored as they are again
+	if ((CacheEntry.BlockSizes.Num() > 0) && !Cache->LoadBlocks(CacheEntry, InFlightFile.CompressedBlocks))
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(InFlightFile.Hash, CacheEntry.StoredHash.Hash, sizeof(InFlightFile.Hash));
+
+	if (InFlightFile.CompressedBlocks.Num() > 0)
+	{
+		FMemory::Free(InFlightFile.Data);
+		InFlightFile.Data = nullptr;
+	}
+
+	// only the time stamp changed, remember it so the next build skips reading the file
+	CacheEntry.Timestamp = InFlightFile.File.Timestamp;
+	Cache->Store(InFlightFile.File.PakFilename, CacheEntry, TArray<TArray<uint8>>());
+
+	return true;
+}
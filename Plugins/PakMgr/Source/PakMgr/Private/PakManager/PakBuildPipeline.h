@@ -0,0 +1,255 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Models/PakModuleInfo.h"
+#include "PakManager/PakBuildSettings.h"
+#include "PakManager/PakBuildCache.h"
+#include "PakManager/PakOpenOrder.h"
+
+/**
+ * Structure for a cooked file to store in a pak.
+ */
+struct FPakBuildFile
+{
+	/** Holds the package the file belongs to. */
+	FName PackageName;
+
+	/** Holds the absolute path of the cooked file. */
+	FString SourceFilename;
+
+	/** Holds the file name inside the pak, relative to the mount point. */
+	FString PakFilename;
+
+	/** Holds the size of the cooked file. */
+	int64 Size;
+
+	/** Holds the modification time of the cooked file. */
+	FDateTime Timestamp;
+};
+
+
+/**
+ * Structure for a pak to build.
+ */
+struct FPakBuildJob
+{
+	/** Holds the display name of the pak, usually the module name. */
+	FString Name;
+
+	/** Holds the pak file to write. */
+	FString PakFilename;
+
+	/** Holds the files to store, in pak order. */
+	TArray<FPakBuildFile> Files;
+
+	/** Holds the names of the modules that need this pak. */
+	TArray<FString> Modules;
+
+	/** Holds the graph the packages were taken from. */
+	FPakMgrDependencyGraphPtr Graph;
+};
+
+
+/**
+ * Structure for the outcome of building a single pak.
+ */
+struct FPakBuildResult
+{
+	/** Holds the display name of the pak. */
+	FString Name;
+
+	/** Holds the pak file that was written. */
+	FString PakFilename;
+
+	/** Holds the number of files stored. */
+	int32 NumFiles;
+
+	/** Holds the number of files copied from the build cache instead of being compressed. */
+	int32 NumCachedFiles;
+
+	/** Holds the total size of the stored files before compression. */
+	int64 UncompressedSize;
+
+	/** Holds the size of the pak file. */
+	int64 PakSize;
+
+	/** Holds the build time in seconds. */
+	double Seconds;
+
+	/** Holds whether the pak was written successfully. */
+	bool bSucceeded;
+
+public:
+
+	/** Default constructor. */
+	FPakBuildResult()
+		: NumFiles(0)
+		, NumCachedFiles(0)
+		, UncompressedSize(0)
+		, PakSize(0)
+		, Seconds(0.0)
+		, bSucceeded(false)
+	{ }
+};
+
+
+/**
+ * Builds paks from cooked files.
+ *
+ * Every pak goes through the same stages: the file list is gathered from the module closures,
+ * files are read with asynchronous I/O, their blocks are compressed in parallel on the task graph,
+ * and the results are written to the pak strictly in order. Only a bounded number of file bytes is
+ * read ahead of the writer (see FPakBuildSettings::MaxBytesInFlight), so memory use does not
+ * depend on the size of the pak.
+ *
+ * With the build cache enabled, files whose size and time stamp did not change are copied from the
+ * cache without reading the cooked file, and files whose content hash did not change are copied
+ * from the cache without compressing them again.
+ *
+ * BuildPaks may run on any thread. Finished paks are queued and can be dequeued from another thread.
+ */
+class FPakBuildPipeline
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * A manifest-only pipeline neither loads the build cache nor the open order log, and must not
+	 * build paks. Its jobs keep the files of each pak in closure order, which the manifest does
+	 * not depend on.
+	 *
+	 * @param InSettings The build settings.
+	 * @param bInManifestOnly Whether the pipeline is only used to create jobs and write their manifest.
+	 */
+	FPakBuildPipeline(const FPakBuildSettings& InSettings, bool bInManifestOnly = false);
+
+public:
+
+	/**
+	 * Finds the cooked files of a package.
+	 *
+	 * @param PackageName The long package name.
+	 * @param OutFiles Will hold the package's cooked files.
+	 * @return false if the package is not cooked.
+	 */
+	bool GatherPackageFiles(FName PackageName, TArray<FPakBuildFile>& OutFiles) const;
+
+	/**
+	 * Creates the pak jobs of the modules, holding the cooked files of each module's closure.
+	 *
+	 * With FPakBuildSettings::bExtractSharedPackages set, packages used by several modules go into
+	 * common paks first. Every module then gets one pak, or several numbered ones if
+	 * FPakBuildSettings::bLimitPakSize is set. With FPakBuildSettings::bUseOpenOrder set, the files
+	 * of each pak are sorted by the recorded open order.
+	 *
+	 * Paks are named after their module, so a module map named like a common or numbered pak, or
+	 * two module maps with the same name, would write the same pak twice. Such modules are rejected.
+	 *
+	 * @param Modules The modules to pak.
+	 * @param OutJobs Will hold the jobs.
+	 * @return false if two paks would get the same name, OutJobs is empty then.
+	 */
+	bool CreateModuleJobs(const TArray<FPakModuleInfo>& Modules, TArray<FPakBuildJob>& OutJobs) const;
+
+	/**
+	 * Builds a single pak.
+	 *
+	 * Files compressed for the pak are added to the build cache, which is only saved by BuildPaks.
+	 *
+	 * @param Job The pak to build.
+	 * @return The result.
+	 */
+	FPakBuildResult BuildPak(const FPakBuildJob& Job);
+
+	/**
+	 * Builds several paks one after another and queues each result.
+	 *
+	 * Once all paks are built, the build cache is saved, also if the build failed or was canceled,
+	 * and the pak manifest is written next to the paks, see SaveManifest.
+	 *
+	 * @param Jobs The paks to build.
+	 * @return true if all paks were built.
+	 * @see DequeueResult
+	 */
+	bool BuildPaks(const TArray<FPakBuildJob>& Jobs);
+
+	/** Requests running builds to stop as soon as possible. */
+	void Cancel()
+	{
+		bCancelRequested = true;
+	}
+
+	/**
+	 * Takes the next queued result.
+	 *
+	 * @param OutResult Will hold the result.
+	 * @return false if no result is queued.
+	 */
+	bool DequeueResult(FPakBuildResult& OutResult)
+	{
+		return CompletedResults.Dequeue(OutResult);
+	}
+
+	/**
+	 * Writes the binary and JSON pak manifests of a set of jobs into the output directory.
+	 *
+	 * @param Jobs The paks to list.
+	 * @return true if both manifests were written.
+	 * @see FPakManifest
+	 */
+	bool SaveManifest(const TArray<FPakBuildJob>& Jobs) const;
+
+	/** Gets the filename of the binary pak manifest. */
+	FString GetManifestFilename() const
+	{
+		return Settings.OutputDirectory / TEXT("PakManifest.bin");
+	}
+
+	/** Gets the build settings. */
+	const FPakBuildSettings& GetSettings() const
+	{
+		return Settings;
+	}
+
+private:
+
+	/** A file between reading and writing. */
+	struct FInFlightFile;
+
+	/** Creates the jobs of a set of packages, split according to the size limit. */
+	void CreateJobs(const FString& Name, const FPakMgrDependencyGraphPtr& Graph, const TArray<int32>& Nodes, const TArray<FString>& Modules, TArray<FPakBuildJob>& OutJobs) const;
+
+	/** Starts reading a file and schedules its compression. */
+	TUniquePtr<FInFlightFile> StartFile(const FPakBuildFile& File);
+
+	/** Compresses and hashes a file once it is read. Runs on the task graph. */
+	void CompressFile(FInFlightFile& File) const;
+
+	/** Reuses the cached blocks of a file if its content did not change. */
+	bool ReuseCachedBlocks(FInFlightFile& File, const FSHAHash& ContentHash) const;
+
+private:
+
+	/** Holds the build settings. */
+	FPakBuildSettings Settings;
+
+	/** Holds the incremental build cache, null if it is disabled. */
+	TUniquePtr<FPakBuildCache> Cache;
+
+	/** Holds the recorded file open order, null if files keep their closure order. */
+	TUniquePtr<FPakOpenOrder> OpenOrder;
+
+	/** Holds a flag indicating that builds should stop. */
+	FThreadSafeBool bCancelRequested;
+
+	/** Holds a flag indicating that the pipeline only writes manifests. */
+	bool bManifestOnly;
+
+	/** Holds the results of finished paks. */
+	TQueue<FPakBuildResult, EQueueMode::Spsc> CompletedResults;
+};
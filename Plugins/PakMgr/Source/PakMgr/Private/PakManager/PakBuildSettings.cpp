@@ -0,0 +1,100 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakBuildSettings.h"
+#include "Misc/ConfigCacheIni.h"
+#include "Misc/Paths.h"
+
+
+namespace PakBuildSettings
+{
+	const TCHAR* Section = TEXT("PakMgr");
+}
+
+
+/* FPakBuildSettings structors
+ *****************************************************************************/
+
+FPakBuildSettings::FPakBuildSettings()
+	: CookedDirectory(FPaths::ProjectSavedDir() / TEXT("Cooked") / TEXT("WindowsNoEditor"))
+	, OutputDirectory(FPaths::ProjectSavedDir() / TEXT("Paks"))
+	, MountPoint(TEXT("../../../"))
+	, CompressionFormat(NAME_Zlib)
+	, CompressionBlockSize(64 * 1024)
+	, MaxBytesInFlight(256 * 1024 * 1024)
+	, CacheDirectory(FPaths::ProjectSavedDir() / TEXT("PakMgr") / TEXT("BuildCache"))
+	, bUseBuildCache(true)
+	, bLimitPakSize(false)
+	, MaxPakSize((int64)1024 * 1024 * 1024)
+	, bExtractSharedPackages(true)
+	, SharingThreshold(2)
+	, bUseOpenOrder(false)
+	, OpenOrderFilename(FPaths::ProjectDir() / TEXT("Build") / TEXT("WindowsNoEditor") / TEXT("FileOpenOrder") / TEXT("GameOpenOrder.log"))
+{ }
+
+
+/* FPakBuildSettings interface
+ *****************************************************************************/
+
+void FPakBuildSettings::Load()
+{
+	using namespace PakBuildSettings;
+
+	FString CompressionFormatString;
+	int32 MaxMegabytesInFlight = (int32)(MaxBytesInFlight >> 20);
+	int32 MaxPakSizeMegabytes = (int32)(MaxPakSize >> 20);
+
+	GConfig->GetString(Section, TEXT("CookedDirectory"), CookedDirectory, GEditorPerProjectIni);
+	GConfig->GetString(Section, TEXT("OutputDirectory"), OutputDirectory, GEditorPerProjectIni);
+	GConfig->GetString(Section, TEXT("MountPoint"), MountPoint, GEditorPerProjectIni);
+	GConfig->GetInt(Section, TEXT("CompressionBlockSize"), CompressionBlockSize, GEditorPerProjectIni);
+	GConfig->GetInt(Section, TEXT("MaxMegabytesInFlight"), MaxMegabytesInFlight, GEditorPerProjectIni);
+	GConfig->GetString(Section, TEXT("CacheDirectory"), CacheDirectory, GEditorPerProjectIni);
+	GConfig->GetBool(Section, TEXT("UseBuildCache"), bUseBuildCache, GEditorPerProjectIni);
+	GConfig->GetBool(Section, TEXT("LimitPakSize"), bLimitPakSize, GEditorPerProjectIni);
+	GConfig->GetInt(Section, TEXT("MaxPakSizeMegabytes"), MaxPakSizeMegabytes, GEditorPerProjectIni);
+	GConfig->GetBool(Section, TEXT("ExtractSharedPackages"), bExtractSharedPackages, GEditorPerProjectIni);
+	GConfig->GetInt(Section, TEXT("SharingThreshold"), SharingThreshold, GEditorPerProjectIni);
+	GConfig->GetBool(Section, TEXT("UseOpenOrder"), bUseOpenOrder, GEditorPerProjectIni);
+	GConfig->GetString(Section, TEXT("OpenOrderFile"), OpenOrderFilename, GEditorPerProjectIni);
+
+	if (GConfig->GetString(Section, TEXT("CompressionFormat"), CompressionFormatString, GEditorPerProjectIni))
+	{
+		CompressionFormat = FName(*CompressionFormatString);
+	}
+
+	CompressionBlockSize = FMath::Max(CompressionBlockSize, 4 * 1024);
+	MaxBytesInFlight = (int64)FMath::Max(MaxMegabytesInFlight, 1) << 20;
+	MaxPakSize = (int64)FMath::Max(MaxPakSizeMegabytes, 1) << 20;
+	SharingThreshold = FMath::Max(SharingThreshold, 2);
+}
+
+
+void FPakBuildSettings::Save() const
+{
+	using namespace PakBuildSettings;
+
+	GConfig->SetString(Section, TEXT("CookedDirectory"), *CookedDirectory, GEditorPerProjectIni);
+	GConfig->SetString(Section, TEXT("OutputDirectory"), *OutputDirectory, GEditorPerProjectIni);
+	GConfig->SetString(Section, TEXT("MountPoint"), *MountPoint, GEditorPerProjectIni);
+	GConfig->SetString(Section, TEXT("CompressionFormat"), *CompressionFormat.ToString(), GEditorPerProjectIni);
+	GConfig->SetInt(Section, TEXT("CompressionBlockSize"), CompressionBlockSize, GEditorPerProjectIni);
+	GConfig->SetInt(Section, TEXT("MaxMegabytesInFlight"), (int32)(MaxBytesInFlight >> 20), GEditorPerProjectIni);
+	GConfig->SetString(Section, TEXT("CacheDirectory"), *CacheDirectory, GEditorPerProjectIni);
+	GConfig->SetBool(Section, TEXT("UseBuildCache"), bUseBuildCache, GEditorPerProjectIni);
+	GConfig->SetBool(Section, TEXT("LimitPakSize"), bLimitPakSize, GEditorPerProjectIni);
+	GConfig->SetInt(Section, TEXT("MaxPakSizeMegabytes"), (int32)(MaxPakSize >> 20), GEditorPerProjectIni);
+	GConfig->SetBool(Section, TEXT("ExtractSharedPackages"), bExtractSharedPackages, GEditorPerProjectIni);
+	GConfig->SetInt(Section, TEXT("SharingThreshold"), SharingThreshold, GEditorPerProjectIni);
+	GConfig->SetBool(Section, TEXT("UseOpenOrder"), bUseOpenOrder, GEditorPerProjectIni);
+	GConfig->SetString(Section, TEXT("OpenOrderFile"), *OpenOrderFilename, GEditorPerProjectIni);
+	GConfig->Flush(false, GEditorPerProjectIni);
+}
+
+
+void FPakBuildSettings::SaveLimitPakSize() const
+{
+	using namespace PakBuildSettings;
+
+	GConfig->SetBool(Section, TEXT("LimitPakSize"), bLimitPakSize, GEditorPerProjectIni);
+	GConfig->Flush(false, GEditorPerProjectIni);
+}
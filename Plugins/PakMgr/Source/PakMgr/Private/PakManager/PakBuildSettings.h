@@ -0,0 +1,71 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Settings used when building paks.
+ *
+ * The settings live in the [PakMgr] section of the per project editor ini file.
+ */
+struct FPakBuildSettings
+{
+	/** Holds the cooked output directory of the target platform, i.e. Saved/Cooked/WindowsNoEditor. */
+	FString CookedDirectory;
+
+	/** Holds the directory the paks are written to. */
+	FString OutputDirectory;
+
+	/** Holds the mount point written into every pak. */
+	FString MountPoint;
+
+	/** Holds the compression format, NAME_None stores files uncompressed. */
+	FName CompressionFormat;
+
+	/** Holds the size of a compression block in bytes. */
+	int32 CompressionBlockSize;
+
+	/** Holds the number of file bytes that may be read or compressed ahead of the pak writer. */
+	int64 MaxBytesInFlight;
+
+	/** Holds the directory of the incremental build cache. */
+	FString CacheDirectory;
+
+	/** Holds a flag indicating whether unchanged files are taken from the build cache. */
+	bool bUseBuildCache;
+
+	/** Holds a flag indicating whether modules are split into paks of at most MaxPakSize bytes. */
+	bool bLimitPakSize;
+
+	/** Holds the size limit of a pak, measured in registry disk sizes. */
+	int64 MaxPakSize;
+
+	/** Holds a flag indicating whether packages used by several modules are moved to common paks. */
+	bool bExtractSharedPackages;
+
+	/** Holds the number of modules from which on a package counts as shared. */
+	int32 SharingThreshold;
+
+	/** Holds a flag indicating whether the files of a pak are placed in the order the game opens them. */
+	bool bUseOpenOrder;
+
+	/** Holds the file open log recorded with -fileopenlog, see FPakOpenOrder. */
+	FString OpenOrderFilename;
+
+public:
+
+	/** Default constructor. */
+	FPakBuildSettings();
+
+public:
+
+	/** Loads the settings from the editor ini file, keeping the defaults for missing keys. */
+	void Load();
+
+	/** Saves the settings to the editor ini file. */
+	void Save() const;
+
+	/** Saves only bLimitPakSize to the editor ini file, leaving the other keys as they are. */
+	void SaveLimitPakSize() const;
+};
@@ -36,6 +36,7 @@ public:
 		UI_COMMAND(GenPaks, "GenPaks", "Generate pak packages", EUserInterfaceActionType::Button, FInputChord());
 		UI_COMMAND(GenMani, "GenMani", "Generate pak dependency manifest", EUserInterfaceActionType::Button, FInputChord());
 		UI_COMMAND(MaxSize, "MaxSize", "max pak size", EUserInterfaceActionType::ToggleButton, FInputChord());
+		UI_COMMAND(RecordTrace, "Trace", "Record a Chrome trace of PakMgr operations, written to Saved/Profiling/PakMgr when toggled off", EUserInterfaceActionType::ToggleButton, FInputChord());
 
 	}
 
@@ -44,6 +45,7 @@ public:
 	TSharedPtr<FUICommandInfo> GenPaks;
 	TSharedPtr<FUICommandInfo> GenMani;
 	TSharedPtr<FUICommandInfo> MaxSize;
+	TSharedPtr<FUICommandInfo> RecordTrace;
 };
 
 #undef LOCTEXT_NAMESPACE
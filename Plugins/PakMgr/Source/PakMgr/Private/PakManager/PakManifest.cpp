@@ -0,0 +1,347 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakManifest.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PakManifestFormat.h"
+#include "Serialization/JsonSerializer.h"
+#include "PakMgrTrace.h"
+
+
+namespace PakManifest
+{
+	/** Appends records to a manifest image, starting at the next 8 byte boundary. */
+	template<typename RecordType>
+	uint32 AppendSection(TArray<uint8>& Image, const RecordType* Records, int32 NumRecords)
+	{
+		Image.AddZeroed(Align(Image.Num(), 8) - Image.Num());
+
+		const uint32 Offset = Image.Num();
+		Image.Append((const uint8*)Records, NumRecords * sizeof(RecordType));
+
+		return Offset;
+	}
+
+	/** Creates an open addressing table over names. */
+	void CreateBuckets(const TArray<uint64>& Hashes, TArray<FPakManifestBucket>& OutBuckets)
+	{
+		// at most half full, so probe sequences stay short
+		const uint32 NumBuckets = FMath::RoundUpToPowerOfTwo(FMath::Max(Hashes.Num() * 2, 1));
+
+		OutBuckets.SetNumZeroed(NumBuckets);
+
+		for (FPakManifestBucket& Bucket : OutBuckets)
+		{
+			Bucket.Index = PakManifestFormat::InvalidIndex;
+		}
+
+		for (int32 Index = 0; Index < Hashes.Num(); ++Index)
+		{
+			uint32 BucketIndex = Hashes[Index] & (NumBuckets - 1);
+
+			while (OutBuckets[BucketIndex].Index != PakManifestFormat::InvalidIndex)
+			{
+				BucketIndex = (BucketIndex + 1) & (NumBuckets - 1);
+			}
+
+			OutBuckets[BucketIndex].Hash = Hashes[Index];
+			OutBuckets[BucketIndex].Index = Index;
+		}
+	}
+
+	/** Adds a null terminated UTF-8 string to the string section. */
+	uint32 AddString(TArray<ANSICHAR>& Strings, const FString& String, TArray<uint64>* OutHashes = nullptr)
+	{
+		const uint32 Offset = Strings.Num();
+		FTCHARToUTF8 Converted(*String);
+
+		Strings.Append(Converted.Get(), Converted.Length());
+		Strings.Add('\0');
+
+		if (OutHashes != nullptr)
+		{
+			OutHashes->Add(PakManifestFormat::HashName(Strings.GetData() + Offset));
+		}
+
+		return Offset;
+	}
+}
+
+
+/* FPakManifest interface
+ *****************************************************************************/
+
+void FPakManifest::Initialize(const TArray<FPakBuildJob>& Jobs)
+{
+	PAKMGR_TRACE_SCOPE(InitializeManifest);
+
+	Modules.Reset();
+	Paks.Reset();
+
+	TMap<FString, int32> ModuleIndices;
+	TMap<FName, int32> PackagePaks;
+
+	for (int32 PakIndex = 0; PakIndex < Jobs.Num(); ++PakIndex)
+	{
+		const FPakBuildJob& Job = Jobs[PakIndex];
+
+		FPak& Pak = Paks.AddDefaulted_GetRef();
+		Pak.Name = Job.Name;
+		Pak.Filename = FPaths::GetCleanFilename(Job.PakFilename);
+		Pak.Modules = Job.Modules;
+		Pak.Size = FMath::Max<int64>(IFileManager::Get().FileSize(*Job.PakFilename), 0);
+		Pak.UncompressedSize = 0;
+
+		// files of a package may be spread over the pak when it is sorted by open order
+		TMap<FName, int32> PackageIndices;
+
+		for (const FPakBuildFile& File : Job.Files)
+		{
+			const int32* PackageIndex = PackageIndices.Find(File.PackageName);
+
+			if (PackageIndex == nullptr)
+			{
+				PackageIndex = &PackageIndices.Add(File.PackageName, Pak.Packages.Add(File.PackageName));
+				Pak.PackageSizes.Add(0);
+
+				if (!PackagePaks.Contains(File.PackageName))
+				{
+					PackagePaks.Add(File.PackageName, PakIndex);
+				}
+			}
+
+			Pak.PackageSizes[*PackageIndex] += File.Size;
+			Pak.UncompressedSize += File.Size;
+		}
+
+		for (const FString& ModuleName : Job.Modules)
+		{
+			int32* ModuleIndex = ModuleIndices.Find(ModuleName);
+
+			if (ModuleIndex == nullptr)
+			{
+				FModule& Module = Modules.AddDefaulted_GetRef();
+				Module.Name = ModuleName;
+				Module.Size = 0;
+
+				ModuleIndex = &ModuleIndices.Add(ModuleName, Modules.Num() - 1);
+			}
+
+			Modules[*ModuleIndex].Paks.Add(PakIndex);
+			Modules[*ModuleIndex].Size += Pak.Size;
+		}
+	}
+
+	// hard references across paks, soft references are resolved on demand
+	for (int32 PakIndex = 0; PakIndex < Jobs.Num(); ++PakIndex)
+	{
+		const FPakMgrDependencyGraphPtr& Graph = Jobs[PakIndex].Graph;
+		FPak& Pak = Paks[PakIndex];
+
+		if (!Graph.IsValid())
+		{
+			continue;
+		}
+
+		for (FName PackageName : Pak.Packages)
+		{
+			const int32 Node = Graph->FindNode(PackageName);
+
+			if (Node == INDEX_NONE)
+			{
+				continue;
+			}
+
+			for (int32 Dependency : Graph->GetDependencies(Node, EPakMgrDependencyKind::Hard))
+			{
+				const int32* DependencyPak = PackagePaks.Find(Graph->GetPackageName(Dependency));
+
+				if ((DependencyPak != nullptr) && (*DependencyPak != PakIndex))
+				{
+					Pak.Dependencies.AddUnique(*DependencyPak);
+				}
+			}
+		}
+
+		Pak.Dependencies.Sort();
+	}
+}
+
+
+bool FPakManifest::SaveBinary(const FString& Filename) const
+{
+	PAKMGR_TRACE_SCOPE(SaveBinaryManifest);
+
+	TArray<ANSICHAR> Strings;
+	TArray<uint32> Indices;
+	TArray<uint64> ModuleHashes;
+	TArray<uint64> PackageHashes;
+
+	TArray<FPakManifestModule> ModuleRecords;
+	ModuleRecords.SetNumZeroed(Modules.Num());
+
+	for (int32 ModuleIndex = 0; ModuleIndex < Modules.Num(); ++ModuleIndex)
+	{
+		const FModule& Module = Modules[ModuleIndex];
+		FPakManifestModule& Record = ModuleRecords[ModuleIndex];
+
+		Record.Name = PakManifest::AddString(Strings, Module.Name, &ModuleHashes);
+		Record.FirstPak = Indices.Num();
+		Record.NumPaks = Module.Paks.Num();
+		Record.Size = Module.Size;
+
+		Indices.Append(Module.Paks);
+	}
+
+	// packages are grouped by the pak they are mapped to
+	TSet<FName> MappedPackages;
+	TArray<FPakManifestPackage> PackageRecords;
+	TArray<FPakManifestPak> PakRecords;
+	PakRecords.SetNumZeroed(Paks.Num());
+
+	for (int32 PakIndex = 0; PakIndex < Paks.Num(); ++PakIndex)
+	{
+		const FPak& Pak = Paks[PakIndex];
+		FPakManifestPak& Record = PakRecords[PakIndex];
+
+		Record.Name = PakManifest::AddString(Strings, Pak.Name);
+		Record.Filename = PakManifest::AddString(Strings, Pak.Filename);
+		Record.FirstPackage = PackageRecords.Num();
+		Record.FirstDependency = Indices.Num();
+		Record.NumDependencies = Pak.Dependencies.Num();
+		Record.Size = Pak.Size;
+		Record.UncompressedSize = Pak.UncompressedSize;
+
+		Indices.Append(Pak.Dependencies);
+
+		for (int32 PackageIndex = 0; PackageIndex < Pak.Packages.Num(); ++PackageIndex)
+		{
+			bool bIsAlreadyMapped = false;
+			MappedPackages.Add(Pak.Packages[PackageIndex], &bIsAlreadyMapped);
+
+			if (!bIsAlreadyMapped)
+			{
+				FPakManifestPackage& PackageRecord = PackageRecords.AddZeroed_GetRef();
+				PackageRecord.Name = PakManifest::AddString(Strings, Pak.Packages[PackageIndex].ToString(), &PackageHashes);
+				PackageRecord.Pak = PakIndex;
+				PackageRecord.Size = Pak.PackageSizes[PackageIndex];
+			}
+		}
+
+		Record.NumPackages = PackageRecords.Num() - Record.FirstPackage;
+	}
+
+	TArray<FPakManifestBucket> ModuleBuckets;
+	TArray<FPakManifestBucket> PackageBuckets;
+	PakManifest::CreateBuckets(ModuleHashes, ModuleBuckets);
+	PakManifest::CreateBuckets(PackageHashes, PackageBuckets);
+
+	// lay out the image, the header is patched in last
+	FPakManifestHeader Header;
+	FMemory::Memzero(Header);
+
+	TArray<uint8> Image;
+	Image.AddZeroed(sizeof(FPakManifestHeader));
+
+	Header.Magic = PakManifestFormat::Magic;
+	Header.Version = PakManifestFormat::Version;
+	Header.NumModules = ModuleRecords.Num();
+	Header.NumPaks = PakRecords.Num();
+	Header.NumPackages = PackageRecords.Num();
+	Header.NumModuleBuckets = ModuleBuckets.Num();
+	Header.NumPackageBuckets = PackageBuckets.Num();
+	Header.NumIndices = Indices.Num();
+	Header.ModulesOffset = PakManifest::AppendSection(Image, ModuleRecords.GetData(), ModuleRecords.Num());
+	Header.PaksOffset = PakManifest::AppendSection(Image, PakRecords.GetData(), PakRecords.Num());
+	Header.PackagesOffset = PakManifest::AppendSection(Image, PackageRecords.GetData(), PackageRecords.Num());
+	Header.ModuleBucketsOffset = PakManifest::AppendSection(Image, ModuleBuckets.GetData(), ModuleBuckets.Num());
+	Header.PackageBucketsOffset = PakManifest::AppendSection(Image, PackageBuckets.GetData(), PackageBuckets.Num());
+	Header.IndicesOffset = PakManifest::AppendSection(Image, Indices.GetData(), Indices.Num());
+
+	// keep the string section non-empty so readers can check its terminator
+	Strings.Add('\0');
+	Header.StringsOffset = PakManifest::AppendSection(Image, Strings.GetData(), Strings.Num());
+	Header.StringsSize = Strings.Num();
+
+	FMemory::Memcpy(Image.GetData(), &Header, sizeof(FPakManifestHeader));
+
+	return FFileHelper::SaveArrayToFile(Image, *Filename);
+}
+
+
+bool FPakManifest::SaveJson(const FString& Filename) const
+{
+	PAKMGR_TRACE_SCOPE(SaveJsonManifest);
+
+	TSharedPtr<FJsonObject> ManifestStream = MakeShareable(new FJsonObject);
+
+	auto MakeStringValues = [](const TArray<FString>& Strings)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+
+		for (const FString& String : Strings)
+		{
+			Values.Add(MakeShareable(new FJsonValueString(String)));
+		}
+
+		return Values;
+	};
+
+	auto MakePakValues = [this](const TArray<int32>& PakIndices)
+	{
+		TArray<TSharedPtr<FJsonValue>> Values;
+
+		for (int32 PakIndex : PakIndices)
+		{
+			Values.Add(MakeShareable(new FJsonValueString(Paks[PakIndex].Name)));
+		}
+
+		return Values;
+	};
+
+	TArray<TSharedPtr<FJsonValue>> PakValues;
+
+	for (const FPak& Pak : Paks)
+	{
+		TSharedPtr<FJsonObject> PakObject = MakeShareable(new FJsonObject);
+		TArray<TSharedPtr<FJsonValue>> PackageValues;
+
+		for (FName PackageName : Pak.Packages)
+		{
+			PackageValues.Add(MakeShareable(new FJsonValueString(PackageName.ToString())));
+		}
+
+		PakObject->SetStringField(TEXT("Name"), Pak.Name);
+		PakObject->SetStringField(TEXT("File"), Pak.Filename);
+		PakObject->SetNumberField(TEXT("Size"), Pak.Size);
+		PakObject->SetNumberField(TEXT("UncompressedSize"), Pak.UncompressedSize);
+		PakObject->SetArrayField(TEXT("Modules"), MakeStringValues(Pak.Modules));
+		PakObject->SetArrayField(TEXT("Dependencies"), MakePakValues(Pak.Dependencies));
+		PakObject->SetArrayField(TEXT("Packages"), PackageValues);
+		PakValues.Add(MakeShareable(new FJsonValueObject(PakObject)));
+	}
+
+	TArray<TSharedPtr<FJsonValue>> ModuleValues;
+
+	for (const FModule& Module : Modules)
+	{
+		TSharedPtr<FJsonObject> ModuleObject = MakeShareable(new FJsonObject);
+
+		ModuleObject->SetStringField(TEXT("Name"), Module.Name);
+		ModuleObject->SetNumberField(TEXT("Size"), Module.Size);
+		ModuleObject->SetArrayField(TEXT("Paks"), MakePakValues(Module.Paks));
+		ModuleValues.Add(MakeShareable(new FJsonValueObject(ModuleObject)));
+	}
+
+	ManifestStream->SetNumberField(TEXT("Version"), PakManifestFormat::Version);
+	ManifestStream->SetArrayField(TEXT("Modules"), ModuleValues);
+	ManifestStream->SetArrayField(TEXT("Paks"), PakValues);
+
+	FString Content;
+	TSharedRef< TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Content);
+	FJsonSerializer::Serialize(ManifestStream.ToSharedRef(), Writer);
+
+	return FFileHelper::SaveStringToFile(Content, *Filename);
+}
@@ -0,0 +1,107 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PakManager/PakBuildPipeline.h"
+
+/**
+ * In-memory pak manifest: the modules, their paks, the packages of each pak and the dependencies
+ * between paks.
+ *
+ * The manifest is written in two forms. The binary form (see PakManifestFormat.h) is what the game
+ * reads at boot, the JSON form holds the same data for people.
+ */
+class FPakManifest
+{
+public:
+
+	/** A pak of the manifest. */
+	struct FPak
+	{
+		/** Holds the display name of the pak. */
+		FString Name;
+
+		/** Holds the pak file name, relative to the manifest. */
+		FString Filename;
+
+		/** Holds the modules that need the pak. */
+		TArray<FString> Modules;
+
+		/** Holds the packages stored in the pak. */
+		TArray<FName> Packages;
+
+		/** Holds the total size of each package's cooked files. */
+		TArray<int64> PackageSizes;
+
+		/** Holds the indices of the paks this pak has hard dependencies on. */
+		TArray<int32> Dependencies;
+
+		/** Holds the size of the pak file, zero if it was not built yet. */
+		int64 Size;
+
+		/** Holds the total size of the cooked files stored in the pak. */
+		int64 UncompressedSize;
+	};
+
+	/** A module of the manifest. */
+	struct FModule
+	{
+		/** Holds the name of the module. */
+		FString Name;
+
+		/** Holds the indices of the paks the module needs. */
+		TArray<int32> Paks;
+
+		/** Holds the total size of the module's pak files. */
+		int64 Size;
+	};
+
+public:
+
+	/**
+	 * Creates the manifest of a set of pak jobs.
+	 *
+	 * Pak sizes are taken from the pak files if they exist. A package stored in several paks is
+	 * mapped to the first of them.
+	 *
+	 * @param Jobs The jobs, as created by FPakBuildPipeline::CreateModuleJobs.
+	 */
+	void Initialize(const TArray<FPakBuildJob>& Jobs);
+
+	/**
+	 * Writes the binary manifest.
+	 *
+	 * @param Filename The file to write.
+	 * @return true if the file was written.
+	 */
+	bool SaveBinary(const FString& Filename) const;
+
+	/**
+	 * Writes the JSON manifest.
+	 *
+	 * @param Filename The file to write.
+	 * @return true if the file was written.
+	 */
+	bool SaveJson(const FString& Filename) const;
+
+	/** Gets the modules. */
+	const TArray<FModule>& GetModules() const
+	{
+		return Modules;
+	}
+
+	/** Gets the paks. */
+	const TArray<FPak>& GetPaks() const
+	{
+		return Paks;
+	}
+
+private:
+
+	/** Holds the modules. */
+	TArray<FModule> Modules;
+
+	/** Holds the paks. */
+	TArray<FPak> Paks;
+};
@@ -0,0 +1,240 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakOpenOrder.h"
+#include "Misc/FileHelper.h"
+#include "PakManager/PakBuildPipeline.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakOpenOrder interface
+ *****************************************************************************/
+
+bool FPakOpenOrder::Load(const FString& Filename)
+{
+	PAKMGR_TRACE_SCOPE(LoadOpenOrder);
+
+	FileOrders.Reset();
+
+	TArray<FString> Lines;
+
+	if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+	{
+		return false;
+	}
+
+	for (int32 LineIndex = 0; LineIndex < Lines.Num(); ++LineIndex)
+	{
+		const FString Line = Lines[LineIndex].TrimStartAndEnd();
+		FString LoggedFilename;
+		FString OrderString;
+
+		if (Line.IsEmpty())
+		{
+			continue;
+		}
+
+		if (Line[0] == TEXT('"'))
+		{
+			const int32 QuoteIndex = Line.Find(TEXT("\""), ESearchCase::CaseSensitive, ESearchDir::FromStart, 1);
+
+			if (QuoteIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			LoggedFilename = Line.Mid(1, QuoteIndex - 1);
+			OrderString = Line.Mid(QuoteIndex + 1).TrimStart();
+		}
+		else if (!Line.Split(TEXT(" "), &LoggedFilename, &OrderString))
+		{
+			LoggedFilename = Line;
+		}
+
+		// logs without explicit orders are in open order already
+		const int64 Order = OrderString.IsNumeric() ? FCString::Atoi64(*OrderString) : LineIndex;
+		int64& FileOrder = FileOrders.FindOrAdd(NormalizeFilename(LoggedFilename), MAX_int64);
+
+		FileOrder = FMath::Min(FileOrder, Order);
+	}
+
+	return true;
+}
+
+
+void FPakOpenOrder::SortFiles(const FPakMgrDependencyGraph& Graph, TArray<FPakBuildFile>& Files) const
+{
+	PAKMGR_TRACE_SCOPE(SortByOpenOrder);
+
+	struct FSortKey
+	{
+		bool bIsLogged;
+		int64 Order;
+		int32 Index;
+
+		bool operator<(const FSortKey& Other) const
+		{
+			if (bIsLogged != Other.bIsLogged)
+			{
+				return bIsLogged;
+			}
+
+			return (Order != Other.Order) ? (Order < Other.Order) : (Index < Other.Index);
+		}
+	};
+
+	TArray<FSortKey> Keys;
+	Keys.SetNumUninitialized(Files.Num());
+
+	// packages missing from the log, in the order they were gathered
+	TArray<int32> Nodes;
+	TMap<FName, int32> UnloggedPackages;
+
+	for (int32 FileIndex = 0; FileIndex < Files.Num(); ++FileIndex)
+	{
+		const int64* Order = FileOrders.Find(NormalizeFilename(Files[FileIndex].PakFilename));
+
+		Keys[FileIndex].bIsLogged = (Order != nullptr);
+		Keys[FileIndex].Order = Order ? *Order : 0;
+		Keys[FileIndex].Index = FileIndex;
+
+		if ((Order == nullptr) && !UnloggedPackages.Contains(Files[FileIndex].PackageName))
+		{
+			UnloggedPackages.Add(Files[FileIndex].PackageName, Nodes.Num());
+			Nodes.Add(Graph.FindNode(Files[FileIndex].PackageName));
+		}
+	}
+
+	if (Nodes.Num() > 0)
+	{
+		// topological order along references inside the pak, referencers first
+		TMap<int32, int32> LocalIndices;
+		TArray<int32> InDegrees;
+		InDegrees.SetNumZeroed(Nodes.Num());
+
+		for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+		{
+			if (Nodes[LocalIndex] != INDEX_NONE)
+			{
+				LocalIndices.Add(Nodes[LocalIndex], LocalIndex);
+			}
+		}
+
+		auto ForEachDependency = [&](int32 LocalIndex, TFunctionRef<void(int32)> Function)
+		{
+			if (Nodes[LocalIndex] == INDEX_NONE)
+			{
+				return;
+			}
+
+			for (EPakMgrDependencyKind Kind : { EPakMgrDependencyKind::Hard, EPakMgrDependencyKind::Soft })
+			{
+				for (int32 Dependency : Graph.GetDependencies(Nodes[LocalIndex], Kind))
+				{
+					const int32* DependencyIndex = LocalIndices.Find(Dependency);
+
+					if ((DependencyIndex != nullptr) && (*DependencyIndex != LocalIndex))
+					{
+						Function(*DependencyIndex);
+					}
+				}
+			}
+		};
+
+		for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+		{
+			ForEachDependency(LocalIndex, [&](int32 DependencyIndex) { ++InDegrees[DependencyIndex]; });
+		}
+
+		// ready packages are taken in gathering order, cycles are broken the same way
+		TArray<int32> Ready;
+		TArray<int32> Ranks;
+		Ranks.Init(INDEX_NONE, Nodes.Num());
+
+		for (int32 LocalIndex = 0; LocalIndex < Nodes.Num(); ++LocalIndex)
+		{
+			if (InDegrees[LocalIndex] == 0)
+			{
+				Ready.HeapPush(LocalIndex);
+			}
+		}
+
+		int32 NextRank = 0;
+		int32 NextCycleBreak = 0;
+
+		while (NextRank < Nodes.Num())
+		{
+			int32 LocalIndex;
+
+			if (Ready.Num() > 0)
+			{
+				Ready.HeapPop(LocalIndex);
+			}
+			else
+			{
+				while (Ranks[NextCycleBreak] != INDEX_NONE)
+				{
+					++NextCycleBreak;
+				}
+
+				LocalIndex = NextCycleBreak;
+			}
+
+			if (Ranks[LocalIndex] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			Ranks[LocalIndex] = NextRank++;
+
+			ForEachDependency(LocalIndex, [&](int32 DependencyIndex)
+			{
+				if ((--InDegrees[DependencyIndex] == 0) && (Ranks[DependencyIndex] == INDEX_NONE))
+				{
+					Ready.HeapPush(DependencyIndex);
+				}
+			});
+		}
+
+		for (FSortKey& Key : Keys)
+		{
+			if (!Key.bIsLogged)
+			{
+				Key.Order = Ranks[UnloggedPackages.FindChecked(Files[Key.Index].PackageName)];
+			}
+		}
+	}
+
+	Keys.Sort();
+
+	TArray<FPakBuildFile> SortedFiles;
+	SortedFiles.Reserve(Files.Num());
+
+	for (const FSortKey& Key : Keys)
+	{
+		SortedFiles.Add(MoveTemp(Files[Key.Index]));
+	}
+
+	Files = MoveTemp(SortedFiles);
+}
+
+
+/* FPakOpenOrder implementation
+ *****************************************************************************/
+
+FString FPakOpenOrder::NormalizeFilename(const FString& Filename)
+{
+	FString Result = Filename.Replace(TEXT("\\"), TEXT("/"));
+
+	// logged names are relative to the binaries, pak names to the mount point
+	while (Result.StartsWith(TEXT("../")))
+	{
+		Result = Result.RightChop(3);
+	}
+
+	while (Result.StartsWith(TEXT("/")))
+	{
+		Result = Result.RightChop(1);
+	}
+
+	return Result;
+}
@@ -0,0 +1,54 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+
+struct FPakBuildFile;
+
+/**
+ * Orders the files of a pak by the order the game opens them.
+ *
+ * The order comes from a file open log recorded by running the game with -fileopenlog, in the
+ * format UnrealPak reads with -order: one quoted file name per line, optionally followed by its
+ * open order. Files in the log are placed first, sorted by that order. Packages that do not show up
+ * in the log follow in dependency order, referencers before the packages they reference, which is
+ * the order the loader reaches them in.
+ */
+class FPakOpenOrder
+{
+public:
+
+	/**
+	 * Loads an open order log.
+	 *
+	 * @param Filename The log to load.
+	 * @return false if the log could not be read.
+	 */
+	bool Load(const FString& Filename);
+
+	/**
+	 * Sorts the files of a pak.
+	 *
+	 * @param Graph The graph the files' packages were taken from, used for files missing from the log.
+	 * @param Files The files to sort.
+	 */
+	void SortFiles(const FPakMgrDependencyGraph& Graph, TArray<FPakBuildFile>& Files) const;
+
+	/** Gets the number of files in the log. */
+	int32 Num() const
+	{
+		return FileOrders.Num();
+	}
+
+private:
+
+	/** Converts a file name of the log or of a pak entry to the key used for lookups. */
+	static FString NormalizeFilename(const FString& Filename);
+
+private:
+
+	/** Holds the open order of each logged file, keyed by the normalized file name. */
+	TMap<FString, int64> FileOrders;
+};
@@ -0,0 +1,114 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakPartitioner.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakPartitioner interface
+ *****************************************************************************/
+
+void FPakPartitioner::Partition(const FPakMgrDependencyGraph& Graph, const TArray<int32>& Nodes, int64 MaxPartSize, TArray<TArray<int32>>& OutParts)
+{
+	PAKMGR_TRACE_SCOPE(PartitionPak);
+
+	OutParts.Reset();
+
+	// position of every packaged node
+	TMap<int32, int32> Positions;
+	Positions.Reserve(Nodes.Num());
+
+	for (int32 Position = 0; Position < Nodes.Num(); ++Position)
+	{
+		if (Graph.IsInRegistrySource(Nodes[Position]))
+		{
+			Positions.Add(Nodes[Position], Position);
+		}
+	}
+
+	// grow capped clusters along hard references in both directions
+	TArray<int32> ClusterOfPosition;
+	ClusterOfPosition.Init(INDEX_NONE, Nodes.Num());
+
+	TArray<int64> ClusterSizes;
+	TArray<int32> Queue;
+
+	for (int32 Start = 0; Start < Nodes.Num(); ++Start)
+	{
+		if ((ClusterOfPosition[Start] != INDEX_NONE) || !Positions.Contains(Nodes[Start]))
+		{
+			continue;
+		}
+
+		const int32 Cluster = ClusterSizes.Add(Graph.GetDiskSize(Nodes[Start]));
+		ClusterOfPosition[Start] = Cluster;
+
+		Queue.Reset();
+		Queue.Add(Start);
+
+		for (int32 QueueIndex = 0; QueueIndex < Queue.Num(); ++QueueIndex)
+		{
+			const int32 Node = Nodes[Queue[QueueIndex]];
+
+			auto Visit = [&](TArrayView<const int32> Neighbours)
+			{
+				for (int32 Neighbour : Neighbours)
+				{
+					const int32* Position = Positions.Find(Neighbour);
+
+					if ((Position == nullptr) || (ClusterOfPosition[*Position] != INDEX_NONE))
+					{
+						continue;
+					}
+
+					// packages that do not fit start a cluster of their own later on
+					const int64 Size = Graph.GetDiskSize(Neighbour);
+
+					if (ClusterSizes[Cluster] + Size > MaxPartSize)
+					{
+						continue;
+					}
+
+					ClusterSizes[Cluster] += Size;
+					ClusterOfPosition[*Position] = Cluster;
+					Queue.Add(*Position);
+				}
+			};
+
+			Visit(Graph.GetDependencies(Node, EPakMgrDependencyKind::Hard));
+			Visit(Graph.GetReferencers(Node, EPakMgrDependencyKind::Hard));
+		}
+	}
+
+	// pack the clusters first-fit in the order they were found
+	TArray<int32> PartOfCluster;
+	TArray<int64> PartSizes;
+	PartOfCluster.SetNumUninitialized(ClusterSizes.Num());
+
+	for (int32 Cluster = 0; Cluster < ClusterSizes.Num(); ++Cluster)
+	{
+		int32 Part = 0;
+
+		while ((Part < PartSizes.Num()) && (PartSizes[Part] + ClusterSizes[Cluster] > MaxPartSize))
+		{
+			++Part;
+		}
+
+		if (Part == PartSizes.Num())
+		{
+			PartSizes.Add(0);
+		}
+
+		PartSizes[Part] += ClusterSizes[Cluster];
+		PartOfCluster[Cluster] = Part;
+	}
+
+	OutParts.SetNum(PartSizes.Num());
+
+	for (int32 Position = 0; Position < Nodes.Num(); ++Position)
+	{
+		if (ClusterOfPosition[Position] != INDEX_NONE)
+		{
+			OutParts[PartOfCluster[ClusterOfPosition[Position]]].Add(Nodes[Position]);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/DependencyGraph.h"
+
+/**
+ * Splits a set of packages, usually a dependency closure, into parts below a size limit.
+ *
+ * Packages that hard reference each other have to be loaded together, so the set is first cut into
+ * clusters of hard-coupled packages, grown breadth-first from the first package and capped at the
+ * size limit. The clusters are then packed first-fit into parts in the order they were found, which
+ * keeps packages that are close to each other in the closure in the same part.
+ *
+ * Package sizes are the registry disk sizes held by the graph. Packages that are not part of the
+ * registry source are left out.
+ */
+struct FPakPartitioner
+{
+	/**
+	 * Partitions a set of packages.
+	 *
+	 * @param Graph The graph the nodes belong to.
+	 * @param Nodes The nodes to partition, in closure order.
+	 * @param MaxPartSize The size limit of a part in bytes. Packages larger than the limit get a part of their own.
+	 * @param OutParts Will hold the nodes of each part, in the order of Nodes.
+	 */
+	static void Partition(const FPakMgrDependencyGraph& Graph, const TArray<int32>& Nodes, int64 MaxPartSize, TArray<TArray<int32>>& OutParts);
+};
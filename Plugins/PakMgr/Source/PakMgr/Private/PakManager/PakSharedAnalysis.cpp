@@ -0,0 +1,70 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakSharedAnalysis.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakSharedAnalysis interface
+ *****************************************************************************/
+
+bool FPakSharedAnalysis::Analyze(const TArray<FPakModuleInfo>& Modules, int32 SharingThreshold, FPakSharedAnalysis& OutAnalysis)
+{
+	PAKMGR_TRACE_SCOPE(AnalyzeSharedPackages);
+
+	OutAnalysis = FPakSharedAnalysis();
+
+	if (Modules.Num() == 0)
+	{
+		return true;
+	}
+
+	const FPakMgrDependencyGraphPtr Graph = Modules[0].Graph;
+
+	for (const FPakModuleInfo& Module : Modules)
+	{
+		if (!Module.Graph.IsValid() || (Module.Graph != Graph))
+		{
+			return false;
+		}
+	}
+
+	// closures hold each node once, so this counts referencing modules
+	TArray<int32> ReferenceCounts;
+	ReferenceCounts.SetNumZeroed(Graph->Num());
+
+	for (const FPakModuleInfo& Module : Modules)
+	{
+		for (int32 Node : Module.Closure.Nodes)
+		{
+			++ReferenceCounts[Node];
+		}
+	}
+
+	TBitArray<> IsShared(false, Graph->Num());
+
+	OutAnalysis.ModuleNodes.SetNum(Modules.Num());
+	OutAnalysis.ModulesUsingSharedNodes.Init(false, Modules.Num());
+
+	for (int32 ModuleIndex = 0; ModuleIndex < Modules.Num(); ++ModuleIndex)
+	{
+		for (int32 Node : Modules[ModuleIndex].Closure.Nodes)
+		{
+			if (ReferenceCounts[Node] < SharingThreshold)
+			{
+				OutAnalysis.ModuleNodes[ModuleIndex].Add(Node);
+				continue;
+			}
+
+			OutAnalysis.ModulesUsingSharedNodes[ModuleIndex] = true;
+
+			if (!IsShared[Node])
+			{
+				IsShared[Node] = true;
+				OutAnalysis.SharedNodes.Add(Node);
+				OutAnalysis.SharedReferenceCounts.Add(ReferenceCounts[Node]);
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,42 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Models/PakModuleInfo.h"
+
+/**
+ * Splits the combined closure of several modules into shared and module-only packages.
+ *
+ * Every package is counted once per module whose closure contains it. Packages referenced by at
+ * least the sharing threshold of modules are moved to common paks, everything else stays in the
+ * pak of the module that references it.
+ */
+struct FPakSharedAnalysis
+{
+	/** Holds the shared nodes, in the order they were first reached. */
+	TArray<int32> SharedNodes;
+
+	/** Holds the number of modules referencing each element of SharedNodes. */
+	TArray<int32> SharedReferenceCounts;
+
+	/** Holds the nodes that stay with each module, in closure order. */
+	TArray<TArray<int32>> ModuleNodes;
+
+	/** Holds, for each module, whether it references any of the shared nodes. */
+	TBitArray<> ModulesUsingSharedNodes;
+
+public:
+
+	/**
+	 * Analyzes a set of modules.
+	 *
+	 * All modules must have been computed on the same graph snapshot.
+	 *
+	 * @param Modules The modules to analyze.
+	 * @param SharingThreshold The number of modules from which on a package counts as shared.
+	 * @param OutAnalysis Will hold the result.
+	 * @return false if the modules do not share a graph snapshot.
+	 */
+	static bool Analyze(const TArray<FPakModuleInfo>& Modules, int32 SharingThreshold, FPakSharedAnalysis& OutAnalysis);
+};
@@ -0,0 +1,157 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakManager/PakWriter.h"
+#include "HAL/FileManager.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryWriter.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+
+
+/* FPakWriter structors
+ *****************************************************************************/
+
+FPakWriter::FPakWriter(const FString& InFilename, const FString& InMountPoint)
+	: Filename(InFilename)
+	, TempFilename(InFilename + TEXT(".tmp"))
+	, MountPoint(InMountPoint)
+{
+	// index 0 always means uncompressed
+	if (Info.CompressionMethods.Num() == 0)
+	{
+		Info.CompressionMethods.Add(NAME_None);
+	}
+}
+
+
+FPakWriter::~FPakWriter()
+{
+	if (Archive.IsValid())
+	{
+		Archive->Close();
+		Archive.Reset();
+
+		IFileManager::Get().Delete(*TempFilename, false, true, true);
+	}
+}
+
+
+/* FPakWriter interface
+ *****************************************************************************/
+
+bool FPakWriter::Open()
+{
+	Archive.Reset(IFileManager::Get().CreateFileWriter(*TempFilename));
+
+	if (!Archive.IsValid())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to create pak file %s"), *TempFilename);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool FPakWriter::AddEntry(const FString& EntryFilename, FName CompressionFormat, uint32 CompressionBlockSize, int64 UncompressedSize, TArrayView<const TArrayView<const uint8>> Blocks, const uint8 (&Hash)[20])
+{
+	PAKMGR_TRACE_SCOPE(WritePakEntry);
+
+	check(Archive.IsValid());
+
+	FPakEntry Entry;
+	Entry.UncompressedSize = UncompressedSize;
+	Entry.Size = 0;
+	FMemory::Memcpy(Entry.Hash, Hash, sizeof(Hash));
+
+	if (CompressionFormat != NAME_None)
+	{
+		int32 MethodIndex = Info.CompressionMethods.Find(CompressionFormat);
+
+		if (MethodIndex == INDEX_NONE)
+		{
+			MethodIndex = Info.CompressionMethods.Add(CompressionFormat);
+		}
+
+		Entry.CompressionMethodIndex = MethodIndex;
+		Entry.CompressionBlockSize = CompressionBlockSize;
+		Entry.CompressionBlocks.AddDefaulted(Blocks.Num());
+	}
+
+	// block offsets are relative to the entry header, so its size has to be known first
+	const int64 HeaderSize = Entry.GetSerializedSize(FPakInfo::PakFile_Version_Latest);
+
+	for (int32 BlockIndex = 0; BlockIndex < Blocks.Num(); ++BlockIndex)
+	{
+		if (Entry.CompressionBlocks.Num() > 0)
+		{
+			Entry.CompressionBlocks[BlockIndex].CompressedStart = HeaderSize + Entry.Size;
+			Entry.CompressionBlocks[BlockIndex].CompressedEnd = HeaderSize + Entry.Size + Blocks[BlockIndex].Num();
+		}
+
+		Entry.Size += Blocks[BlockIndex].Num();
+	}
+
+	const int64 EntryOffset = Archive->Tell();
+
+	// the header in front of the data does not store its own offset
+	Entry.Offset = 0;
+	Entry.Serialize(*Archive, FPakInfo::PakFile_Version_Latest);
+
+	for (const TArrayView<const uint8>& Block : Blocks)
+	{
+		Archive->Serialize(const_cast<uint8*>(Block.GetData()), Block.Num());
+	}
+
+	if (Archive->IsError())
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to write %s to pak file %s"), *EntryFilename, *TempFilename);
+		return false;
+	}
+
+	Entry.Offset = EntryOffset;
+	Index.Emplace(EntryFilename, MoveTemp(Entry));
+
+	return true;
+}
+
+
+bool FPakWriter::Finalize()
+{
+	PAKMGR_TRACE_SCOPE(FinalizePak);
+
+	check(Archive.IsValid());
+
+	TArray<uint8> IndexData;
+	FMemoryWriter IndexWriter(IndexData);
+	int32 NumEntries = Index.Num();
+
+	IndexWriter << MountPoint;
+	IndexWriter << NumEntries;
+
+	for (TPair<FString, FPakEntry>& Entry : Index)
+	{
+		IndexWriter << Entry.Key;
+		Entry.Value.Serialize(IndexWriter, FPakInfo::PakFile_Version_Latest);
+	}
+
+	Info.IndexOffset = Archive->Tell();
+	Info.IndexSize = IndexData.Num();
+	FSHA1::HashBuffer(IndexData.GetData(), IndexData.Num(), Info.IndexHash);
+
+	Archive->Serialize(IndexData.GetData(), IndexData.Num());
+	Info.Serialize(*Archive, FPakInfo::PakFile_Version_Latest);
+
+	const bool bWritten = Archive->Close() && !Archive->IsError();
+	Archive.Reset();
+
+	if (!bWritten || !IFileManager::Get().Move(*Filename, *TempFilename, true, true))
+	{
+		UE_LOG(LogPakMgr, Error, TEXT("Failed to finalize pak file %s"), *Filename);
+		IFileManager::Get().Delete(*TempFilename, false, true, true);
+
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,90 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IPlatformFilePak.h"
+
+/**
+ * Writes a pak file front to back.
+ *
+ * Entries are appended one by one in the order they are added, and only the index is kept in
+ * memory, so the size of a pak is not limited by the available memory. The pak is written to a
+ * temporary file that replaces the target once Finalize succeeds.
+ */
+class FPakWriter
+{
+public:
+
+	/**
+	 * Creates and initializes a new instance.
+	 *
+	 * @param InFilename The pak file to write.
+	 * @param InMountPoint The mount point of the pak.
+	 */
+	FPakWriter(const FString& InFilename, const FString& InMountPoint);
+
+	/** Destructor. Discards the pak if it was not finalized. */
+	~FPakWriter();
+
+public:
+
+	/**
+	 * Opens the temporary output file.
+	 *
+	 * @return true on success.
+	 */
+	bool Open();
+
+	/**
+	 * Appends an entry.
+	 *
+	 * @param Filename The file name relative to the mount point.
+	 * @param CompressionFormat The compression format of the blocks, NAME_None if the data is stored uncompressed.
+	 * @param CompressionBlockSize The uncompressed size of a block.
+	 * @param UncompressedSize The size of the file.
+	 * @param Blocks The blocks to write, a single block holding the file if it is uncompressed.
+	 * @param Hash The SHA1 hash of the written data.
+	 * @return true on success.
+	 */
+	bool AddEntry(const FString& Filename, FName CompressionFormat, uint32 CompressionBlockSize, int64 UncompressedSize, TArrayView<const TArrayView<const uint8>> Blocks, const uint8 (&Hash)[20]);
+
+	/**
+	 * Writes the index and the pak info and moves the pak into place.
+	 *
+	 * @return true on success.
+	 */
+	bool Finalize();
+
+	/** Gets the number of entries added so far. */
+	int32 GetNumEntries() const
+	{
+		return Index.Num();
+	}
+
+	/** Gets the number of bytes written so far. */
+	int64 GetTotalSize() const
+	{
+		return Archive.IsValid() ? Archive->Tell() : 0;
+	}
+
+private:
+
+	/** Holds the pak file to write. */
+	FString Filename;
+
+	/** Holds the temporary file written until the pak is finalized. */
+	FString TempFilename;
+
+	/** Holds the mount point. */
+	FString MountPoint;
+
+	/** Holds the output archive. */
+	TUniquePtr<FArchive> Archive;
+
+	/** Holds the pak info written into the footer. */
+	FPakInfo Info;
+
+	/** Holds the index entries in the order they were written. */
+	TArray<TPair<FString, FPakEntry>> Index;
+};
@@ -1,7 +1,6 @@
 // Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
 
 #include "SPakManager.h"
-//#include "DesktopPlatformModule.h"
 #include "Misc/MessageDialog.h"
 #include "HAL/FileManager.h"
 #include "HAL/PlatformApplicationMisc.h"
@@ -14,17 +13,41 @@
 #include "PakManager/PakManagerCommands.h"
 #include "Widgets/Views/SListView.h"
 #include "PakManager/SPakManagerToolbar.h"
+#include "FileTree/SFileTreeItemTableRow.h"
+#include "Async/Async.h"
+#include "Containers/Ticker.h"
+#include "PakMgrModule.h"
+#include "PakMgrTrace.h"
+#include "PakManifestFormat.h"
 #include "Widgets/Layout/SExpandableArea.h"
 
 
 #define LOCTEXT_NAMESPACE "SFileTreePanel"
 
 
+/** Maximum number of queued messages added to the log per tick, the rest waits for the next one. */
+static const int32 MaxIngestedLogsPerTick = 65536;
+
+
 /* SFileTreePanel structors
  *****************************************************************************/
 
 SPakManager::~SPakManager()
 {
+	FTicker::GetCoreTicker().RemoveTicker(IngestTickerHandle);
+
+	if (BuildPipeline.IsValid())
+	{
+		BuildPipeline->Cancel();
+		BuildFuture.Wait();
+	}
+
+	// a recording would otherwise grow until the editor exits
+	if (FPakMgrTrace::IsRecording())
+	{
+		FPakMgrTrace::Stop(FPakMgrTrace::GetDefaultFilename());
+	}
+
 	if (SessionManager.IsValid())
 	{
 		SessionManager->OnInstanceSelectionChanged().RemoveAll(this);
@@ -42,6 +65,15 @@ void SPakManager::Construct(const FArguments& InArgs, TSharedRef<IPFileManager>
 {
 	SessionManager = InSessionManager;
 	ShouldScrollToLast = true;
+	LogStore = MakeShareable(new FPakMgrLogStore());
+	LogTableModel = MakeShareable(new FPakMgrLogTableModel(LogStore.ToSharedRef()));
+	IngestQueue = MakeShareable(new FPakMgrLogIngestQueue(TEXT("Pak Manager")));
+	LogSaver = MakeShareable(new FPakMgrLogSaver());
+
+	// Slate does not tick hidden tabs, a build would fill the queue without bound while the panel is in the background
+	IngestTickerHandle = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateSP(this, &SPakManager::HandleIngestTicker));
+
+	BuildSettings.Load();
 
 	// create and bind the commands
 	UICommandList = MakeShareable(new FUICommandList);
@@ -78,11 +110,12 @@ void SPakManager::Construct(const FArguments& InArgs, TSharedRef<IPFileManager>
 									//.BorderImage(FEditorStyle::GetBrush("ToolPanel.GroupBorder"))
 									.Padding(0.0f)
 									[
-										SAssignNew(LogListView, SListView<TSharedPtr<FFileItemInfo>>)
+										SAssignNew(LogListView, SListView<FPakMgrLogHandle>)
 											.ItemHeight(24.0f)
 											.ListItemsSource(&LogMessages)
 											.SelectionMode(ESelectionMode::Multi)
-											//.OnGenerateRow(this, &SPakManager::HandleLogListGenerateRow)
+											.OnGenerateRow(this, &SPakManager::HandleLogListGenerateRow)
+											.OnRowReleased(this, &SPakManager::HandleLogListRowReleased)
 											.OnItemScrolledIntoView(this, &SPakManager::HandleLogListItemScrolledIntoView)
 											.HeaderRow
 											(
@@ -156,12 +189,22 @@ void SPakManager::BindCommands()
 	UICommandList->MapAction(
 		Commands.MaxSize,
 		FExecuteAction::CreateSP(this, &SPakManager::HandleMaxSizeActionExecute),
-		FCanExecuteAction::CreateSP(this, &SPakManager::HandleMaxSizeActionCanExecute));
+		FCanExecuteAction::CreateSP(this, &SPakManager::HandleMaxSizeActionCanExecute),
+		FIsActionChecked::CreateSP(this, &SPakManager::HandleMaxSizeActionIsChecked));
+
+	UICommandList->MapAction(
+		Commands.RecordTrace,
+		FExecuteAction::CreateSP(this, &SPakManager::HandleRecordTraceActionExecute),
+		FCanExecuteAction::CreateSP(this, &SPakManager::HandleRecordTraceActionCanExecute),
+		FIsActionChecked::CreateSP(this, &SPakManager::HandleRecordTraceActionIsChecked));
 }
 
 
 void SPakManager::ClearLog()
 {
+	// messages queued before clearing are cleared as well
+	IngestLogs();
+
 	LogMessages.Reset();
 	LogListView->RequestListRefresh();
 }
@@ -169,7 +212,7 @@ void SPakManager::ClearLog()
 
 void SPakManager::CopyLog()
 {
-	TArray<TSharedPtr<FFileItemInfo>> SelectedItems = LogListView->GetSelectedItems();
+	TArray<FPakMgrLogHandle> SelectedItems = LogListView->GetSelectedItems();
 
 	if (SelectedItems.Num() == 0)
 	{
@@ -178,10 +221,13 @@ void SPakManager::CopyLog()
 
 	FString SelectedText;
 
-	for (const auto& Item : SelectedItems)
+	for (const FPakMgrLogHandle& Item : SelectedItems)
 	{
-		SelectedText += FString::Printf(TEXT("%s [%s] %09.3f: %s"), *Item->Time.ToString(), *Item->InstanceName, Item->TimeSeconds, *Item->Text);
-		SelectedText += LINE_TERMINATOR;
+		if (LogStore->Contains(Item))
+		{
+			SelectedText += FString::Printf(TEXT("%s [%s] %09.3f: %s"), *LogStore->GetTime(Item).ToString(), *LogStore->GetInstanceName(Item), LogStore->GetTimeSeconds(Item), LogStore->GetText(Item));
+			SelectedText += LINE_TERMINATOR;
+		}
 	}
 
 	FPlatformApplicationMisc::ClipboardCopy(*SelectedText);
@@ -193,18 +239,21 @@ void SPakManager::ReloadLog(bool FullyReload)
 	// reload log list
 	if (FullyReload)
 	{
-		AvailableLogs.Reset();
-
-		const auto& SelectedInstances = SessionManager->GetSelectedInstances();
+		TArray<TSharedPtr<FFileItemInfo>> InstanceLogs;
 
-		for (const auto& Instance : SelectedInstances)
+		for (const auto& Instance : SessionManager->GetSelectedInstances())
 		{
-			const TArray<TSharedPtr<FFileItemInfo>>& InstanceLog = Instance->GetLog();
+			InstanceLogs.Append(Instance->GetLog());
+		}
 
-			for (const auto& LogMessage : InstanceLog)
-			{
-				AvailableLogs.HeapPush(LogMessage, FFileItemInfo::TimeComparer());
-			}
+		InstanceLogs.StableSort(FFileItemInfo::TimeComparer());
+
+		// queued build messages are kept, they are added after the reloaded ones
+		LogStore->Reset();
+
+		for (const auto& LogMessage : InstanceLogs)
+		{
+			LogStore->Add(*LogMessage);
 		}
 	}
 
@@ -220,78 +269,47 @@ void SPakManager::ReloadLog(bool FullyReload)
 }
 
 
-void SPakManager::SaveLog()
+void SPakManager::AddLogMessage(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity)
 {
-	//IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
-
-	//if (DesktopPlatform == nullptr)
-	//{
-	//	FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("SaveLogDialogUnsupportedError", "Saving is not supported on this platform!"));
-
-	//	return;
-	//}
-
-	TArray<FString> Filenames;
+	IngestQueue->Enqueue(InstanceName, Text, Verbosity, NAME_None, FPlatformTime::Seconds() - GStartTime);
+}
 
-	// open file dialog
-	TSharedPtr<SWindow> ParentWindow = FSlateApplication::Get().FindWidgetWindow(AsShared());
-	void* ParentWindowHandle = (ParentWindow.IsValid() && ParentWindow->GetNativeWindow().IsValid()) ? ParentWindow->GetNativeWindow()->GetOSWindowHandle() : nullptr;
 
-	//if (!DesktopPlatform->SaveFileDialog(
-	//	ParentWindowHandle,
-	//	LOCTEXT("SaveLogDialogTitle", "Save Log As...").ToString(),
-	//	LastLogFileSaveDirectory,
-	//	TEXT("Session.log"),
-	//	TEXT("Log Files (*.log)|*.log"),
-	//	EFileDialogFlags::None,
-	//	Filenames))
-	//{
-	//	return;
-	//}
+void SPakManager::IngestLogs()
+{
+	TArray<FPakMgrLogHandle> NewLogs;
+	const uint64 NumEvicted = LogStore->GetNumEvicted();
 
-	// no log file selected?
-	if (Filenames.Num() == 0)
+	if (IngestQueue->Drain(*LogStore, NewLogs, MaxIngestedLogsPerTick) == 0)
 	{
 		return;
 	}
 
-	FString Filename = Filenames[0];
-
-	// keep path as default for next time
-	LastLogFileSaveDirectory = FPaths::GetPath(Filename);
-
-	// add a file extension if none was provided
-	if (FPaths::GetExtension(Filename).IsEmpty())
+	if (LogStore->GetNumEvicted() != NumEvicted)
 	{
-		Filename += Filename + TEXT(".log");
-	}
+		const FPakMgrLogStore& Store = *LogStore;
 
-	// save file
-	FArchive* LogFile = IFileManager::Get().CreateFileWriter(*Filename);
+		LogMessages.RemoveAll([&Store](const FPakMgrLogHandle& Message) { return !Store.Contains(Message); });
+		NewLogs.RemoveAll([&Store](const FPakMgrLogHandle& Message) { return !Store.Contains(Message); });
+	}
 
-	if (LogFile != nullptr)
-	{
-		for (const auto& LogMessage : LogMessages)
-		{
-			FString LogEntry = FString::Printf(TEXT("%s [%s] %09.3f: %s"),
-				*LogMessage->Time.ToString(),
-				*LogMessage->InstanceName,
-				LogMessage->TimeSeconds,
-				*LogMessage->Text) + LINE_TERMINATOR;
+	LogMessages.Append(NewLogs);
 
-			LogFile->Serialize(TCHAR_TO_ANSI(*LogEntry), LogEntry.Len());
-		}
+	LogListView->RequestListRefresh();
 
-		LogFile->Close();
-		delete LogFile;
-	}
-	else
+	if (ShouldScrollToLast && (LogMessages.Num() > 0))
 	{
-		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("SaveLogDialogFileError", "Failed to open the specified file for saving!"));
+		LogListView->RequestScrollIntoView(LogMessages.Last());
 	}
 }
 
 
+void SPakManager::SaveLog()
+{
+	LogSaver->SaveLog(AsShared(), *LogStore, LogMessages);
+}
+
+
 void SPakManager::SendCommand(const FString& CommandString)
 {
 	if (CommandString.IsEmpty())
@@ -338,13 +356,47 @@ FReply SPakManager::OnKeyDown(const FGeometry& MyGeometry, const FKeyEvent& InKe
 
 void SPakManager::HandleGenPaksActionExecute()
 {
+	const TArray<FPakModuleInfo>& Modules = SessionManager->GetModules();
+
+	if (Modules.Num() == 0)
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GenPaksNoModulesError", "There are no modules to pak, please run GenRef first."));
+
+		return;
+	}
+
+	BuildSettings.Load();
+	BuildPipeline = MakeShareable(new FPakBuildPipeline(BuildSettings));
+
+	TArray<FPakBuildJob> Jobs;
+	const bool bJobsCreated = BuildPipeline->CreateModuleJobs(Modules, Jobs);
+
 	ClearLog();
+
+	if (!bJobsCreated)
+	{
+		BuildPipeline.Reset();
+		AddLogMessage(TEXT("GenPaks"), TEXT("Some paks would overwrite each other, see the output log for details"), ELogVerbosity::Error);
+
+		return;
+	}
+	AddLogMessage(TEXT("GenPaks"), FString::Printf(TEXT("Building %d paks into %s"), Jobs.Num(), *BuildSettings.OutputDirectory), ELogVerbosity::Log);
+
+	// the build runs on its own thread, results are picked up by the active timer
+	TSharedPtr<FPakBuildPipeline, ESPMode::ThreadSafe> Pipeline = BuildPipeline;
+
+	BuildFuture = Async<bool>(EAsyncExecution::Thread, [Pipeline, Jobs]()
+	{
+		return Pipeline->BuildPaks(Jobs);
+	});
+
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SPakManager::HandlePakBuildActiveTimer));
 }
 
 
 bool SPakManager::HandleGenPaksActionCanExecute()
 {
-	return true;
+	return !BuildPipeline.IsValid();
 }
 
 
@@ -362,13 +414,37 @@ void SPakManager::HandleCommandSubmitted(const FString& CommandString)
 
 void SPakManager::HandleGenManiActionExecute()
 {
-	CopyLog();
+	const TArray<FPakModuleInfo>& Modules = SessionManager->GetModules();
+
+	if (Modules.Num() == 0)
+	{
+		FMessageDialog::Open(EAppMsgType::Ok, LOCTEXT("GenManiNoModulesError", "There are no modules to list, please run GenRef first."));
+
+		return;
+	}
+
+	BuildSettings.Load();
+	BuildPipeline = MakeShareable(new FPakBuildPipeline(BuildSettings, true));
+
+	ClearLog();
+
+	// gathering the jobs stats every cooked file, so it runs on a worker like the pak build
+	TSharedPtr<FPakBuildPipeline, ESPMode::ThreadSafe> Pipeline = BuildPipeline;
+
+	BuildFuture = Async<bool>(EAsyncExecution::ThreadPool, [Pipeline, Modules]()
+	{
+		TArray<FPakBuildJob> Jobs;
+
+		return Pipeline->CreateModuleJobs(Modules, Jobs) && Pipeline->SaveManifest(Jobs);
+	});
+
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SPakManager::HandleGenManiActiveTimer));
 }
 
 
 bool SPakManager::HandleGenManiActionCanExecute()
 {
-	return true;
+	return !BuildPipeline.IsValid();
 }
 
 
@@ -378,7 +454,7 @@ void SPakManager::HandleFilterChanged()
 }
 
 
-void SPakManager::HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> Item, const TSharedPtr<ITableRow>& TableRow)
+void SPakManager::HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow)
 {
 	if (LogMessages.Num() > 0)
 	{
@@ -391,13 +467,16 @@ void SPakManager::HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> It
 }
 
 
-//TSharedRef<ITableRow> SPakManager::HandleLogListGenerateRow(TSharedPtr<FFileLogMessage> Message, const TSharedRef<STableViewBase>& OwnerTable)
-//{
-//	return SNew(SFileTreeLogTableRow, OwnerTable)
-//		.HighlightText(this, &SPakManager::HandleLogListGetHighlightText)
-//		.LogMessage(Message)
-//		.ToolTipText(FText::FromString(Message->Text));
-//}
+TSharedRef<ITableRow> SPakManager::HandleLogListGenerateRow(FPakMgrLogHandle Message, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return LogTableModel->GenerateRow(Message, OwnerTable, TAttribute<FText>::Create(TAttribute<FText>::FGetter::CreateSP(this, &SPakManager::HandleLogListGetHighlightText)));
+}
+
+
+void SPakManager::HandleLogListRowReleased(const TSharedRef<ITableRow>& TableRow)
+{
+	LogTableModel->ReleaseRow(TableRow);
+}
 
 
 FText SPakManager::HandleLogListGetHighlightText() const
@@ -406,6 +485,116 @@ FText SPakManager::HandleLogListGetHighlightText() const
 }
 
 
+EActiveTimerReturnType SPakManager::HandlePakBuildActiveTimer(double InCurrentTime, float InDeltaTime)
+{
+	// check first, results queued after the check are picked up by the next tick
+	const bool bFinished = BuildFuture.IsReady();
+	FPakBuildResult Result;
+
+	while (BuildPipeline->DequeueResult(Result))
+	{
+		if (Result.bSucceeded)
+		{
+			AddLogMessage(Result.Name, FString::Printf(TEXT("%s: %d files (%d from cache), %lld bytes -> %lld bytes in %.2f seconds"), *Result.PakFilename, Result.NumFiles, Result.NumCachedFiles, Result.UncompressedSize, Result.PakSize, Result.Seconds), ELogVerbosity::Log);
+		}
+		else
+		{
+			AddLogMessage(Result.Name, FString::Printf(TEXT("%s: failed, see the output log for details"), *Result.PakFilename), ELogVerbosity::Error);
+		}
+	}
+
+	if (!bFinished)
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	AddLogMessage(TEXT("GenPaks"), BuildFuture.Get() ? TEXT("All paks were built") : TEXT("Some paks failed to build"), BuildFuture.Get() ? ELogVerbosity::Log : ELogVerbosity::Warning);
+	BuildPipeline.Reset();
+
+	return EActiveTimerReturnType::Stop;
+}
+
+
+EActiveTimerReturnType SPakManager::HandleGenManiActiveTimer(double InCurrentTime, float InDeltaTime)
+{
+	if (!BuildFuture.IsReady())
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	const FString ManifestFilename = BuildPipeline->GetManifestFilename();
+	const bool bSaved = BuildFuture.Get();
+
+	BuildPipeline.Reset();
+
+	if (!bSaved)
+	{
+		AddLogMessage(TEXT("GenMani"), FString::Printf(TEXT("Failed to write the pak manifest to %s, see the output log for details"), *BuildSettings.OutputDirectory), ELogVerbosity::Error);
+
+		return EActiveTimerReturnType::Stop;
+	}
+
+	// read the manifest back the way the game does
+	FPakManifestFile ManifestFile;
+
+	if (!ManifestFile.Open(*ManifestFilename))
+	{
+		AddLogMessage(TEXT("GenMani"), FString::Printf(TEXT("%s was written but could not be read back"), *ManifestFilename), ELogVerbosity::Error);
+
+		return EActiveTimerReturnType::Stop;
+	}
+
+	const FPakManifestView& Manifest = ManifestFile.GetView();
+
+	AddLogMessage(TEXT("GenMani"), FString::Printf(TEXT("%s: %d modules, %d paks, %d packages"), *ManifestFilename, Manifest.NumModules(), Manifest.NumPaks(), Manifest.NumPackages()), ELogVerbosity::Log);
+
+	for (int32 ModuleIndex = 0; ModuleIndex < Manifest.NumModules(); ++ModuleIndex)
+	{
+		const FPakManifestModule& Module = Manifest.GetModule(ModuleIndex);
+		FString PakNames;
+
+		for (uint32 PakIndex : Manifest.GetModulePaks(Module))
+		{
+			PakNames += (PakNames.IsEmpty() ? TEXT("") : TEXT(", ")) + FString(UTF8_TO_TCHAR(Manifest.GetString(Manifest.GetPak(PakIndex).Name)));
+		}
+
+		AddLogMessage(UTF8_TO_TCHAR(Manifest.GetString(Module.Name)), FString::Printf(TEXT("%lld bytes in %s"), Module.Size, *PakNames), ELogVerbosity::Log);
+	}
+
+	return EActiveTimerReturnType::Stop;
+}
+
+
+EActiveTimerReturnType SPakManager::HandleTraceWriteActiveTimer(double InCurrentTime, float InDeltaTime)
+{
+	if (!TraceFuture.IsReady())
+	{
+		return EActiveTimerReturnType::Continue;
+	}
+
+	if (TraceFuture.Get())
+	{
+		AddLogMessage(TEXT("Trace"), FString::Printf(TEXT("Wrote %s, memory high-water mark %lld MB"), *TraceFilename, FPakMgrTrace::GetMemoryHighWaterMark() >> 20), ELogVerbosity::Log);
+	}
+	else
+	{
+		AddLogMessage(TEXT("Trace"), FString::Printf(TEXT("Failed to write %s"), *TraceFilename), ELogVerbosity::Error);
+	}
+
+	TraceFuture = TFuture<bool>();
+
+	return EActiveTimerReturnType::Stop;
+}
+
+
+bool SPakManager::HandleIngestTicker(float DeltaTime)
+{
+	IngestLogs();
+
+	return true;
+}
+
+
 bool SPakManager::HandleMainContentIsEnabled() const
 {
 	//return (SessionManager->GetSelectedInstances().Num() > 0);
@@ -415,13 +604,55 @@ bool SPakManager::HandleMainContentIsEnabled() const
 
 void SPakManager::HandleMaxSizeActionExecute()
 {
-	SaveLog();
+	BuildSettings.Load();
+	BuildSettings.bLimitPakSize = !BuildSettings.bLimitPakSize;
+	BuildSettings.SaveLimitPakSize();
+
+	AddLogMessage(TEXT("MaxSize"), BuildSettings.bLimitPakSize
+		? FString::Printf(TEXT("Modules are split into paks of at most %lld MB"), BuildSettings.MaxPakSize >> 20)
+		: FString(TEXT("Every module is built into a single pak")), ELogVerbosity::Log);
 }
 
 
 bool SPakManager::HandleMaxSizeActionCanExecute()
 {
-	return true;
+	return !BuildPipeline.IsValid();
+}
+
+
+bool SPakManager::HandleMaxSizeActionIsChecked() const
+{
+	return BuildSettings.bLimitPakSize;
+}
+
+
+void SPakManager::HandleRecordTraceActionExecute()
+{
+	if (!FPakMgrTrace::IsRecording())
+	{
+		FPakMgrTrace::Start();
+		AddLogMessage(TEXT("Trace"), TEXT("Recording a trace, toggle Trace again to write it"), ELogVerbosity::Log);
+
+		return;
+	}
+
+	TraceFilename = FPaths::ConvertRelativePathToFull(FPakMgrTrace::GetDefaultFilename());
+	TraceFuture = FPakMgrTrace::Stop(TraceFilename);
+
+	AddLogMessage(TEXT("Trace"), FString::Printf(TEXT("Writing %s"), *TraceFilename), ELogVerbosity::Log);
+	RegisterActiveTimer(0.1f, FWidgetActiveTimerDelegate::CreateSP(this, &SPakManager::HandleTraceWriteActiveTimer));
+}
+
+
+bool SPakManager::HandleRecordTraceActionCanExecute() const
+{
+	return !FPakMgrTrace::IsWriting();
+}
+
+
+bool SPakManager::HandleRecordTraceActionIsChecked() const
+{
+	return FPakMgrTrace::IsRecording();
 }
 
 
@@ -444,15 +675,7 @@ void SPakManager::HandleSessionManagerInstanceSelectionChanged(const TSharedPtr<
 
 void SPakManager::HandleSessionManagerLogReceived(const TSharedRef<IFileInfo>& Session, const TSharedRef<IFileInstanceInfo>& Instance, const TSharedRef<FFileItemInfo>& Message)
 {
-	AvailableLogs.Add(Message);
-	LogMessages.Add(Message);
-
-	LogListView->RequestListRefresh();
-
-	if (ShouldScrollToLast)
-	{
-		LogListView->RequestScrollIntoView(Message);
-	}
+	IngestQueue->Enqueue(*Message);
 }
 
 
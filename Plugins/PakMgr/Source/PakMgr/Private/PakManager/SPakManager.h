@@ -13,7 +13,14 @@
 #include "Models/IFileInfo.h"
 #include "Models/FileItemInfo.h"
 #include "Models/IPFileManager.h"
+#include "Models/LogStore.h"
+#include "Models/LogTableModel.h"
+#include "Models/LogIngestQueue.h"
+#include "Models/LogSaver.h"
 #include "Framework/Commands/UICommandList.h"
+#include "Async/Future.h"
+#include "PakManager/PakBuildPipeline.h"
+
 
 /**
  * Implements the File Tree panel.
@@ -72,7 +79,23 @@ protected:
 	void ReloadLog(bool FullyReload);
 
 	/**
-	 * Saves all log messages to a file.
+	 * Appends a message to the log list by the next tick, may be called from any thread.
+	 *
+	 * @param InstanceName The name shown in the instance column, i.e. the pak name.
+	 * @param Text The message text.
+	 * @param Verbosity The verbosity of the message.
+	 */
+	void AddLogMessage(const FString& InstanceName, const FString& Text, ELogVerbosity::Type Verbosity);
+
+	/**
+	 * Moves queued messages into the log store and lists them.
+	 *
+	 * Called once per frame, so a burst of messages only refreshes the list once.
+	 */
+	void IngestLogs();
+
+	/**
+	 * Saves the listed log messages to a file, on a worker thread.
 	 *
 	 * @see ClearLog, CopyLog, ReloadLog
 	 */
@@ -111,6 +134,18 @@ private:
 	/** Callback for determining the 'Save' action can execute. */
 	bool HandleMaxSizeActionCanExecute();
 
+	/** Callback for determining the checked state of the 'MaxSize' toggle. */
+	bool HandleMaxSizeActionIsChecked() const;
+
+	/** Callback for executing the 'RecordTrace' action. */
+	void HandleRecordTraceActionExecute();
+
+	/** Callback for determining the 'RecordTrace' action can execute, not while the last trace is written. */
+	bool HandleRecordTraceActionCanExecute() const;
+
+	/** Callback for determining the checked state of the 'RecordTrace' toggle. */
+	bool HandleRecordTraceActionIsChecked() const;
+
 	/** Callback for promoting console command to shortcuts. */
 	void HandleCommandBarPromoteToShortcutClicked(const FString& CommandString);
 
@@ -121,16 +156,31 @@ private:
 	void HandleFilterChanged();
 
 	/** Callback for scrolling a log item into view. */
-	void HandleLogListItemScrolledIntoView(TSharedPtr<FFileItemInfo> Item, const TSharedPtr<ITableRow>& TableRow);
+	void HandleLogListItemScrolledIntoView(FPakMgrLogHandle Item, const TSharedPtr<ITableRow>& TableRow);
 
 	/** Callback for generating a row widget for the log list view. */
-	//TSharedRef<ITableRow> HandleLogListGenerateRow(TSharedPtr<FFileLogMessage> Message, const TSharedRef<STableViewBase>& OwnerTable);
+	TSharedRef<ITableRow> HandleLogListGenerateRow(FPakMgrLogHandle Message, const TSharedRef<STableViewBase>& OwnerTable);
+
+	/** Callback for a row widget scrolling out of the log list view. */
+	void HandleLogListRowReleased(const TSharedRef<ITableRow>& TableRow);
 
 	/** Callback for getting the highlight string for log messages. */
 	FText HandleLogListGetHighlightText() const;
 
 	/** Callback for selecting log messages. */
-	void HandleLogListSelectionChanged(TSharedPtr<FFileItemInfo> InItem, ESelectInfo::Type SelectInfo);
+	void HandleLogListSelectionChanged(FPakMgrLogHandle InItem, ESelectInfo::Type SelectInfo);
+
+	/** Callback for polling the running pak build. */
+	EActiveTimerReturnType HandlePakBuildActiveTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Callback for reporting the manifest written by GenMani. */
+	EActiveTimerReturnType HandleGenManiActiveTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Callback for reporting the result of writing a trace. */
+	EActiveTimerReturnType HandleTraceWriteActiveTimer(double InCurrentTime, float InDeltaTime);
+
+	/** Callback for draining the ingestion queue, also while the panel is hidden. */
+	bool HandleIngestTicker(float DeltaTime);
 
 	/** Callback for getting the enabled state of the console box. */
 	bool HandleMainContentIsEnabled() const;
@@ -149,8 +199,23 @@ private:
 
 private:
 
-	/** Holds an unfiltered list of available log messages. */
-	TArray<TSharedPtr<FFileItemInfo>> AvailableLogs;
+	/** Holds all available log messages. */
+	TSharedPtr<FPakMgrLogStore> LogStore;
+
+	/** Holds messages that were not added to the log store yet. */
+	TSharedPtr<FPakMgrLogIngestQueue, ESPMode::ThreadSafe> IngestQueue;
+
+	/** Holds the handle of the ticker draining IngestQueue. */
+	FDelegateHandle IngestTickerHandle;
+
+	/** Holds the pak build settings. */
+	FPakBuildSettings BuildSettings;
+
+	/** Holds the pak build pipeline while paks are being built. */
+	TSharedPtr<FPakBuildPipeline, ESPMode::ThreadSafe> BuildPipeline;
+
+	/** Holds the result of the running pak build. */
+	TFuture<bool> BuildFuture;
 
 	/** Holds the find bar. */
 	TSharedPtr<SSearchBox> FindBar;
@@ -158,14 +223,23 @@ private:
 	/** Holds the highlight text. */
 	FString HighlightText;
 
-	/** Holds the directory where the log file was last saved to. */
-	FString LastLogFileSaveDirectory;
+	/** Holds the helper saving the log to a file. */
+	TSharedPtr<FPakMgrLogSaver> LogSaver;
+
+	/** Holds the trace file being written, if any. */
+	FString TraceFilename;
+
+	/** Holds the result of writing the trace file. */
+	TFuture<bool> TraceFuture;
 
 	/** Holds the log list view. */
- 	TSharedPtr<SListView<TSharedPtr<FFileItemInfo>>> LogListView;
+ 	TSharedPtr<SListView<FPakMgrLogHandle>> LogListView;
+
+	/** Holds the table model of the log list view. */
+	TSharedPtr<FPakMgrLogTableModel> LogTableModel;
 
  	/** Holds the filtered list of log messages. */
- 	TArray<TSharedPtr<FFileItemInfo>> LogMessages;
+ 	TArray<FPakMgrLogHandle> LogMessages;
 
 	/** Holds the session manager. */
 	TSharedPtr<IPFileManager> SessionManager;
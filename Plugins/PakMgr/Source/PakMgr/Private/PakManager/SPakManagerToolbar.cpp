@@ -24,6 +24,8 @@ void SPakManagerToolbar::Construct(const FArguments& InArgs, const TSharedRef<FU
 		Toolbar.AddSeparator();
 		Toolbar.AddToolBarButton(FPakManagerCommands::Get().GenMani);
 		Toolbar.AddToolBarButton(FPakManagerCommands::Get().MaxSize);
+		Toolbar.AddSeparator();
+		Toolbar.AddToolBarButton(FPakManagerCommands::Get().RecordTrace);
 	}
 
 	ChildSlot
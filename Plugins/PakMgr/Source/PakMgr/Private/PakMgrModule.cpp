@@ -6,11 +6,19 @@
 #include "Algo/Count.h"
 #include "LevelEditor.h"
 #include "PFileManager.h"
+#include "Models/PackageRoots.h"
+#include "Models/DependencyGraphCache.h"
+#include "Models/CookedRegistryReader.h"
+#include "Misc/PackageName.h"
+#include "Async/Async.h"
 #include "IMessagingModule.h"
 #include "Widgets/Docking/SDockTab.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
+#include "UObject/ObjectRedirector.h"
+#include "UObject/Package.h"
+#include "PakMgrTrace.h"
 
 static const FName PakMgrTabName("PakMgrModule");
 
@@ -25,40 +33,55 @@ void IPakMgrModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	
-	FPakMgrStyle::Initialize();
-	FPakMgrStyle::ReloadTextures();
+	// the commandlet runs headless, there is no level editor to extend
+	if (!IsRunningCommandlet())
+	{
+		FPakMgrStyle::Initialize();
+		FPakMgrStyle::ReloadTextures();
 
-	FPakMgrCommands::Register();
+		FPakMgrCommands::Register();
 	
-	PluginCommands = MakeShareable(new FUICommandList);
+		PluginCommands = MakeShareable(new FUICommandList);
 
-	PluginCommands->MapAction(
-		FPakMgrCommands::Get().OpenPluginWindow,
-		FExecuteAction::CreateRaw(this, &IPakMgrModule::PluginButtonClicked),
-		FCanExecuteAction());
+		PluginCommands->MapAction(
+			FPakMgrCommands::Get().OpenPluginWindow,
+			FExecuteAction::CreateRaw(this, &IPakMgrModule::PluginButtonClicked),
+			FCanExecuteAction());
 		
-	FLevelEditorModule& LevelEditorModule = FModuleManager::LoadModuleChecked<FLevelEditorModule>("LevelEditor");
+		FLevelEditorModule& LevelEditorModule = FModuleManager::LoadModuleChecked<FLevelEditorModule>("LevelEditor");
 	
-	{
-		TSharedPtr<FExtender> MenuExtender = MakeShareable(new FExtender());
-		MenuExtender->AddMenuExtension("WindowLayout", EExtensionHook::After, PluginCommands, FMenuExtensionDelegate::CreateRaw(this, &IPakMgrModule::AddMenuExtension));
+		{
+			TSharedPtr<FExtender> MenuExtender = MakeShareable(new FExtender());
+			MenuExtender->AddMenuExtension("WindowLayout", EExtensionHook::After, PluginCommands, FMenuExtensionDelegate::CreateRaw(this, &IPakMgrModule::AddMenuExtension));
 
-		LevelEditorModule.GetMenuExtensibilityManager()->AddExtender(MenuExtender);
-	}
+			LevelEditorModule.GetMenuExtensibilityManager()->AddExtender(MenuExtender);
+		}
 	
-	{
-		TSharedPtr<FExtender> ToolbarExtender = MakeShareable(new FExtender);
-		ToolbarExtender->AddToolBarExtension("Settings", EExtensionHook::After, PluginCommands, FToolBarExtensionDelegate::CreateRaw(this, &IPakMgrModule::AddToolbarExtension));
+		{
+			TSharedPtr<FExtender> ToolbarExtender = MakeShareable(new FExtender);
+			ToolbarExtender->AddToolBarExtension("Settings", EExtensionHook::After, PluginCommands, FToolBarExtensionDelegate::CreateRaw(this, &IPakMgrModule::AddToolbarExtension));
 		
-		LevelEditorModule.GetToolBarExtensibilityManager()->AddExtender(ToolbarExtender);
-	}
+			LevelEditorModule.GetToolBarExtensibilityManager()->AddExtender(ToolbarExtender);
+		}
 	
-	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(PakMgrTabName, FOnSpawnTab::CreateRaw(this, &IPakMgrModule::OnSpawnPluginTab))
-		.SetDisplayName(LOCTEXT("FPakMgrTabTitle", "PakMgr"))
-		.SetMenuType(ETabSpawnerMenuType::Hidden);
+		FGlobalTabmanager::Get()->RegisterNomadTabSpawner(PakMgrTabName, FOnSpawnTab::CreateRaw(this, &IPakMgrModule::OnSpawnPluginTab))
+			.SetDisplayName(LOCTEXT("FPakMgrTabTitle", "PakMgr"))
+			.SetMenuType(ETabSpawnerMenuType::Hidden);
+	}
 
 	MessageBusPtr = IMessagingModule::Get().GetDefaultBus();
 
+	CurrentRegistrySource = nullptr;
+	bRedirectorPackagesValid = false;
+	bEditorGraphCacheLoaded = false;
+	AssetRegistry = &FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+	AssetRegistry->OnAssetAdded().AddRaw(this, &IPakMgrModule::HandleAssetAdded);
+	AssetRegistry->OnAssetRemoved().AddRaw(this, &IPakMgrModule::HandleAssetRemoved);
+	AssetRegistry->OnAssetRenamed().AddRaw(this, &IPakMgrModule::HandleAssetRenamed);
+	AssetRegistry->OnFilesLoaded().AddRaw(this, &IPakMgrModule::HandleFilesLoaded);
+	UPackage::PackageSavedEvent.AddRaw(this, &IPakMgrModule::HandlePackageSaved);
+	FPakMgrPackageRoots::Get().Initialize();
+
 	GameContentPath = FString() / FApp::GetProjectName() / TEXT("Content");
 }
 
@@ -66,11 +89,35 @@ void IPakMgrModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
-	FPakMgrStyle::Shutdown();
+	if (!IsRunningCommandlet())
+	{
+		FPakMgrStyle::Shutdown();
+
+		FPakMgrCommands::Unregister();
+
+		FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(PakMgrTabName);
+	}
 
-	FPakMgrCommands::Unregister();
+	if (FModuleManager::Get().IsModuleLoaded("AssetRegistry"))
+	{
+		AssetRegistry->OnAssetAdded().RemoveAll(this);
+		AssetRegistry->OnAssetRemoved().RemoveAll(this);
+		AssetRegistry->OnAssetRenamed().RemoveAll(this);
+		AssetRegistry->OnFilesLoaded().RemoveAll(this);
+	}
+
+	UPackage::PackageSavedEvent.RemoveAll(this);
+	FPakMgrPackageRoots::Get().Shutdown();
+
+	WaitForEditorDependencyGraphTask();
 
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(PakMgrTabName);
+	if (PathSearchIndexTask.IsValid())
+	{
+		PathSearchIndexTask.Wait();
+	}
+
+	ResetRegistrySource();
+	PreviousEditorGraph.Reset();
 }
 
 TSharedRef<SDockTab> IPakMgrModule::OnSpawnPluginTab(const FSpawnTabArgs& SpawnTabArgs)
@@ -105,58 +152,463 @@ TSharedRef<SDockTab> IPakMgrModule::OnSpawnPluginTab(const FSpawnTabArgs& SpawnT
 	return DockTab;
 }
 
+bool IPakMgrModule::NeedsRegistrySourceFiltering() const
+{
+	return CurrentRegistrySource && !CurrentRegistrySource->bIsEditor && (CurrentRegistrySource->RegistryState || CurrentRegistrySource->DependencyGraph.IsValid());
+}
+
 bool IPakMgrModule::FilterAssetIdentifiersForCurrentRegistrySource(TArray<FAssetIdentifier>& AssetIdentifiers, EAssetRegistryDependencyType::Type DependencyType, bool bForwardDependency)
 {
-	bool bMadeChange = false;
-	if (!CurrentRegistrySource || !CurrentRegistrySource->RegistryState || CurrentRegistrySource->bIsEditor)
+	// called once per edge query, a trace event per call would swamp a recording
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_PakMgr_FilterAssetIdentifiers);
+
+	if (!NeedsRegistrySourceFiltering())
 	{
-		return bMadeChange;
+		return false;
 	}
 
+	// compact in place, targets of removed redirectors are appended once the scan is done
+	TArray<FAssetIdentifier> RedirectedIdentifiers;
+	int32 NumKept = 0;
+
 	for (int32 Index = 0; Index < AssetIdentifiers.Num(); Index++)
 	{
-		FName PackageName = AssetIdentifiers[Index].PackageName;
+		const FName PackageName = AssetIdentifiers[Index].PackageName;
+
+		if (PackageName == NAME_None || IsPackageInCurrentRegistrySource(PackageName))
+		{
+			if (NumKept != Index)
+			{
+				AssetIdentifiers[NumKept] = MoveTemp(AssetIdentifiers[Index]);
+			}
+
+			++NumKept;
+		}
+		else if (DependencyType != EAssetRegistryDependencyType::None)
+		{
+			// If this is a redirector replace with references
+			RedirectedIdentifiers.Append(FindOrResolveRedirectorTargets(PackageName, DependencyType, bForwardDependency));
+		}
+	}
+
+	const bool bMadeChange = (NumKept != AssetIdentifiers.Num());
 
-		if (PackageName != NAME_None)
+	AssetIdentifiers.SetNum(NumKept, false);
+	AssetIdentifiers.Append(MoveTemp(RedirectedIdentifiers));
+
+	return bMadeChange;
+}
+
+FPakMgrDependencyGraphPtr IPakMgrModule::GetDependencyGraph()
+{
+	PAKMGR_TRACE_SCOPE(GetDependencyGraph);
+
+	if (!DependencyGraph.IsValid())
+	{
+		if (CurrentRegistrySource && CurrentRegistrySource->RegistryState && !CurrentRegistrySource->bIsEditor)
 		{
-			if (!IsPackageInCurrentRegistrySource(PackageName))
+			DependencyGraph = FPakMgrDependencyGraph::CreateFromRegistryState(*CurrentRegistrySource->RegistryState, false);
+		}
+		else if (CurrentRegistrySource && CurrentRegistrySource->DependencyGraph.IsValid() && !CurrentRegistrySource->bIsEditor)
+		{
+			// streamed sources already are a snapshot
+			return DependencyGraph = CurrentRegistrySource->DependencyGraph;
+		}
+		else
+		{
+			if (!bEditorGraphCacheLoaded)
 			{
-				// Remove bad package
-				AssetIdentifiers.RemoveAt(Index);
+				bEditorGraphCacheLoaded = true;
 
-				if (DependencyType != EAssetRegistryDependencyType::None)
+				if (!PreviousEditorGraph.IsValid())
 				{
-					// If this is a redirector replace with references
-					TArray<FAssetData> Assets;
-					AssetRegistry->GetAssetsByPackageName(PackageName, Assets, true);
-
-					for (const FAssetData& Asset : Assets)
-					{
-						if (Asset.IsRedirector())
-						{
-							TArray<FAssetIdentifier> FoundReferences;
-
-							if (bForwardDependency)
-							{
-								CurrentRegistrySource->RegistryState->GetDependencies(PackageName, FoundReferences, DependencyType);
-							}
-							else
-							{
-								CurrentRegistrySource->RegistryState->GetReferencers(PackageName, FoundReferences, DependencyType);
-							}
-
-							AssetIdentifiers.Insert(FoundReferences, Index);
-							break;
-						}
-					}
+					PreviousEditorGraph = FPakMgrDependencyGraphCache::Load(FPakMgrDependencyGraphCache::GetEditorCacheFilename());
 				}
+			}
+
+			if (PreviousEditorGraph.IsValid() && AssetRegistry->IsLoadingAssets())
+			{
+				// a partial scan is worse than the last session's graph, which is refreshed once the scan completes
+				DependencyGraph = PreviousEditorGraph;
+
+				UE_LOG(LogPakMgr, Log, TEXT("Using cached dependency graph snapshot with %d packages and %d edges until the asset registry finished scanning"), DependencyGraph->Num(), DependencyGraph->NumEdges());
+
+				return DependencyGraph;
+			}
+
+			WaitForEditorDependencyGraphTask();
+
+			FAssetRegistryState EditorState;
+			CopyEditorRegistryState(EditorState);
+
+			DependencyGraph = FPakMgrDependencyGraph::CreateFromRegistryState(EditorState, true, PreviousEditorGraph.Get());
+			PreviousEditorGraph = DependencyGraph;
+
+			// a graph built from a partial scan is replaced by HandleFilesLoaded anyway
+			if (!AssetRegistry->IsLoadingAssets())
+			{
+				SaveEditorDependencyGraphAsync(DependencyGraph);
+			}
+		}
+
+		UE_LOG(LogPakMgr, Log, TEXT("Built dependency graph snapshot with %d packages and %d edges"), DependencyGraph->Num(), DependencyGraph->NumEdges());
+
+		PAKMGR_TRACE_COUNTER(DependencyGraphPackages, DependencyGraph->Num());
+		PAKMGR_TRACE_COUNTER(DependencyGraphEdges, DependencyGraph->NumEdges());
+	}
+
+	return DependencyGraph;
+}
+
+void IPakMgrModule::CopyEditorRegistryState(FAssetRegistryState& OutState) const
+{
+	PAKMGR_TRACE_SCOPE(CopyEditorRegistryState);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	// the editor registry does not expose its state, so take a copy of what the snapshot reads:
+	// dependencies, package data and asset data without tags, which keeps the asset classes that
+	// redirectors are told by but drops the tag maps, the bulk of the asset data
+	FAssetRegistrySerializationOptions Options;
+	Options.bSerializeAssetRegistry = true;
+	Options.bSerializeDependencies = true;
+	Options.bSerializePackageData = true;
+	Options.bUseAssetRegistryTagsWhitelistInsteadOfBlacklist = true;
+	Options.bFilterAssetDataWithNoTags = false;
+	Options.CookFilterlistTagsByClass.Reset();
+	AssetRegistry->InitializeTemporaryAssetRegistryState(OutState, Options);
+
+	UE_LOG(LogPakMgr, Log, TEXT("Copied the dependency data of %d packages from the editor registry in %.2f seconds"), OutState.GetAssetPackageDataMap().Num(), FPlatformTime::Seconds() - StartTime);
+}
+
+void IPakMgrModule::RefreshEditorDependencyGraphAsync()
+{
+	WaitForEditorDependencyGraphTask();
+
+	// the registry may only be read here, everything else happens on the worker
+	TSharedRef<FAssetRegistryState, ESPMode::ThreadSafe> EditorState = MakeShared<FAssetRegistryState, ESPMode::ThreadSafe>();
+	CopyEditorRegistryState(*EditorState);
+
+	const FPakMgrDependencyGraphPtr CurrentGraph = DependencyGraph;
+	const FPakMgrDependencyGraphPtr BaseGraph = PreviousEditorGraph;
+	const FString CacheFilename = FPakMgrDependencyGraphCache::GetEditorCacheFilename();
+
+	EditorGraphTask = Async<void>(EAsyncExecution::ThreadPool, [EditorState, CurrentGraph, BaseGraph, CacheFilename]()
+	{
+		PAKMGR_TRACE_SCOPE(RefreshDependencyGraph);
+
+		const double StartTime = FPlatformTime::Seconds();
+		FPakMgrDependencyGraphPtr NewGraph = FPakMgrDependencyGraph::CreateFromRegistryState(*EditorState, true, BaseGraph.Get());
+
+		UE_LOG(LogPakMgr, Log, TEXT("Refreshed dependency graph snapshot with %d packages and %d edges in %.2f seconds"), NewGraph->Num(), NewGraph->NumEdges(), FPlatformTime::Seconds() - StartTime);
+
+		if (!FPakMgrDependencyGraphCache::Save(*NewGraph, CacheFilename))
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("Failed to write the dependency graph cache %s"), *CacheFilename);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [NewGraph, CurrentGraph]()
+		{
+			IPakMgrModule* Module = FModuleManager::GetModulePtr<IPakMgrModule>("PakMgr");
 
-				// Need to redo this index, it was either removed or replaced
-				Index--;
+			if (Module == nullptr)
+			{
+				return;
 			}
+
+			Module->PreviousEditorGraph = NewGraph;
+
+			// keep a graph that was rebuilt or dropped in the meantime, it knows about later changes
+			if (Module->DependencyGraph.IsValid() && (Module->DependencyGraph == CurrentGraph))
+			{
+				// redirectors resolved on the old graph may have changed as well
+				Module->InvalidateDependencyGraph();
+				Module->DependencyGraph = NewGraph;
+			}
+		});
+	});
+}
+
+void IPakMgrModule::SaveEditorDependencyGraphAsync(const FPakMgrDependencyGraphPtr& Graph)
+{
+	WaitForEditorDependencyGraphTask();
+
+	const FString CacheFilename = FPakMgrDependencyGraphCache::GetEditorCacheFilename();
+
+	EditorGraphTask = Async<void>(EAsyncExecution::ThreadPool, [Graph, CacheFilename]()
+	{
+		if (!FPakMgrDependencyGraphCache::Save(*Graph, CacheFilename))
+		{
+			UE_LOG(LogPakMgr, Warning, TEXT("Failed to write the dependency graph cache %s"), *CacheFilename);
 		}
+	});
+}
+
+void IPakMgrModule::WaitForEditorDependencyGraphTask()
+{
+	if (EditorGraphTask.IsValid())
+	{
+		EditorGraphTask.Wait();
+		EditorGraphTask = TFuture<void>();
+	}
+}
+
+void IPakMgrModule::InvalidateDependencyGraph()
+{
+	DependencyGraph.Reset();
+	RedirectorPackages.Reset();
+	RedirectorTargets.Reset();
+	bRedirectorPackagesValid = false;
+}
+
+bool IPakMgrModule::LoadCookedRegistrySource(const FString& Filename)
+{
+	FPakMgrDependencyGraphPtr Graph = FPakMgrCookedRegistryReader::Load(Filename);
+
+	if (!Graph.IsValid())
+	{
+		return false;
+	}
+
+	FPakMgrRegistrySource* NewSource = new FPakMgrRegistrySource();
+	NewSource->SourceName = FPakMgrRegistrySource::CustomSourceName;
+	NewSource->SourceFilename = Filename;
+	NewSource->DependencyGraph = Graph;
+
+	delete CurrentRegistrySource;
+	CurrentRegistrySource = NewSource;
+	InvalidateDependencyGraph();
+
+	return true;
+}
+
+void IPakMgrModule::SetCustomRegistrySource(FAssetRegistryState* State, const FString& SourceFilename)
+{
+	check(State != nullptr);
+
+	FPakMgrRegistrySource* NewSource = new FPakMgrRegistrySource();
+	NewSource->SourceName = FPakMgrRegistrySource::CustomSourceName;
+	NewSource->SourceFilename = SourceFilename;
+	NewSource->RegistryState = State;
+
+	delete CurrentRegistrySource;
+	CurrentRegistrySource = NewSource;
+	InvalidateDependencyGraph();
+}
+
+void IPakMgrModule::ResetRegistrySource()
+{
+	delete CurrentRegistrySource;
+	CurrentRegistrySource = nullptr;
+	InvalidateDependencyGraph();
+}
+
+TSharedRef<FPakMgrPathSearchIndex, ESPMode::ThreadSafe> IPakMgrModule::GetPathSearchIndex()
+{
+	if (!PathSearchIndex.IsValid())
+	{
+		PathSearchIndex = MakeShared<FPakMgrPathSearchIndex, ESPMode::ThreadSafe>();
+		PathSearchIndex->BeginBuild();
+
+		// the registry may only be read here, breaking the paths into trigrams happens on the worker
+		TArray<FAssetData> Assets;
+		AssetRegistry->GetAllAssets(Assets, true);
+
+		TArray<FName> Paths;
+		Paths.Reserve(Assets.Num() * 2);
+
+		for (const FAssetData& Asset : Assets)
+		{
+			Paths.Add(Asset.PackageName);
+			Paths.Add(Asset.ObjectPath);
+		}
+
+		const TSharedRef<FPakMgrPathSearchIndex, ESPMode::ThreadSafe> Index = PathSearchIndex.ToSharedRef();
+
+		PathSearchIndexTask = Async<void>(EAsyncExecution::ThreadPool, [Index, Paths = MoveTemp(Paths)]()
+		{
+			PAKMGR_TRACE_SCOPE(BuildPathSearchIndex);
+
+			const double StartTime = FPlatformTime::Seconds();
+			Index->Build(Paths);
+
+			UE_LOG(LogPakMgr, Log, TEXT("Built path search index with %d paths in %.2f seconds"), Index->Num(), FPlatformTime::Seconds() - StartTime);
+		});
+	}
+
+	return PathSearchIndex.ToSharedRef();
+}
+
+const TArray<FAssetIdentifier>& IPakMgrModule::FindOrResolveRedirectorTargets(FName PackageName, EAssetRegistryDependencyType::Type DependencyType, bool bForwardDependency)
+{
+	if (!bRedirectorPackagesValid)
+	{
+		PAKMGR_TRACE_SCOPE(GatherRedirectors);
+
+		// one registry query for all redirectors instead of one per missing package
+		FARFilter Filter;
+		Filter.ClassNames.Add(UObjectRedirector::StaticClass()->GetFName());
+
+		TArray<FAssetData> Redirectors;
+		AssetRegistry->GetAssets(Filter, Redirectors);
+
+		// sources with their own asset data may hold redirectors the editor does not know
+		if (CurrentRegistrySource->RegistryState)
+		{
+			CurrentRegistrySource->RegistryState->GetAssets(Filter, TSet<FName>(), Redirectors);
+		}
+
+		for (const FAssetData& Redirector : Redirectors)
+		{
+			if (!IsPackageInCurrentRegistrySource(Redirector.PackageName))
+			{
+				RedirectorPackages.Add(Redirector.PackageName);
+			}
+		}
+
+		bRedirectorPackagesValid = true;
+	}
+
+	const TTuple<FName, uint32> Key(PackageName, (uint32)DependencyType | (bForwardDependency ? 1u << 8 : 0u));
+
+	if (const TArray<FAssetIdentifier>* FoundTargets = RedirectorTargets.Find(Key))
+	{
+		return *FoundTargets;
+	}
+
+	TArray<FAssetIdentifier> Targets;
+
+	if (RedirectorPackages.Contains(PackageName))
+	{
+		// follow redirector chains until the references exist in the registry source
+		TSet<FName> VisitedRedirectors;
+		TArray<FName> PendingRedirectors;
+		VisitedRedirectors.Add(PackageName);
+		PendingRedirectors.Add(PackageName);
+
+		while (PendingRedirectors.Num() > 0)
+		{
+			const FName Redirector = PendingRedirectors.Pop(false);
+			TArray<FAssetIdentifier> FoundReferences;
+
+			if (CurrentRegistrySource->RegistryState)
+			{
+				if (bForwardDependency)
+				{
+					CurrentRegistrySource->RegistryState->GetDependencies(Redirector, FoundReferences, DependencyType);
+				}
+				else
+				{
+					CurrentRegistrySource->RegistryState->GetReferencers(Redirector, FoundReferences, DependencyType);
+				}
+			}
+			else if (bForwardDependency)
+			{
+				// streamed sources only keep the edges of cooked packages, the redirector itself is known to the editor
+				AssetRegistry->GetDependencies(Redirector, FoundReferences, DependencyType);
+			}
+			else
+			{
+				CurrentRegistrySource->DependencyGraph->AppendNeighbours(Redirector, DependencyType, true, FoundReferences);
+			}
+
+			for (FAssetIdentifier& Reference : FoundReferences)
+			{
+				if (Reference.PackageName == NAME_None || IsPackageInCurrentRegistrySource(Reference.PackageName))
+				{
+					Targets.Add(MoveTemp(Reference));
+				}
+				else if (RedirectorPackages.Contains(Reference.PackageName) && !VisitedRedirectors.Contains(Reference.PackageName))
+				{
+					VisitedRedirectors.Add(Reference.PackageName);
+					PendingRedirectors.Add(Reference.PackageName);
+				}
+			}
+		}
+	}
+
+	return RedirectorTargets.Add(Key, MoveTemp(Targets));
+}
+
+void IPakMgrModule::HandleAssetAdded(const FAssetData& AssetData)
+{
+	if (PathSearchIndex.IsValid())
+	{
+		PathSearchIndex->AddPath(AssetData.PackageName);
+		PathSearchIndex->AddPath(AssetData.ObjectPath);
+	}
+
+	// assets discovered by the initial scan are picked up by HandleFilesLoaded at once
+	if (AssetRegistry->IsLoadingAssets())
+	{
+		return;
+	}
+
+	if (!CurrentRegistrySource || CurrentRegistrySource->bIsEditor)
+	{
+		InvalidateDependencyGraph();
+	}
+}
+
+void IPakMgrModule::HandleAssetRemoved(const FAssetData& AssetData)
+{
+	if (PathSearchIndex.IsValid())
+	{
+		PathSearchIndex->RemovePath(AssetData.ObjectPath);
+
+		// the package stays while other assets of it are left
+		TArray<FAssetData> PackageAssets;
+		AssetRegistry->GetAssetsByPackageName(AssetData.PackageName, PackageAssets, true);
+
+		if (PackageAssets.FilterByPredicate([&AssetData](const FAssetData& Asset) { return Asset.ObjectPath != AssetData.ObjectPath; }).Num() == 0)
+		{
+			PathSearchIndex->RemovePath(AssetData.PackageName);
+		}
+	}
+
+	if (!CurrentRegistrySource || CurrentRegistrySource->bIsEditor)
+	{
+		InvalidateDependencyGraph();
+	}
+}
+
+void IPakMgrModule::HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath)
+{
+	if (PathSearchIndex.IsValid())
+	{
+		PathSearchIndex->RemovePath(FName(*OldObjectPath));
+		PathSearchIndex->RemovePath(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+		PathSearchIndex->AddPath(AssetData.PackageName);
+		PathSearchIndex->AddPath(AssetData.ObjectPath);
+	}
+
+	if (!CurrentRegistrySource || CurrentRegistrySource->bIsEditor)
+	{
+		InvalidateDependencyGraph();
+	}
+}
+
+void IPakMgrModule::HandlePackageSaved(const FString& PackageFilename, UObject* Outer)
+{
+	// the graph is rebuilt lazily, by then the registry has usually picked up the saved package; its stamp changed, so its edges are not reused
+	if (!CurrentRegistrySource || CurrentRegistrySource->bIsEditor)
+	{
+		InvalidateDependencyGraph();
+	}
+}
+
+void IPakMgrModule::HandleFilesLoaded()
+{
+	if ((CurrentRegistrySource && !CurrentRegistrySource->bIsEditor) || IsRunningCommandlet())
+	{
+		return;
+	}
+
+	// sessions that never asked for the graph do not pay for a refresh, their first GetDependencyGraph builds it incrementally from the cache
+	if (bEditorGraphCacheLoaded)
+	{
+		RefreshEditorDependencyGraphAsync();
 	}
-	return bMadeChange;
 }
 
 bool IPakMgrModule::IsPackageInCurrentRegistrySource(FName PackageName)
@@ -170,6 +622,15 @@ bool IPakMgrModule::IsPackageInCurrentRegistrySource(FName PackageName)
 			return false;
 		}
 	}
+	else if (CurrentRegistrySource && CurrentRegistrySource->DependencyGraph.IsValid() && !CurrentRegistrySource->bIsEditor)
+	{
+		const int32 Node = CurrentRegistrySource->DependencyGraph->FindNode(PackageName);
+
+		if (Node == INDEX_NONE || !CurrentRegistrySource->DependencyGraph->IsInRegistrySource(Node))
+		{
+			return false;
+		}
+	}
 
 	// In editor, no packages are filtered
 	return true;
@@ -455,20 +916,7 @@ bool IPakMgrModule::IsAValidPath(const FString& Path, const TCHAR* InvalidChar,
 
 bool IPakMgrModule::HasValidRoot(const FString& ObjectPath)
 {
-	FString Filename;
-	bool bValidRoot = true;
-	if (!ObjectPath.IsEmpty() && ObjectPath[ObjectPath.Len() - 1] == TEXT('/'))
-	{
-		bValidRoot = FPackageName::TryConvertLongPackageNameToFilename(ObjectPath, Filename);
-	}
-	else
-	{
-		FString ObjectPathWithSlash = ObjectPath;
-		ObjectPathWithSlash.AppendChar(TEXT('/'));
-		bValidRoot = FPackageName::TryConvertLongPackageNameToFilename(ObjectPathWithSlash, Filename);
-	}
-
-	return bValidRoot;
+	return FPakMgrPackageRoots::Get().HasValidRoot(ObjectPath);
 }
 
 void IPakMgrModule::PluginButtonClicked()
@@ -0,0 +1,347 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakMgrTrace.h"
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/ThreadManager.h"
+#include "Misc/Paths.h"
+#include "PakMgrModule.h"
+#include "PakMgrUtf8.h"
+
+
+namespace PakMgrTrace
+{
+	/** Kinds of recorded events. */
+	enum class EEventType : uint8
+	{
+		Scope,
+		Counter,
+		Memory
+	};
+
+	/** A recorded event. */
+	struct FEvent
+	{
+		const TCHAR* Name;
+		FString Detail;
+		uint64 StartCycles;
+		uint64 EndCycles;
+		int64 Value;
+		int64 PeakValue;
+		uint32 ThreadId;
+		EEventType Type;
+
+		FEvent()
+			: Name(nullptr)
+			, StartCycles(0)
+			, EndCycles(0)
+			, Value(0)
+			, PeakValue(0)
+			, ThreadId(0)
+			, Type(EEventType::Scope)
+		{ }
+	};
+
+	/** Holds the events recorded so far. */
+	TQueue<FEvent, EQueueMode::Mpsc> Events;
+
+	/** Holds the cycle counter when recording started, the origin of all time stamps. */
+	uint64 RecordingStartCycles = 0;
+
+	/** Holds the cycle counter of the latest memory sample. */
+	volatile int64 LastMemorySampleCycles = 0;
+
+	/** Holds the highest memory use sampled since recording started. */
+	volatile int64 MemoryHighWaterMark = 0;
+
+	/** Minimum time between two memory samples in seconds. */
+	const double MemorySampleInterval = 0.001;
+
+	/** The trace is written out in blocks of this size. */
+	const int32 BlockSize = 1024 * 1024;
+
+	/** Gets a time stamp in microseconds since recording started. */
+	double GetTimestamp(uint64 Cycles)
+	{
+		const uint64 RelativeCycles = (Cycles > RecordingStartCycles) ? Cycles - RecordingStartCycles : 0;
+
+		return FPlatformTime::ToMilliseconds64(RelativeCycles) * 1000.0;
+	}
+
+	/** Writes a buffer to the file and empties it, returns false on failure. */
+	bool FlushBuffer(FArchive& Archive, TArray<uint8>& Buffer)
+	{
+		Archive.Serialize(Buffer.GetData(), Buffer.Num());
+		Buffer.Reset();
+
+		return !Archive.IsError();
+	}
+
+	/** Gets a thread's display name. */
+	FString GetThreadName(uint32 ThreadId)
+	{
+		if (ThreadId == GGameThreadId)
+		{
+			return TEXT("GameThread");
+		}
+
+		const FString& ThreadName = FThreadManager::GetThreadName(ThreadId);
+
+		return ThreadName.IsEmpty() ? FString::Printf(TEXT("Thread %u"), ThreadId) : ThreadName;
+	}
+
+	/**
+	 * Writes the queued events as a trace, runs on a worker.
+	 *
+	 * @param Filename The trace file to write.
+	 * @param StopCycles The cycle counter when recording stopped, later events are dropped.
+	 * @return true if the file was written.
+	 */
+	bool WriteEvents(const FString& Filename, uint64 StopCycles)
+	{
+		using namespace PakMgrUtf8;
+
+		TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*Filename));
+
+		if (!Archive.IsValid())
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to open %s for writing the trace"), *Filename);
+			Events.Empty();
+
+			return false;
+		}
+
+		TArray<uint8> Buffer;
+		Buffer.Reserve(BlockSize + 4096);
+		AppendAnsi(Buffer, "{\"traceEvents\":[");
+
+		TSet<uint32> ThreadIds;
+		FEvent Event;
+		int32 NumEvents = 0;
+
+		while (Events.Dequeue(Event))
+		{
+			// scopes that were still open when recording stopped may queue events meanwhile
+			if (Event.StartCycles > StopCycles)
+			{
+				continue;
+			}
+
+			if (NumEvents++ > 0)
+			{
+				AppendAnsi(Buffer, ",\n");
+			}
+
+			AppendAnsi(Buffer, "{\"name\":");
+			AppendJsonString(Buffer, Event.Name, FCString::Strlen(Event.Name));
+			AppendFormat(Buffer, ",\"cat\":\"PakMgr\",\"pid\":1,\"tid\":%u,\"ts\":%.3f", Event.ThreadId, GetTimestamp(Event.StartCycles));
+
+			switch (Event.Type)
+			{
+			case EEventType::Scope:
+				AppendFormat(Buffer, ",\"ph\":\"X\",\"dur\":%.3f", FPlatformTime::ToMilliseconds64(Event.EndCycles - Event.StartCycles) * 1000.0);
+
+				if (!Event.Detail.IsEmpty())
+				{
+					AppendAnsi(Buffer, ",\"args\":{\"detail\":");
+					AppendJsonString(Buffer, *Event.Detail, Event.Detail.Len());
+					AppendAnsi(Buffer, "}");
+				}
+				break;
+
+			case EEventType::Counter:
+				AppendFormat(Buffer, ",\"ph\":\"C\",\"args\":{\"value\":%lld}", Event.Value);
+				break;
+
+			case EEventType::Memory:
+				AppendFormat(Buffer, ",\"ph\":\"C\",\"args\":{\"UsedMB\":%.1f,\"PeakMB\":%.1f}", Event.Value / 1048576.0, Event.PeakValue / 1048576.0);
+				break;
+			}
+
+			AppendAnsi(Buffer, "}");
+			ThreadIds.Add(Event.ThreadId);
+
+			if ((Buffer.Num() >= BlockSize) && !FlushBuffer(*Archive, Buffer))
+			{
+				break;
+			}
+		}
+
+		for (uint32 ThreadId : ThreadIds)
+		{
+			AppendFormat(Buffer, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", ThreadId);
+			const FString ThreadName = GetThreadName(ThreadId);
+			AppendJsonString(Buffer, *ThreadName, ThreadName.Len());
+			AppendAnsi(Buffer, "}}");
+		}
+
+		AppendFormat(Buffer, "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"memoryHighWaterMarkMB\":%.1f}}\n", FPakMgrTrace::GetMemoryHighWaterMark() / 1048576.0);
+
+		if (!FlushBuffer(*Archive, Buffer) || !Archive->Close())
+		{
+			UE_LOG(LogPakMgr, Error, TEXT("Failed to write the trace to %s"), *Filename);
+			Events.Empty();
+
+			return false;
+		}
+
+		UE_LOG(LogPakMgr, Log, TEXT("Wrote %d trace events to %s, memory high-water mark %.1f MB"), NumEvents, *Filename, FPakMgrTrace::GetMemoryHighWaterMark() / 1048576.0);
+
+		return true;
+	}
+}
+
+
+/* FPakMgrTrace static initialization
+ *****************************************************************************/
+
+FThreadSafeBool FPakMgrTrace::bRecording;
+FThreadSafeBool FPakMgrTrace::bWriting;
+
+
+/* FPakMgrTrace interface
+ *****************************************************************************/
+
+void FPakMgrTrace::Start()
+{
+	using namespace PakMgrTrace;
+
+	// the worker writing the last recording still takes events from the queue
+	if (bWriting)
+	{
+		UE_LOG(LogPakMgr, Warning, TEXT("Cannot record a trace while the last one is written"));
+
+		return;
+	}
+
+	// scopes still open when the last recording stopped may have queued events since
+	Events.Empty();
+
+	RecordingStartCycles = FPlatformTime::Cycles64();
+	FPlatformAtomics::InterlockedExchange(&LastMemorySampleCycles, 0);
+	FPlatformAtomics::InterlockedExchange(&MemoryHighWaterMark, 0);
+	bRecording = true;
+
+	SampleMemory();
+
+	UE_LOG(LogPakMgr, Log, TEXT("Started recording a trace"));
+}
+
+
+TFuture<bool> FPakMgrTrace::Stop(const FString& Filename)
+{
+	using namespace PakMgrTrace;
+
+	SampleMemory();
+
+	bRecording = false;
+	bWriting = true;
+
+	const uint64 StopCycles = FPlatformTime::Cycles64();
+
+	// formatting millions of events takes a while, the caller does not wait for it
+	return Async<bool>(EAsyncExecution::ThreadPool, [Filename, StopCycles]()
+	{
+		const bool bWritten = WriteEvents(Filename, StopCycles);
+		bWriting = false;
+
+		return bWritten;
+	});
+}
+
+
+FString FPakMgrTrace::GetDefaultFilename()
+{
+	return FPaths::ProfilingDir() / TEXT("PakMgr") / FString::Printf(TEXT("PakMgr-%s.json"), *FDateTime::Now().ToString());
+}
+
+
+uint64 FPakMgrTrace::GetMemoryHighWaterMark()
+{
+	return (uint64)FPlatformAtomics::AtomicRead(&PakMgrTrace::MemoryHighWaterMark);
+}
+
+
+void FPakMgrTrace::RecordScope(const TCHAR* Name, FString&& Detail, uint64 StartCycles, uint64 EndCycles)
+{
+	using namespace PakMgrTrace;
+
+	FEvent Event;
+	Event.Name = Name;
+	Event.Detail = MoveTemp(Detail);
+	Event.StartCycles = StartCycles;
+	Event.EndCycles = EndCycles;
+	Event.ThreadId = FPlatformTLS::GetCurrentThreadId();
+	Event.Type = EEventType::Scope;
+
+	Events.Enqueue(MoveTemp(Event));
+}
+
+
+void FPakMgrTrace::RecordCounter(const TCHAR* Name, int64 Value)
+{
+	using namespace PakMgrTrace;
+
+	FEvent Event;
+	Event.Name = Name;
+	Event.StartCycles = FPlatformTime::Cycles64();
+	Event.Value = Value;
+	Event.ThreadId = FPlatformTLS::GetCurrentThreadId();
+	Event.Type = EEventType::Counter;
+
+	Events.Enqueue(MoveTemp(Event));
+}
+
+
+void FPakMgrTrace::SampleMemory()
+{
+	using namespace PakMgrTrace;
+
+	if (!bRecording)
+	{
+		return;
+	}
+
+	// reading the memory stats is a system call, so only one thread samples at a time, and not too often
+	const int64 CurrentCycles = (int64)FPlatformTime::Cycles64();
+	const int64 LastCycles = FPlatformAtomics::AtomicRead(&LastMemorySampleCycles);
+
+	if ((LastCycles != 0) && (FPlatformTime::ToSeconds64(CurrentCycles - LastCycles) < MemorySampleInterval))
+	{
+		return;
+	}
+
+	if (FPlatformAtomics::InterlockedCompareExchange(&LastMemorySampleCycles, CurrentCycles, LastCycles) != LastCycles)
+	{
+		return;
+	}
+
+	const FPlatformMemoryStats Stats = FPlatformMemory::GetStats();
+	const int64 UsedMemory = (int64)Stats.UsedPhysical;
+
+	int64 HighWaterMark = FPlatformAtomics::AtomicRead(&MemoryHighWaterMark);
+
+	while (UsedMemory > HighWaterMark)
+	{
+		if (FPlatformAtomics::InterlockedCompareExchange(&MemoryHighWaterMark, UsedMemory, HighWaterMark) == HighWaterMark)
+		{
+			HighWaterMark = UsedMemory;
+			break;
+		}
+
+		HighWaterMark = FPlatformAtomics::AtomicRead(&MemoryHighWaterMark);
+	}
+
+	FEvent Event;
+	Event.Name = TEXT("Memory");
+	Event.StartCycles = (uint64)CurrentCycles;
+	Event.Value = UsedMemory;
+	// the peak of this recording, PeakUsedPhysical would be the peak of the whole process
+	Event.PeakValue = HighWaterMark;
+	Event.ThreadId = FPlatformTLS::GetCurrentThreadId();
+	Event.Type = EEventType::Memory;
+
+	Events.Enqueue(MoveTemp(Event));
+}
@@ -0,0 +1,160 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Stats/Stats.h"
+
+/**
+ * Records PakMgr operations as a Chrome trace.
+ *
+ * While recording, scopes, counters and samples of the process memory are queued from any thread
+ * without locking. Once recording stops, a worker formats them as UTF-8 trace events and writes
+ * them out in large blocks, so stopping a long recording does not hold up the caller. The file
+ * opens in chrome://tracing or ui.perfetto.dev. Memory is sampled at scope boundaries, at most
+ * once per millisecond, and the highest sample is kept as the recording's high-water mark.
+ *
+ * When not recording, a scope costs a flag test on top of the cycle stat it also declares.
+ */
+class FPakMgrTrace
+{
+public:
+
+	/** Starts recording, dropping events left over from an earlier recording. Ignored while the last one is still written. */
+	static void Start();
+
+	/**
+	 * Stops recording and writes the recorded events on a worker thread.
+	 *
+	 * @param Filename The trace file to write.
+	 * @return Becomes true once the file was written, or false if writing it failed.
+	 */
+	static TFuture<bool> Stop(const FString& Filename);
+
+	/** Checks whether events are being recorded. */
+	static bool IsRecording()
+	{
+		return bRecording;
+	}
+
+	/** Checks whether a stopped recording is still being written. */
+	static bool IsWriting()
+	{
+		return bWriting;
+	}
+
+	/** Gets a new trace file name in the profiling directory. */
+	static FString GetDefaultFilename();
+
+	/** Gets the highest memory use sampled since recording started, in bytes. */
+	static uint64 GetMemoryHighWaterMark();
+
+public:
+
+	/**
+	 * Records a scope that ended, called by FPakMgrTraceScope.
+	 *
+	 * @param Name The scope name, which must outlive the recording.
+	 * @param Detail Optional text shown with the scope, e.g. the pak being built.
+	 * @param StartCycles The cycle counter when the scope began.
+	 * @param EndCycles The cycle counter when the scope ended.
+	 */
+	static void RecordScope(const TCHAR* Name, FString&& Detail, uint64 StartCycles, uint64 EndCycles);
+
+	/**
+	 * Records the value of a counter.
+	 *
+	 * @param Name The counter name, which must outlive the recording.
+	 * @param Value The current value.
+	 */
+	static void RecordCounter(const TCHAR* Name, int64 Value);
+
+	/** Records the process memory use, unless it was sampled within the last millisecond. */
+	static void SampleMemory();
+
+private:
+
+	/** Holds a flag indicating whether events are being recorded. */
+	static FThreadSafeBool bRecording;
+
+	/** Holds a flag indicating whether a stopped recording is being written. */
+	static FThreadSafeBool bWriting;
+};
+
+
+/**
+ * Records the time spent in a C++ scope while FPakMgrTrace is recording.
+ *
+ * Use PAKMGR_TRACE_SCOPE or PAKMGR_TRACE_SCOPE_TEXT rather than this class.
+ */
+class FPakMgrTraceScope
+{
+public:
+
+	explicit FPakMgrTraceScope(const TCHAR* InName)
+		: Name(FPakMgrTrace::IsRecording() ? InName : nullptr)
+		, StartCycles(0)
+	{
+		Begin();
+	}
+
+	FPakMgrTraceScope(const TCHAR* InName, FString&& InDetail)
+		: Name(FPakMgrTrace::IsRecording() ? InName : nullptr)
+		, Detail(MoveTemp(InDetail))
+		, StartCycles(0)
+	{
+		Begin();
+	}
+
+	~FPakMgrTraceScope()
+	{
+		if (Name != nullptr)
+		{
+			FPakMgrTrace::RecordScope(Name, MoveTemp(Detail), StartCycles, FPlatformTime::Cycles64());
+			FPakMgrTrace::SampleMemory();
+		}
+	}
+
+private:
+
+	void Begin()
+	{
+		if (Name != nullptr)
+		{
+			FPakMgrTrace::SampleMemory();
+			StartCycles = FPlatformTime::Cycles64();
+		}
+	}
+
+	/** Holds the scope name, null if not recording. */
+	const TCHAR* Name;
+
+	/** Holds the text shown with the scope. */
+	FString Detail;
+
+	/** Holds the cycle counter when the scope began. */
+	uint64 StartCycles;
+};
+
+
+/** Times the rest of the C++ scope as a stat, and as a trace event while recording. */
+#define PAKMGR_TRACE_SCOPE(Name) \
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_PakMgr_##Name); \
+	FPakMgrTraceScope PakMgrTraceScope_##Name(TEXT(#Name))
+
+/** Like PAKMGR_TRACE_SCOPE, with a text shown with the event. The text is only evaluated while recording. */
+#define PAKMGR_TRACE_SCOPE_TEXT(Name, DetailText) \
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_PakMgr_##Name); \
+	FPakMgrTraceScope PakMgrTraceScope_##Name(TEXT(#Name), FPakMgrTrace::IsRecording() ? FString(DetailText) : FString())
+
+/** Records the value of a counter while recording. */
+#define PAKMGR_TRACE_COUNTER(Name, Value) \
+	do \
+	{ \
+		if (FPakMgrTrace::IsRecording()) \
+		{ \
+			FPakMgrTrace::RecordCounter(TEXT(#Name), (int64)(Value)); \
+		} \
+	} while (0)
@@ -0,0 +1,79 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#include "PakMgrUtf8.h"
+
+
+/* PakMgrUtf8 interface
+ *****************************************************************************/
+
+void PakMgrUtf8::AppendUtf8(TArray<uint8>& Buffer, const TCHAR* Text, int32 Length)
+{
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		uint32 CodePoint = (uint32)Text[Index];
+
+		// UTF-16 surrogate pairs, on platforms with two byte characters
+		if ((CodePoint >= 0xD800) && (CodePoint <= 0xDBFF) && (Index + 1 < Length) && ((uint32)Text[Index + 1] >= 0xDC00) && ((uint32)Text[Index + 1] <= 0xDFFF))
+		{
+			CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + ((uint32)Text[++Index] - 0xDC00);
+		}
+
+		if (CodePoint < 0x80)
+		{
+			Buffer.Add((uint8)CodePoint);
+		}
+		else if (CodePoint < 0x800)
+		{
+			Buffer.Add((uint8)(0xC0 | (CodePoint >> 6)));
+			Buffer.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+		}
+		else if (CodePoint < 0x10000)
+		{
+			Buffer.Add((uint8)(0xE0 | (CodePoint >> 12)));
+			Buffer.Add((uint8)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+		}
+		else
+		{
+			Buffer.Add((uint8)(0xF0 | ((CodePoint >> 18) & 0x07)));
+			Buffer.Add((uint8)(0x80 | ((CodePoint >> 12) & 0x3F)));
+			Buffer.Add((uint8)(0x80 | ((CodePoint >> 6) & 0x3F)));
+			Buffer.Add((uint8)(0x80 | (CodePoint & 0x3F)));
+		}
+	}
+}
+
+
+void PakMgrUtf8::AppendJsonString(TArray<uint8>& Buffer, const TCHAR* Text, int32 Length)
+{
+	Buffer.Add('"');
+
+	int32 RunStart = 0;
+
+	for (int32 Index = 0; Index < Length; ++Index)
+	{
+		const TCHAR Char = Text[Index];
+
+		if ((Char != TEXT('"')) && (Char != TEXT('\\')) && (Char >= 0x20))
+		{
+			continue;
+		}
+
+		// characters needing no escape are appended in runs
+		AppendUtf8(Buffer, Text + RunStart, Index - RunStart);
+		RunStart = Index + 1;
+
+		switch (Char)
+		{
+		case TEXT('"'): AppendAnsi(Buffer, "\\\"", 2); break;
+		case TEXT('\\'): AppendAnsi(Buffer, "\\\\", 2); break;
+		case TEXT('\n'): AppendAnsi(Buffer, "\\n", 2); break;
+		case TEXT('\r'): AppendAnsi(Buffer, "\\r", 2); break;
+		case TEXT('\t'): AppendAnsi(Buffer, "\\t", 2); break;
+		default: AppendFormat(Buffer, "\\u%04x", (uint32)Char);
+		}
+	}
+
+	AppendUtf8(Buffer, Text + RunStart, Length - RunStart);
+	Buffer.Add('"');
+}
@@ -0,0 +1,54 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Appends UTF-8 text to byte buffers.
+ *
+ * Used by the writers that format large files into a buffer and write it out in blocks, i.e. the
+ * log exporter and the trace, so both encode and escape text the same way.
+ */
+namespace PakMgrUtf8
+{
+	/** Appends ANSI characters to a buffer. */
+	inline void AppendAnsi(TArray<uint8>& Buffer, const ANSICHAR* Text, int32 Length)
+	{
+		Buffer.Append((const uint8*)Text, Length);
+	}
+
+	/** Appends null terminated ANSI characters to a buffer. */
+	inline void AppendAnsi(TArray<uint8>& Buffer, const ANSICHAR* Text)
+	{
+		AppendAnsi(Buffer, Text, FCStringAnsi::Strlen(Text));
+	}
+
+	/** Appends formatted ANSI characters to a buffer, without going through an FString. */
+	template <typename... ArgTypes>
+	void AppendFormat(TArray<uint8>& Buffer, const ANSICHAR* Format, ArgTypes... Args)
+	{
+		ANSICHAR Scratch[256];
+		const int32 Length = FCStringAnsi::Snprintf(Scratch, sizeof(Scratch), Format, Args...);
+
+		AppendAnsi(Buffer, Scratch, FMath::Clamp<int32>(Length, 0, sizeof(Scratch) - 1));
+	}
+
+	/**
+	 * Appends a text as UTF-8 to a buffer.
+	 *
+	 * @param Buffer The buffer to append to.
+	 * @param Text The text, which need not be null terminated.
+	 * @param Length The number of characters to append.
+	 */
+	void AppendUtf8(TArray<uint8>& Buffer, const TCHAR* Text, int32 Length);
+
+	/**
+	 * Appends a text as an escaped UTF-8 JSON string, quotes included, to a buffer.
+	 *
+	 * @param Buffer The buffer to append to.
+	 * @param Text The text, which need not be null terminated.
+	 * @param Length The number of characters to append.
+	 */
+	void AppendJsonString(TArray<uint8>& Buffer, const TCHAR* Text, int32 Length);
+}
@@ -6,6 +6,7 @@
 #include "Models/IFileInstanceInfo.h"
 #include "Models/IFileInfo.h"
 #include "Models/FileItemInfo.h"
+#include "Models/PakModuleInfo.h"
 
 /**
  * Interface for the session manager.
@@ -75,10 +76,34 @@ public:
 
 	virtual bool SetAddModule(FString& moduleName) = 0;
 
+	/**
+	 * Gets the modules whose dependency closures were generated last.
+	 *
+	 * @return The modules.
+	 * @see SetModules
+	 */
+	virtual const TArray<FPakModuleInfo>& GetModules() const = 0;
+
+	/**
+	 * Replaces the generated pak modules.
+	 *
+	 * @param InModules The modules and their dependency closures.
+	 * @see GetModules
+	 */
+	virtual void SetModules(const TArray<FPakModuleInfo>& InModules) = 0;
+
 public:
 
 	DECLARE_EVENT_OneParam(IFileManager, FAddModuleEvent, const FString &/*moduleName*/)
 	virtual FAddModuleEvent& OnAddModule() = 0;
+
+	/**
+	 * Returns a delegate that is executed when the generated modules changed.
+	 *
+	 * @return The delegate.
+	 */
+	virtual FSimpleMulticastDelegate& OnModulesChanged() = 0;
+
 	/**
 	 * Returns a delegate that is executed before a session is being selected.
 	 *
@@ -0,0 +1,523 @@
+// Copyright 1998-2019 Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+
+/*
+ * Binary pak manifest, written by GenMani and GenPaks, read by the game at boot.
+ *
+ * The file is a header followed by fixed-size record arrays, so it can be memory-mapped and
+ * queried in place:
+ *
+ *   FPakManifestHeader
+ *   FPakManifestModule[NumModules]
+ *   FPakManifestPak[NumPaks]
+ *   FPakManifestPackage[NumPackages]      grouped by pak, see FPakManifestPak::FirstPackage
+ *   FPakManifestBucket[NumModuleBuckets]  open addressing table over module names
+ *   FPakManifestBucket[NumPackageBuckets] open addressing table over package names
+ *   uint32[NumIndices]                    pak lists of modules and dependency lists of paks
+ *   ANSICHAR[StringsSize]                 null terminated UTF-8 strings
+ *
+ * Offsets in the header are relative to the start of the file and 8 byte aligned, name fields in
+ * records are offsets into the string section. All values are little endian.
+ */
+
+
+namespace PakManifestFormat
+{
+	/** The file magic, 'PMNF'. */
+	const uint32 Magic = 0x464E4D50;
+
+	/** The current format version. Readers reject other versions. */
+	const uint32 Version = 1;
+
+	/** The bucket index marking an empty bucket. */
+	const uint32 InvalidIndex = MAX_uint32;
+
+	/** Hashes a name for the lookup tables. Names compare case-insensitively, like package names. */
+	inline uint64 HashName(const ANSICHAR* Name)
+	{
+		// 64 bit FNV-1a over the lower case bytes, stable across processes and platforms
+		uint64 Hash = 0xcbf29ce484222325ull;
+
+		for (; *Name != '\0'; ++Name)
+		{
+			Hash ^= (uint8)FCharAnsi::ToLower(*Name);
+			Hash *= 0x100000001b3ull;
+		}
+
+		return Hash;
+	}
+}
+
+
+/** Header at the start of a manifest file. */
+struct FPakManifestHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 NumModules;
+	uint32 NumPaks;
+	uint32 NumPackages;
+	uint32 NumModuleBuckets;
+	uint32 NumPackageBuckets;
+	uint32 NumIndices;
+	uint32 ModulesOffset;
+	uint32 PaksOffset;
+	uint32 PackagesOffset;
+	uint32 ModuleBucketsOffset;
+	uint32 PackageBucketsOffset;
+	uint32 IndicesOffset;
+	uint32 StringsOffset;
+	uint32 StringsSize;
+};
+
+
+/** A module, the unit the game mounts. */
+struct FPakManifestModule
+{
+	/** Holds the name of the module. */
+	uint32 Name;
+
+	/** Holds the first index of the module's paks in the index section. */
+	uint32 FirstPak;
+
+	/** Holds the number of paks the module needs, including common paks. */
+	uint32 NumPaks;
+
+	uint32 Padding;
+
+	/** Holds the total size of the module's paks in bytes. */
+	uint64 Size;
+};
+
+
+/** A pak file. */
+struct FPakManifestPak
+{
+	/** Holds the display name of the pak. */
+	uint32 Name;
+
+	/** Holds the pak file name, relative to the manifest. */
+	uint32 Filename;
+
+	/** Holds the index of the pak's first package. */
+	uint32 FirstPackage;
+
+	/** Holds the number of packages mapped to the pak. */
+	uint32 NumPackages;
+
+	/** Holds the first index of the paks this pak depends on in the index section. */
+	uint32 FirstDependency;
+
+	/** Holds the number of paks this pak depends on. */
+	uint32 NumDependencies;
+
+	/** Holds the size of the pak file in bytes, zero if it was not built yet. */
+	uint64 Size;
+
+	/** Holds the total size of the cooked files stored in the pak. */
+	uint64 UncompressedSize;
+};
+
+
+/** A package and the pak it is mounted from. */
+struct FPakManifestPackage
+{
+	/** Holds the long package name. */
+	uint32 Name;
+
+	/** Holds the index of the pak holding the package. */
+	uint32 Pak;
+
+	/** Holds the total size of the package's cooked files. */
+	uint64 Size;
+};
+
+
+/** A bucket of a name lookup table. */
+struct FPakManifestBucket
+{
+	/** Holds the name hash, see PakManifestFormat::HashName. */
+	uint64 Hash;
+
+	/** Holds the index of the record, or PakManifestFormat::InvalidIndex if the bucket is empty. */
+	uint32 Index;
+
+	uint32 Padding;
+};
+
+
+static_assert(sizeof(FPakManifestHeader) == 64, "The manifest header layout must not change without a version bump.");
+static_assert(sizeof(FPakManifestModule) == 24, "The manifest module layout must not change without a version bump.");
+static_assert(sizeof(FPakManifestPak) == 40, "The manifest pak layout must not change without a version bump.");
+static_assert(sizeof(FPakManifestPackage) == 16, "The manifest package layout must not change without a version bump.");
+static_assert(sizeof(FPakManifestBucket) == 16, "The manifest bucket layout must not change without a version bump.");
+
+
+/**
+ * Read-only view of a manifest in memory.
+ *
+ * The view does not copy or parse anything. Initialize checks the header, the section bounds and
+ * every offset and index held by the records in one pass, so a truncated or corrupt manifest is
+ * rejected up front. Every query afterwards is a constant time array access or hash table probe.
+ */
+class FPakManifestView
+{
+public:
+
+	/** Default constructor. */
+	FPakManifestView()
+		: Data(nullptr)
+		, Size(0)
+	{ }
+
+	/**
+	 * Initializes the view on a manifest image.
+	 *
+	 * @param InData The manifest data, must stay valid while the view is used.
+	 * @param InSize The size of the data.
+	 * @return false if the data is not a valid manifest of the current version.
+	 */
+	bool Initialize(const uint8* InData, int64 InSize)
+	{
+		Data = nullptr;
+		Size = 0;
+
+		if ((InData == nullptr) || (InSize < (int64)sizeof(FPakManifestHeader)) || (InSize > MAX_uint32) || !IsAligned(InData, 8))
+		{
+			return false;
+		}
+
+		const FPakManifestHeader& InHeader = *(const FPakManifestHeader*)InData;
+
+		if ((InHeader.Magic != PakManifestFormat::Magic) || (InHeader.Version != PakManifestFormat::Version))
+		{
+			return false;
+		}
+
+		// bucket counts are powers of two so probing can mask instead of divide
+		if (!FMath::IsPowerOfTwo(InHeader.NumModuleBuckets) || !FMath::IsPowerOfTwo(InHeader.NumPackageBuckets))
+		{
+			return false;
+		}
+
+		auto IsSectionValid = [InSize](uint32 Offset, uint32 Num, uint32 Stride)
+		{
+			return ((Offset % 8) == 0) && ((uint64)Offset + (uint64)Num * Stride <= (uint64)InSize);
+		};
+
+		if (!IsSectionValid(InHeader.ModulesOffset, InHeader.NumModules, sizeof(FPakManifestModule)) ||
+			!IsSectionValid(InHeader.PaksOffset, InHeader.NumPaks, sizeof(FPakManifestPak)) ||
+			!IsSectionValid(InHeader.PackagesOffset, InHeader.NumPackages, sizeof(FPakManifestPackage)) ||
+			!IsSectionValid(InHeader.ModuleBucketsOffset, InHeader.NumModuleBuckets, sizeof(FPakManifestBucket)) ||
+			!IsSectionValid(InHeader.PackageBucketsOffset, InHeader.NumPackageBuckets, sizeof(FPakManifestBucket)) ||
+			!IsSectionValid(InHeader.IndicesOffset, InHeader.NumIndices, sizeof(uint32)) ||
+			!IsSectionValid(InHeader.StringsOffset, InHeader.StringsSize, 1) ||
+			(InHeader.StringsSize == 0) ||
+			(InData[InHeader.StringsOffset + InHeader.StringsSize - 1] != '\0'))
+		{
+			return false;
+		}
+
+		// records are trusted by the queries, so every offset and index they hold must be in range
+		if (!AreRecordsValid(InData, InHeader))
+		{
+			return false;
+		}
+
+		Data = InData;
+		Size = InSize;
+
+		return true;
+	}
+
+	/** Checks whether the view holds a valid manifest. */
+	bool IsValid() const
+	{
+		return Data != nullptr;
+	}
+
+public:
+
+	/** Gets the number of modules. */
+	int32 NumModules() const
+	{
+		return GetHeader().NumModules;
+	}
+
+	/** Gets the number of paks. */
+	int32 NumPaks() const
+	{
+		return GetHeader().NumPaks;
+	}
+
+	/** Gets the number of packages. */
+	int32 NumPackages() const
+	{
+		return GetHeader().NumPackages;
+	}
+
+	/** Gets a module by index. */
+	const FPakManifestModule& GetModule(int32 Index) const
+	{
+		check((uint32)Index < GetHeader().NumModules);
+		return GetSection<FPakManifestModule>(GetHeader().ModulesOffset)[Index];
+	}
+
+	/** Gets a pak by index. */
+	const FPakManifestPak& GetPak(int32 Index) const
+	{
+		check((uint32)Index < GetHeader().NumPaks);
+		return GetSection<FPakManifestPak>(GetHeader().PaksOffset)[Index];
+	}
+
+	/** Gets a package by index. */
+	const FPakManifestPackage& GetPackage(int32 Index) const
+	{
+		check((uint32)Index < GetHeader().NumPackages);
+		return GetSection<FPakManifestPackage>(GetHeader().PackagesOffset)[Index];
+	}
+
+	/** Gets a string of the string section, see the name fields of the records. */
+	const ANSICHAR* GetString(uint32 Offset) const
+	{
+		check(Offset < GetHeader().StringsSize);
+		return (const ANSICHAR*)(Data + GetHeader().StringsOffset + Offset);
+	}
+
+	/** Gets the indices of the paks a module needs. */
+	TArrayView<const uint32> GetModulePaks(const FPakManifestModule& Module) const
+	{
+		return GetIndices(Module.FirstPak, Module.NumPaks);
+	}
+
+	/** Gets the indices of the paks a pak depends on. */
+	TArrayView<const uint32> GetPakDependencies(const FPakManifestPak& Pak) const
+	{
+		return GetIndices(Pak.FirstDependency, Pak.NumDependencies);
+	}
+
+	/**
+	 * Finds a module by name.
+	 *
+	 * @param Name The UTF-8 module name.
+	 * @return The module index, or INDEX_NONE if the module is unknown.
+	 */
+	int32 FindModule(const ANSICHAR* Name) const
+	{
+		return Find<FPakManifestModule>(Name, GetHeader().ModulesOffset, GetHeader().ModuleBucketsOffset, GetHeader().NumModuleBuckets);
+	}
+
+	/**
+	 * Finds a package by its long package name.
+	 *
+	 * @param Name The UTF-8 long package name.
+	 * @return The package index, or INDEX_NONE if the package is not in any pak.
+	 */
+	int32 FindPackage(const ANSICHAR* Name) const
+	{
+		return Find<FPakManifestPackage>(Name, GetHeader().PackagesOffset, GetHeader().PackageBucketsOffset, GetHeader().NumPackageBuckets);
+	}
+
+private:
+
+	/** Checks the string offsets, record indices and index ranges of all records and buckets. */
+	static bool AreRecordsValid(const uint8* InData, const FPakManifestHeader& InHeader)
+	{
+		const FPakManifestModule* Modules = (const FPakManifestModule*)(InData + InHeader.ModulesOffset);
+		const FPakManifestPak* Paks = (const FPakManifestPak*)(InData + InHeader.PaksOffset);
+		const FPakManifestPackage* Packages = (const FPakManifestPackage*)(InData + InHeader.PackagesOffset);
+		const uint32* Indices = (const uint32*)(InData + InHeader.IndicesOffset);
+
+		auto IsRangeValid = [](uint32 First, uint32 Num, uint32 Max)
+		{
+			return (uint64)First + Num <= Max;
+		};
+
+		auto ArePaksValid = [&](uint32 First, uint32 Num)
+		{
+			if (!IsRangeValid(First, Num, InHeader.NumIndices))
+			{
+				return false;
+			}
+
+			for (uint32 Index = First; Index < First + Num; ++Index)
+			{
+				if (Indices[Index] >= InHeader.NumPaks)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		auto AreBucketsValid = [InData](uint32 Offset, uint32 NumBuckets, uint32 NumRecords)
+		{
+			const FPakManifestBucket* Buckets = (const FPakManifestBucket*)(InData + Offset);
+
+			for (uint32 Index = 0; Index < NumBuckets; ++Index)
+			{
+				if ((Buckets[Index].Index != PakManifestFormat::InvalidIndex) && (Buckets[Index].Index >= NumRecords))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		};
+
+		for (uint32 Index = 0; Index < InHeader.NumModules; ++Index)
+		{
+			if ((Modules[Index].Name >= InHeader.StringsSize) || !ArePaksValid(Modules[Index].FirstPak, Modules[Index].NumPaks))
+			{
+				return false;
+			}
+		}
+
+		for (uint32 Index = 0; Index < InHeader.NumPaks; ++Index)
+		{
+			const FPakManifestPak& Pak = Paks[Index];
+
+			if ((Pak.Name >= InHeader.StringsSize) || (Pak.Filename >= InHeader.StringsSize) ||
+				!IsRangeValid(Pak.FirstPackage, Pak.NumPackages, InHeader.NumPackages) ||
+				!ArePaksValid(Pak.FirstDependency, Pak.NumDependencies))
+			{
+				return false;
+			}
+		}
+
+		for (uint32 Index = 0; Index < InHeader.NumPackages; ++Index)
+		{
+			if ((Packages[Index].Name >= InHeader.StringsSize) || (Packages[Index].Pak >= InHeader.NumPaks))
+			{
+				return false;
+			}
+		}
+
+		return AreBucketsValid(InHeader.ModuleBucketsOffset, InHeader.NumModuleBuckets, InHeader.NumModules) &&
+			AreBucketsValid(InHeader.PackageBucketsOffset, InHeader.NumPackageBuckets, InHeader.NumPackages);
+	}
+
+	const FPakManifestHeader& GetHeader() const
+	{
+		check(IsValid());
+		return *(const FPakManifestHeader*)Data;
+	}
+
+	template<typename RecordType>
+	const RecordType* GetSection(uint32 Offset) const
+	{
+		return (const RecordType*)(Data + Offset);
+	}
+
+	TArrayView<const uint32> GetIndices(uint32 First, uint32 Num) const
+	{
+		check((uint64)First + Num <= GetHeader().NumIndices);
+		return TArrayView<const uint32>(GetSection<uint32>(GetHeader().IndicesOffset) + First, Num);
+	}
+
+	/** Probes a lookup table, records are compared by their leading name field. */
+	template<typename RecordType>
+	int32 Find(const ANSICHAR* Name, uint32 RecordsOffset, uint32 BucketsOffset, uint32 NumBuckets) const
+	{
+		const FPakManifestBucket* Buckets = GetSection<FPakManifestBucket>(BucketsOffset);
+		const RecordType* Records = GetSection<RecordType>(RecordsOffset);
+		const uint64 Hash = PakManifestFormat::HashName(Name);
+
+		for (uint32 Probe = 0; Probe < NumBuckets; ++Probe)
+		{
+			const FPakManifestBucket& Bucket = Buckets[(Hash + Probe) & (NumBuckets - 1)];
+
+			if (Bucket.Index == PakManifestFormat::InvalidIndex)
+			{
+				break;
+			}
+
+			if ((Bucket.Hash == Hash) && (FCStringAnsi::Stricmp(GetString(Records[Bucket.Index].Name), Name) == 0))
+			{
+				return (int32)Bucket.Index;
+			}
+		}
+
+		return INDEX_NONE;
+	}
+
+private:
+
+	const uint8* Data;
+	int64 Size;
+};
+
+
+/**
+ * Manifest file opened for reading.
+ *
+ * The file is memory-mapped where the platform supports it and loaded into memory otherwise.
+ */
+class FPakManifestFile
+{
+public:
+
+	/**
+	 * Opens a manifest file.
+	 *
+	 * @param Filename The manifest to open.
+	 * @return false if the file could not be read or is not a valid manifest.
+	 */
+	bool Open(const TCHAR* Filename)
+	{
+		Close();
+
+		IMappedFileHandle* MappedHandle = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(Filename);
+
+		if (MappedHandle != nullptr)
+		{
+			Handle.Reset(MappedHandle);
+			Region.Reset(Handle->MapRegion());
+
+			if (Region.IsValid() && View.Initialize(Region->GetMappedPtr(), Region->GetMappedSize()))
+			{
+				return true;
+			}
+
+			Close();
+		}
+
+		return FFileHelper::LoadFileToArray(Buffer, Filename, FILEREAD_Silent) && View.Initialize(Buffer.GetData(), Buffer.Num());
+	}
+
+	/** Closes the file. */
+	void Close()
+	{
+		View = FPakManifestView();
+		Region.Reset();
+		Handle.Reset();
+		Buffer.Empty();
+	}
+
+	/** Gets the view on the file's content. Invalid if the file is not open. */
+	const FPakManifestView& GetView() const
+	{
+		return View;
+	}
+
+private:
+
+	/** Holds the view on the mapped region or the buffer. */
+	FPakManifestView View;
+
+	/** Holds the mapped file, if the platform supports mapping. */
+	TUniquePtr<IMappedFileHandle> Handle;
+
+	/** Holds the mapped region of the file. */
+	TUniquePtr<IMappedFileRegion> Region;
+
+	/** Holds the file content if it could not be mapped. */
+	TArray<uint8> Buffer;
+};
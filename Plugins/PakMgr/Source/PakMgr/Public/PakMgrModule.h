@@ -10,6 +10,9 @@
 #include "IMessageBus.h"
 #include "AssetRegistryState.h"
 #include "SPakMgrPanel.h"
+#include "Models/DependencyGraph.h"
+#include "Models/PathSearchIndex.h"
+#include "Async/Future.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogPakMgr, Log, All);
 
@@ -31,6 +34,9 @@ struct FPakMgrRegistrySource
 	/** Raw asset registry state, if bIsEditor is true this points to the real editor asset registry */
 	const FAssetRegistryState* RegistryState;
 
+	/** Dependency data of a source streamed from a cooked registry instead of loaded into RegistryState, may be null */
+	FPakMgrDependencyGraphPtr DependencyGraph;
+
 	/** If true, this is the editor  */
 	uint8 bIsEditor : 1;
 
@@ -86,6 +92,20 @@ public:
 
 	/** Filters list of identifiers and removes ones that do not exist in this registry source. Handles replacing redirectors as well */
 	bool FilterAssetIdentifiersForCurrentRegistrySource(TArray<FAssetIdentifier>& AssetIdentifiers, EAssetRegistryDependencyType::Type DependencyType = EAssetRegistryDependencyType::None, bool bForwardDependency = true);
+	/** Returns true if FilterAssetIdentifiersForCurrentRegistrySource changes anything, false if the editor registry is the source */
+	bool NeedsRegistrySourceFiltering() const;
+	/** Gets the dependency graph snapshot of the current registry source, building it on first use. While the editor registry is still scanning, this may be the graph cached by an earlier session */
+	FPakMgrDependencyGraphPtr GetDependencyGraph();
+	/** Drops the dependency graph snapshot and redirector tables, the next call to GetDependencyGraph creates a new one */
+	void InvalidateDependencyGraph();
+	/** Makes a cooked AssetRegistry.bin the current registry source, streaming only its dependency data. Returns false if the file could not be read */
+	bool LoadCookedRegistrySource(const FString& Filename);
+	/** Makes a registry state the current registry source, e.g. one generated by a tool, and takes ownership of it */
+	void SetCustomRegistrySource(FAssetRegistryState* State, const FString& SourceFilename);
+	/** Makes the editor registry the current registry source again */
+	void ResetRegistrySource();
+	/** Gets the search index over all package and object paths of the editor registry, building it in the background on first use */
+	TSharedRef<FPakMgrPathSearchIndex, ESPMode::ThreadSafe> GetPathSearchIndex();
 	FAssetData FindAssetDataFromAnyPath(const FString& AnyAssetPath, FString& OutFailureReason);
 	/** path get from OpenFileDialg() is a relative path, event if convert it to absolute path(ep. c:/xxx/GameProj/Content/xxx).
 	* So we need a function to convert absolute path to /Game/xxx path, so that asset data can be got.
@@ -106,6 +126,22 @@ private:
 	void AddToolbarExtension(FToolBarBuilder& Builder);
 	void AddMenuExtension(FMenuBuilder& Builder);
 	bool IsPackageInCurrentRegistrySource(FName PackageName);
+	/** Gets what a redirector package missing from the registry source resolves to, empty if the package is not a redirector */
+	const TArray<FAssetIdentifier>& FindOrResolveRedirectorTargets(FName PackageName, EAssetRegistryDependencyType::Type DependencyType, bool bForwardDependency);
+	void HandleAssetAdded(const FAssetData& AssetData);
+	void HandleAssetRemoved(const FAssetData& AssetData);
+	void HandleAssetRenamed(const FAssetData& AssetData, const FString& OldObjectPath);
+	/** Drops the editor dependency graph when a package is saved, its dependencies may have changed without any asset being added, removed or renamed */
+	void HandlePackageSaved(const FString& PackageFilename, UObject* Outer);
+	void HandleFilesLoaded();
+	/** Copies the dependencies, package data and tagless asset data of the editor registry */
+	void CopyEditorRegistryState(FAssetRegistryState& OutState) const;
+	/** Rebuilds the editor dependency graph on a worker thread, replacing the current one unless it changed meanwhile */
+	void RefreshEditorDependencyGraphAsync();
+	/** Writes the editor dependency graph cache on a worker thread */
+	void SaveEditorDependencyGraphAsync(const FPakMgrDependencyGraphPtr& Graph);
+	/** Waits for the background work on the editor dependency graph */
+	void WaitForEditorDependencyGraphTask();
 
 	TSharedRef<class SDockTab> OnSpawnPluginTab(const class FSpawnTabArgs& SpawnTabArgs);
 
@@ -118,5 +154,22 @@ private:
 	TSharedPtr<IPFileManager> PFileManager;
 	FPakMgrRegistrySource* CurrentRegistrySource;
 	IAssetRegistry* AssetRegistry;
+	/** Frozen dependency graph of the current registry source, null until first requested */
+	FPakMgrDependencyGraphPtr DependencyGraph;
+	/** Latest editor dependency graph, loaded from the cache or built, which later editor graphs are built incrementally from */
+	FPakMgrDependencyGraphPtr PreviousEditorGraph;
+	/** Background refresh or cache write of the editor dependency graph */
+	TFuture<void> EditorGraphTask;
+	/** Whether the editor graph was requested in this session, which loads the cache and keeps the graph refreshed from then on */
+	bool bEditorGraphCacheLoaded;
+	/** Search index over package and object paths, kept up to date once requested */
+	TSharedPtr<FPakMgrPathSearchIndex, ESPMode::ThreadSafe> PathSearchIndex;
+	/** Background build of the path search index */
+	TFuture<void> PathSearchIndexTask;
+	/** Redirector packages missing from the current registry source, valid if bRedirectorPackagesValid is set */
+	TSet<FName> RedirectorPackages;
+	/** Resolved redirector targets, keyed by package name, dependency type and direction */
+	TMap<TTuple<FName, uint32>, TArray<FAssetIdentifier>> RedirectorTargets;
+	bool bRedirectorPackagesValid;
 	FString GameContentPath;
 };